@@ -3,6 +3,7 @@
 #define _SHARPEN_ARENA_HPP
 
 #include <cstdlib>
+#include <cstddef>
 #include <atomic>
 #include <memory>
 #include <cassert>
@@ -17,12 +18,33 @@
 
 namespace sharpen
 {
+    enum class ArenaMode
+    {
+        //any thread may allocate
+        //blocks are claimed by cas
+        Shared,
+        //only one thread allocates
+        //no atomic read-modify-write and no lock
+        Exclusive
+    };
+
+    //position of an arena returned by Arena::Save
+    struct ArenaSavepoint
+    {
+        void *block_;
+        char *curr_;
+        void *largeBlocks_;
+    };
+
+    //bump allocator
+    //objects are never freed one by one
+    //Reset and Rewind release memory in bulk and keep small blocks for reuse
     class Arena:public sharpen::Noncopyable,public sharpen::Nonmovable
     {
     private:
         
-        //max alloc
-        static constexpr sharpen::Size maxAlloc_ = 16*1024;
+        //default block size
+        static constexpr sharpen::Size defaultBlockSize_ = 16*1024;
 
         struct SmallBlock
         {
@@ -36,39 +58,96 @@ namespace sharpen
             LargeBlock* next_;
         };
         
-        
-        SmallBlock * volatile smallBlocks_;
+        //blocks in allocation order
+        SmallBlock *smallBlocks_;
+        std::atomic<SmallBlock*> current_;
         std::atomic<LargeBlock*> largeBlocks_;
         sharpen::SpinLock lock_;
+        sharpen::Size blockSize_;
+        //larger allocations get their own block
+        sharpen::Size maxSmallSize_;
+        sharpen::ArenaMode mode_;
 
         static SmallBlock *AllocSmallBlock(sharpen::Size size) noexcept;
 
-        void *AllocSmall(sharpen::Size size) noexcept;
+        //keep the data aligned to 16 bytes
+        static constexpr sharpen::Size GetBlockHeaderSize() noexcept
+        {
+            return (sizeof(SmallBlock) + 15) & ~static_cast<sharpen::Size>(15);
+        }
+
+        static char *GetBlockData(SmallBlock *block) noexcept;
 
-        void *AllocLarge(sharpen::Size size) noexcept;
+        //move to the block after full
+        bool NextBlock(SmallBlock *full) noexcept;
+
+        void *AllocSmall(sharpen::Size size,sharpen::Size alignment) noexcept;
+
+        void *AllocLarge(sharpen::Size size,sharpen::Size alignment) noexcept;
+
+        void FreeLargeBlocks(LargeBlock *until) noexcept;
     public:
         Arena()
-            :Arena(maxAlloc_)
+            :Arena(defaultBlockSize_)
         {}
 
-        explicit Arena(sharpen::Size blockSize);
+        explicit Arena(sharpen::Size blockSize)
+            :Arena(blockSize,sharpen::ArenaMode::Shared)
+        {}
+
+        Arena(sharpen::Size blockSize,sharpen::ArenaMode mode)
+            :Arena(blockSize,mode,blockSize)
+        {}
+
+        //allocations larger than maxSmallSize are served by malloc
+        //maxSmallSize must not be greater than blockSize
+        Arena(sharpen::Size blockSize,sharpen::ArenaMode mode,sharpen::Size maxSmallSize);
 
         ~Arena() noexcept;
 
         inline void *Alloc(sharpen::Size size) noexcept
+        {
+            return this->Alloc(size,alignof(std::max_align_t));
+        }
+
+        //alignment must be a power of 2
+        inline void *Alloc(sharpen::Size size,sharpen::Size alignment) noexcept
         {
             assert(size != 0);
-            if (size > maxAlloc_)
+            assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+            //the padding of a fresh block is alignment - 16 at most
+            if (size > this->maxSmallSize_ || size + alignment > this->blockSize_ + 16)
             {
-                return this->AllocLarge(size);
+                return this->AllocLarge(size,alignment);
             }
-            return this->AllocSmall(size);
+            return this->AllocSmall(size,alignment);
+        }
+
+        //free every object
+        //small blocks are kept for reuse
+        //no thread may allocate concurrently
+        void Reset() noexcept;
+
+        ArenaSavepoint Save() const noexcept;
+
+        //free every object allocated after point was saved
+        //no thread may allocate concurrently
+        void Rewind(const sharpen::ArenaSavepoint &point) noexcept;
+
+        sharpen::Size GetMaxSmallSize() const noexcept
+        {
+            return this->maxSmallSize_;
+        }
+
+        sharpen::ArenaMode GetMode() const noexcept
+        {
+            return this->mode_;
         }
 
         template<typename _T,typename ..._Args>
         inline auto Construct(_Args &&...args) SHARPEN_NOEXCEPT_IF(new (nullptr) _T{std::declval<_Args>()...}) -> decltype(new (nullptr) _T{std::declval<_Args>()...})
         {
-            _T *p = reinterpret_cast<_T*>(this->Alloc(sizeof(_T)));
+            _T *p = reinterpret_cast<_T*>(this->Alloc(sizeof(_T),alignof(_T)));
             if(p == nullptr)
             {
                 return nullptr;
@@ -81,7 +160,7 @@ namespace sharpen
         {
             assert(count != 0);
             assert(std::numeric_limits<sharpen::Size>::max()/sizeof(_T) >= count);
-            _T *p = reinterpret_cast<_T*>(this->Alloc(sizeof(_T) * count));
+            _T *p = reinterpret_cast<_T*>(this->Alloc(sizeof(_T) * count,alignof(_T)));
             if(p == nullptr)
             {
                 return nullptr;
@@ -184,6 +263,24 @@ namespace sharpen
             return std::shared_ptr<_T>(p,sharpen::Arena::ArrayDeletor<_T>{count});
         }
     };
+
+    //rewind the arena when the scope exits
+    class ArenaScope:public sharpen::Noncopyable,public sharpen::Nonmovable
+    {
+    private:
+        sharpen::Arena &arena_;
+        sharpen::ArenaSavepoint point_;
+    public:
+        explicit ArenaScope(sharpen::Arena &arena) noexcept
+            :arena_(arena)
+            ,point_(arena.Save())
+        {}
+
+        ~ArenaScope() noexcept
+        {
+            this->arena_.Rewind(this->point_);
+        }
+    };
 }
 
 #endif
\ No newline at end of file
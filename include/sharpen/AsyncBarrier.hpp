@@ -2,22 +2,19 @@
 #ifndef _SHARPEN_ASYNCBARRIER_HPP
 #define _SHARPEN_ASYNCBARRIER_HPP
 
-#include <list>
-
 #include "TypeDef.hpp"
-#include "AwaitableFuture.hpp"
+#include "AsyncWaiter.hpp"
 
 namespace sharpen
 {
     class AsyncBarrier:public sharpen::Noncopyable,public sharpen::Nonmovable
     {
     private:
-        using MyFuture = sharpen::AwaitableFuture<void>;
-        using MyFuturePtr = MyFuture*;
-        using List = std::list<MyFuturePtr>;
+        using Waiter = sharpen::AsyncWaiter;
+        using WaiterQueue = sharpen::AsyncWaiterQueue;
 
         sharpen::Uint64 counter_;
-        List waiters_;
+        WaiterQueue waiters_;
         sharpen::Uint64 beginCounter_;
         sharpen::SpinLock lock_;
     public:
@@ -0,0 +1,257 @@
+#pragma once
+#ifndef _SHARPEN_ASYNCBOUNDEDQUEUE_HPP
+#define _SHARPEN_ASYNCBOUNDEDQUEUE_HPP
+
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <cassert>
+
+#include "AsyncWaiter.hpp"
+#include "SpinLock.hpp"
+
+namespace sharpen
+{
+    //array-backed fifo with a fixed capacity
+    //producers wait when the queue is full
+    //consumers wait when the queue is empty
+    template<typename _T>
+    class AsyncBoundedQueue:public sharpen::Noncopyable,public sharpen::Nonmovable
+    {
+    private:
+        using Self = sharpen::AsyncBoundedQueue<_T>;
+        using Slot = typename std::aligned_storage<sizeof(_T),alignof(_T)>::type;
+        using Storage = std::unique_ptr<Slot[]>;
+        using Waiter = sharpen::AsyncWaiter;
+        using WaiterQueue = sharpen::AsyncWaiterQueue;
+
+        mutable sharpen::SpinLock lock_;
+        Storage slots_;
+        sharpen::Size capacity_;
+        sharpen::Size head_;
+        sharpen::Size size_;
+        WaiterQueue producers_;
+        WaiterQueue consumers_;
+
+        _T *GetSlot(sharpen::Size index) noexcept
+        {
+            return reinterpret_cast<_T*>(this->slots_.get() + index % this->capacity_);
+        }
+
+        bool Full() const noexcept
+        {
+            return this->size_ == this->capacity_;
+        }
+
+        //must hold lock_
+        template<typename _Iterator>
+        sharpen::Size PushWithoutLock(_Iterator &begin,_Iterator end)
+        {
+            sharpen::Size count{0};
+            while (begin != end && !this->Full())
+            {
+                new (this->GetSlot(this->head_ + this->size_)) _T(std::move(*begin));
+                this->size_ += 1;
+                ++count;
+                ++begin;
+            }
+            return count;
+        }
+
+        //must hold lock_
+        template<typename _OutputIterator>
+        sharpen::Size PopWithoutLock(_OutputIterator &out,sharpen::Size max)
+        {
+            sharpen::Size count{0};
+            while (count != max && this->size_ != 0)
+            {
+                _T *obj = this->GetSlot(this->head_);
+                *out = std::move(*obj);
+                ++out;
+                obj->~_T();
+                this->head_ = (this->head_ + 1) % this->capacity_;
+                this->size_ -= 1;
+                ++count;
+            }
+            return count;
+        }
+    public:
+        explicit AsyncBoundedQueue(sharpen::Size capacity)
+            :lock_()
+            ,slots_(new Slot[capacity])
+            ,capacity_(capacity)
+            ,head_(0)
+            ,size_(0)
+            ,producers_()
+            ,consumers_()
+        {
+            assert(capacity != 0);
+        }
+
+        ~AsyncBoundedQueue() noexcept
+        {
+            assert(this->producers_.Empty() && this->consumers_.Empty());
+            while (this->size_ != 0)
+            {
+                this->GetSlot(this->head_)->~_T();
+                this->head_ = (this->head_ + 1) % this->capacity_;
+                this->size_ -= 1;
+            }
+        }
+
+        //push without waiting
+        //return false if the queue is full
+        bool TryPush(_T &&obj)
+        {
+            _T *begin = std::addressof(obj);
+            return this->PushMany(begin,begin + 1) == 1;
+        }
+
+        //push as many objects as possible without waiting
+        //return the number of objects moved into the queue
+        template<typename _Iterator>
+        sharpen::Size PushMany(_Iterator begin,_Iterator end)
+        {
+            Waiter *chain;
+            sharpen::Size count;
+            {
+                std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+                count = this->PushWithoutLock(begin,end);
+                chain = this->consumers_.Pop(count);
+            }
+            WaiterQueue::CompleteChain(chain);
+            return count;
+        }
+
+        //push all objects
+        //wait while the queue is full
+        template<typename _Iterator>
+        void PushManyAsync(_Iterator begin,_Iterator end)
+        {
+            Waiter waiter;
+            while (begin != end)
+            {
+                Waiter *chain;
+                bool wait;
+                {
+                    std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+                    sharpen::Size count = this->PushWithoutLock(begin,end);
+                    chain = this->consumers_.Pop(count);
+                    wait = begin != end;
+                    if (wait)
+                    {
+                        waiter.future_.Reset();
+                        this->producers_.Push(&waiter);
+                    }
+                }
+                WaiterQueue::CompleteChain(chain);
+                if (wait)
+                {
+                    waiter.future_.Await();
+                }
+            }
+        }
+
+        void PushAsync(_T obj)
+        {
+            _T *begin = std::addressof(obj);
+            this->PushManyAsync(begin,begin + 1);
+        }
+
+        //pop without waiting
+        //return false if the queue is empty
+        bool TryPop(_T &obj)
+        {
+            _T *out = std::addressof(obj);
+            return this->PopMany(out,1) == 1;
+        }
+
+        //pop at most max objects without waiting
+        //return the number of objects written to out
+        template<typename _OutputIterator>
+        sharpen::Size PopMany(_OutputIterator out,sharpen::Size max)
+        {
+            Waiter *chain;
+            sharpen::Size count;
+            {
+                std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+                count = this->PopWithoutLock(out,max);
+                chain = this->producers_.Pop(count);
+            }
+            WaiterQueue::CompleteChain(chain);
+            return count;
+        }
+
+        //wait until the queue is not empty
+        //then pop at most max objects
+        //return the number of objects written to out
+        template<typename _OutputIterator>
+        sharpen::Size PopManyAsync(_OutputIterator out,sharpen::Size max)
+        {
+            assert(max != 0);
+            Waiter waiter;
+            while (true)
+            {
+                Waiter *chain;
+                sharpen::Size count;
+                {
+                    std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+                    count = this->PopWithoutLock(out,max);
+                    chain = this->producers_.Pop(count);
+                    if (count == 0)
+                    {
+                        waiter.future_.Reset();
+                        this->consumers_.Push(&waiter);
+                    }
+                }
+                if (count != 0)
+                {
+                    WaiterQueue::CompleteChain(chain);
+                    return count;
+                }
+                waiter.future_.Await();
+            }
+        }
+
+        _T PopAsync()
+        {
+            Waiter waiter;
+            while (true)
+            {
+                Waiter *chain;
+                {
+                    std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+                    if (this->size_ != 0)
+                    {
+                        _T *slot = this->GetSlot(this->head_);
+                        _T obj(std::move(*slot));
+                        slot->~_T();
+                        this->head_ = (this->head_ + 1) % this->capacity_;
+                        this->size_ -= 1;
+                        chain = this->producers_.Pop();
+                        lock.unlock();
+                        WaiterQueue::CompleteChain(chain);
+                        return obj;
+                    }
+                    waiter.future_.Reset();
+                    this->consumers_.Push(&waiter);
+                }
+                waiter.future_.Await();
+            }
+        }
+
+        sharpen::Size GetSize() const noexcept
+        {
+            std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+            return this->size_;
+        }
+
+        sharpen::Size GetCapacity() const noexcept
+        {
+            return this->capacity_;
+        }
+    };
+}
+
+#endif
@@ -2,9 +2,9 @@
 #ifndef _SHARPEN_ASYNCMUTEX_HPP
 #define _SHARPEN_ASYNCMUTEX_HPP
 
-#include <list>
+#include <atomic>
 
-#include "AwaitableFuture.hpp"
+#include "AsyncWaiter.hpp"
 #include "IAsyncLockable.hpp"
 
 namespace sharpen
@@ -13,18 +13,20 @@ namespace sharpen
     {
         
     private:
-        using MyFuture = sharpen::AwaitableFuture<void>;
-        using MyFuturePtr = MyFuture*;
-        using List = std::list<MyFuturePtr>;
+        using Waiter = sharpen::AsyncWaiter;
+        using WaiterQueue = sharpen::AsyncWaiterQueue;
 
-        bool locked_;
-        List waiters_;
+        std::atomic_bool locked_;
+        WaiterQueue waiters_;
         sharpen::SpinLock lock_;
     public:
         AsyncMutex();
 
         virtual void LockAsync() override;
 
+        bool TryLock() noexcept;
+
+        //ownership is handed off to the first waiter
         virtual void Unlock() noexcept override;
 
         ~AsyncMutex() noexcept = default;
@@ -1,12 +1,15 @@
 #pragma once
 #ifndef _SHARPEN_ASYNCOPS_HPP
 
+#include <algorithm>
 #include <type_traits>
+#include <vector>
 #include <thread>
 #include <cassert>
 
 #include "AwaitableFuture.hpp"
 #include "AsyncHelper.hpp"
+#include "ComputePool.hpp"
 #include "ITimer.hpp"
 #include "IteratorOps.hpp"
 #include "TypeTraits.hpp"
@@ -58,7 +61,27 @@ namespace sharpen
         timer->Await(time);
     }
 
-    void ParallelFor(sharpen::Size begin,sharpen::Size end,sharpen::Size grainsSize,std::function<void(sharpen::Size)> fn);
+    //run fn over sub-ranges of [begin,end)
+    //every worker owns a part of the range and claims grainsSize items at a time
+    //an idle worker steals the back half of another worker's part
+    void InternalParallelFor(const sharpen::ParallelExecutor &executor,sharpen::Size begin,sharpen::Size end,sharpen::Size grainsSize,std::function<void(sharpen::Size,sharpen::Size)> fn);
+
+    //size of the blocks which ParallelReduce and ParallelScan work on
+    sharpen::Size InternalParallelBlockSize(const sharpen::ParallelExecutor &executor,sharpen::Size count,sharpen::Size grainsSize);
+
+    //the first exception thrown by fn is rethrown
+    //after the other workers stop
+    void ParallelFor(const sharpen::ParallelExecutor &executor,sharpen::Size begin,sharpen::Size end,sharpen::Size grainsSize,std::function<void(sharpen::Size)> fn);
+
+    inline void ParallelFor(const sharpen::ParallelExecutor &executor,sharpen::Size begin,sharpen::Size end,std::function<void(sharpen::Size)> fn)
+    {
+        sharpen::ParallelFor(executor,begin,end,1000,std::move(fn));
+    }
+
+    inline void ParallelFor(sharpen::Size begin,sharpen::Size end,sharpen::Size grainsSize,std::function<void(sharpen::Size)> fn)
+    {
+        sharpen::ParallelFor(sharpen::ParallelExecutor(),begin,end,grainsSize,std::move(fn));
+    }
 
     inline void ParallelFor(sharpen::Size begin,sharpen::Size end,std::function<void(sharpen::Size)> fn)
     {
@@ -66,69 +89,131 @@ namespace sharpen
     }
 
     template<typename _Iterator,typename _HasForward = decltype(sharpen::IteratorForward(std::declval<_Iterator>(),std::declval<sharpen::Size>()))>
-    void ParallelForeach(_Iterator begin,_Iterator end,sharpen::Size grainsSize,std::function<void(_Iterator)> fn)
+    void ParallelForeach(const sharpen::ParallelExecutor &executor,_Iterator begin,_Iterator end,sharpen::Size grainsSize,std::function<void(_Iterator)> fn)
     {
         if (begin == end)
         {
             return;
         }
-        sharpen::Size parallelNumber{sharpen::EventEngine::GetEngine().LoopNumber()};
+        assert(fn);
         sharpen::Size count{sharpen::GetRangeSize(begin,end)};
-        sharpen::Size max{count};
-        std::atomic_size_t ite{0};
-        std::atomic_size_t comp{parallelNumber};
-        max /= parallelNumber;
-        if (max > grainsSize)
+        sharpen::InternalParallelFor(executor,0,count,grainsSize,[&begin,&fn](sharpen::Size first,sharpen::Size last)
+        {
+            _Iterator ite = sharpen::IteratorForward(begin,first);
+            for (; first != last; ++first,++ite)
+            {
+                fn(ite);
+            }
+        });
+    }
+
+    template<typename _Iterator,typename _HasForward = decltype(sharpen::IteratorForward(std::declval<_Iterator>(),std::declval<sharpen::Size>()))>
+    void ParallelForeach(_Iterator begin,_Iterator end,sharpen::Size grainsSize,std::function<void(_Iterator)> fn)
+    {
+        sharpen::ParallelForeach(sharpen::ParallelExecutor(),std::move(begin),std::move(end),grainsSize,std::move(fn));
+    }
+
+    template<typename _Iterator>
+    auto inline ParallelForeach(_Iterator begin,_Iterator end,std::function<void(_Iterator)> fn) -> decltype(sharpen::ParallelForeach(begin,end,1000,fn))
+    {
+        return sharpen::ParallelForeach(std::move(begin),std::move(end),1000,std::move(fn));
+    }
+
+    //reduce(...reduce(reduce(identity,map(begin)),map(begin + 1))...,map(end - 1))
+    //reduce must be associative and identity must be its identity element
+    //partial results are combined in order
+    template<typename _T,typename _Map,typename _Reduce>
+    inline _T ParallelReduce(const sharpen::ParallelExecutor &executor,sharpen::Size begin,sharpen::Size end,sharpen::Size grainsSize,_T identity,_Map map,_Reduce reduce)
+    {
+        if (begin >= end)
+        {
+            return identity;
+        }
+        sharpen::Size blockSize{sharpen::InternalParallelBlockSize(executor,end - begin,grainsSize)};
+        sharpen::Size blocks{(end - begin + blockSize - 1)/blockSize};
+        std::vector<_T> partials(blocks,identity);
+        sharpen::InternalParallelFor(executor,0,blocks,1,[&](sharpen::Size first,sharpen::Size last)
         {
-            max = grainsSize;
+            for (; first != last; ++first)
+            {
+                sharpen::Size i{begin + first*blockSize};
+                sharpen::Size bound{(std::min)(i + blockSize,end)};
+                _T &result = partials[first];
+                for (; i != bound; ++i)
+                {
+                    result = reduce(std::move(result),map(i));
+                }
+            }
+        });
+        _T result{std::move(identity)};
+        for (auto ite = partials.begin(); ite != partials.end(); ++ite)
+        {
+            result = reduce(std::move(result),std::move(*ite));
         }
-        sharpen::AwaitableFuture<void> future;
-        for (size_t i = 0; i < parallelNumber; i++)
+        return result;
+    }
+
+    template<typename _T,typename _Map,typename _Reduce>
+    inline _T ParallelReduce(sharpen::Size begin,sharpen::Size end,sharpen::Size grainsSize,_T identity,_Map map,_Reduce reduce)
+    {
+        return sharpen::ParallelReduce(sharpen::ParallelExecutor(),begin,end,grainsSize,std::move(identity),std::move(map),std::move(reduce));
+    }
+
+    //inclusive scan
+    //*(out + i) = op(...op(op(identity,*begin),*(begin + 1))...,*(begin + i))
+    //op must be associative and identity must be its identity element
+    //out may be begin
+    template<typename _InputIterator,typename _OutputIterator,typename _T,typename _Op>
+    inline void ParallelScan(const sharpen::ParallelExecutor &executor,_InputIterator begin,_InputIterator end,_OutputIterator out,sharpen::Size grainsSize,_T identity,_Op op)
+    {
+        if (begin == end)
         {
-            sharpen::Launch([parallelNumber,&ite,&end,count,max,&begin,&fn,&future,&comp]()
+            return;
+        }
+        sharpen::Size count{sharpen::GetRangeSize(begin,end)};
+        sharpen::Size blockSize{sharpen::InternalParallelBlockSize(executor,count,grainsSize)};
+        sharpen::Size blocks{(count + blockSize - 1)/blockSize};
+        //reduce every block but the last one
+        std::vector<_T> offsets(blocks,identity);
+        sharpen::InternalParallelFor(executor,0,blocks - 1,1,[&](sharpen::Size first,sharpen::Size last)
+        {
+            for (; first != last; ++first)
             {
-                while (true)
+                _InputIterator ite = sharpen::IteratorForward(begin,first*blockSize);
+                _T &result = offsets[first + 1];
+                for (sharpen::Size i = 0; i != blockSize; ++i,++ite)
                 {
-                    sharpen::Size iterator = ite.load();
-                    sharpen::Size size{0};
-                    //get size
-                    do
-                    {
-                        assert(count >= iterator);
-                        size = count - iterator;
-                        if(size > max)
-                        {
-                            size = max;
-                        }
-                    } while (!ite.compare_exchange_weak(iterator,iterator + size));
-                    auto i = sharpen::IteratorForward(begin,iterator);
-                    auto bound = sharpen::IteratorForward(i,size);
-                    if (i == bound)
-                    {
-                        sharpen::Size copy = comp.fetch_sub(1);
-                        copy -= 1;
-                        if (copy == 0)
-                        {
-                            future.Complete();
-                        }
-                        return;
-                    }
-                    while (i != bound)
-                    {
-                        assert(fn);
-                        fn(i);
-                        ++i;
-                    }
+                    result = op(std::move(result),*ite);
                 }
-            });
+            }
+        });
+        //offset of a block is the reduction of the blocks before it
+        for (sharpen::Size i = 1; i < blocks; ++i)
+        {
+            offsets[i] = op(offsets[i - 1],std::move(offsets[i]));
         }
-        future.Await();
+        sharpen::InternalParallelFor(executor,0,blocks,1,[&](sharpen::Size first,sharpen::Size last)
+        {
+            for (; first != last; ++first)
+            {
+                sharpen::Size i{first*blockSize};
+                sharpen::Size bound{(std::min)(i + blockSize,count)};
+                _InputIterator ite = sharpen::IteratorForward(begin,i);
+                _OutputIterator dst = sharpen::IteratorForward(out,i);
+                _T result{std::move(offsets[first])};
+                for (; i != bound; ++i,++ite,++dst)
+                {
+                    result = op(std::move(result),*ite);
+                    *dst = result;
+                }
+            }
+        });
     }
 
-    template<typename _Iterator>
-    auto inline ParallelForeach(_Iterator begin,_Iterator end,std::function<void(_Iterator)> fn) -> decltype(sharpen::ParallelForeach(begin,end,1000,fn))
+    template<typename _InputIterator,typename _OutputIterator,typename _T,typename _Op>
+    inline void ParallelScan(_InputIterator begin,_InputIterator end,_OutputIterator out,sharpen::Size grainsSize,_T identity,_Op op)
     {
-        return sharpen::ParallelForeach(std::move(begin),std::move(end),1000,std::move(fn));
+        sharpen::ParallelScan(sharpen::ParallelExecutor(),std::move(begin),std::move(end),std::move(out),grainsSize,std::move(identity),std::move(op));
     }
 }
 
@@ -2,9 +2,7 @@
 #ifndef _SHARPEN_ASYNCREADWRITELOCK_HPP
 #define _SHARPEN_ASYNCREADWRITELOCK_HPP
 
-#include <list>
-
-#include "AwaitableFuture.hpp"
+#include "AsyncWaiter.hpp"
 
 namespace sharpen
 {
@@ -18,13 +16,12 @@ namespace sharpen
     class AsyncReadWriteLock:public sharpen::Noncopyable,public sharpen::Nonmovable
     {
     private:
-        using MyFuture = sharpen::AwaitableFuture<void>;
-        using MyFuturePtr = MyFuture*;
-        using List = std::list<MyFuturePtr>;
+        using Waiter = sharpen::AsyncWaiter;
+        using WaiterQueue = sharpen::AsyncWaiterQueue;
 
         sharpen::ReadWriteLockState state_;
-        List readWaiters_;
-        List writeWaiters_;
+        WaiterQueue readWaiters_;
+        WaiterQueue writeWaiters_;
         sharpen::SpinLock lock_;
         sharpen::Uint32 readers_;
 
@@ -2,9 +2,9 @@
 #ifndef _SHARPEN_ASYNCSEMAPHORE_HPP
 #define _SHARPEN_ASYNCSEMAPHORE_HPP
 
-#include <list>
+#include <atomic>
 
-#include "AwaitableFuture.hpp"
+#include "AsyncWaiter.hpp"
 #include "TypeDef.hpp"
 #include "IAsyncLockable.hpp"
 
@@ -14,13 +14,12 @@ namespace sharpen
     class AsyncSemaphore:public sharpen::Noncopyable,public sharpen::Nonmovable,public sharpen::IAsyncLockable
     {
     private:
-        using MyFuture = sharpen::AwaitableFuture<void>;
-        using MyFuturePtr = MyFuture*;
-        using List = std::list<MyFuturePtr>;
+        using Waiter = sharpen::AsyncWaiter;
+        using WaiterQueue = sharpen::AsyncWaiterQueue;
 
-        List waiters_;
+        WaiterQueue waiters_;
         sharpen::SpinLock lock_;
-        sharpen::Uint32 counter_;
+        std::atomic<sharpen::Uint32> counter_;
 
         bool NeedWait() const;
     public:
@@ -28,6 +27,9 @@ namespace sharpen
 
         virtual void LockAsync() override;
 
+        bool TryLock() noexcept;
+
+        //counts are handed off to waiters first
         virtual void Unlock() noexcept override;
         
         void Unlock(sharpen::Uint32 count) noexcept;
@@ -0,0 +1,124 @@
+#pragma once
+#ifndef _SHARPEN_ASYNCWAITER_HPP
+#define _SHARPEN_ASYNCWAITER_HPP
+
+#include "AwaitableFuture.hpp"
+#include "TypeDef.hpp"
+
+//times to check an async lock before parking the fiber
+#ifndef SHARPEN_ASYNC_SPIN_COUNT
+#define SHARPEN_ASYNC_SPIN_COUNT 64
+#endif
+
+namespace sharpen
+{
+    //a waiter lives on the stack of the waiting fiber
+    //so queuing it never allocates
+    struct AsyncWaiter:public sharpen::Noncopyable,public sharpen::Nonmovable
+    {
+        sharpen::AwaitableFuture<void> future_;
+        AsyncWaiter *next_;
+
+        AsyncWaiter()
+            :future_()
+            ,next_(nullptr)
+        {}
+
+        ~AsyncWaiter() noexcept = default;
+    };
+
+    //intrusive fifo of waiters
+    //it is not thread safe and should be guarded by owner's lock
+    class AsyncWaiterQueue:public sharpen::Noncopyable,public sharpen::Nonmovable
+    {
+    private:
+        sharpen::AsyncWaiter *head_;
+        sharpen::AsyncWaiter *tail_;
+        sharpen::Size size_;
+    public:
+        AsyncWaiterQueue() noexcept
+            :head_(nullptr)
+            ,tail_(nullptr)
+            ,size_(0)
+        {}
+
+        ~AsyncWaiterQueue() noexcept = default;
+
+        void Push(sharpen::AsyncWaiter *waiter) noexcept
+        {
+            waiter->next_ = nullptr;
+            if (this->tail_)
+            {
+                this->tail_->next_ = waiter;
+            }
+            else
+            {
+                this->head_ = waiter;
+            }
+            this->tail_ = waiter;
+            this->size_ += 1;
+        }
+
+        sharpen::AsyncWaiter *Pop() noexcept
+        {
+            return this->Pop(1);
+        }
+
+        //pop at most count waiters
+        //and return them as a chain
+        sharpen::AsyncWaiter *Pop(sharpen::Size count) noexcept
+        {
+            if (!this->head_ || count == 0)
+            {
+                return nullptr;
+            }
+            if (count >= this->size_)
+            {
+                return this->PopAll();
+            }
+            sharpen::AsyncWaiter *chain = this->head_;
+            sharpen::AsyncWaiter *last = chain;
+            for (sharpen::Size i = 1; i < count; ++i)
+            {
+                last = last->next_;
+            }
+            this->head_ = last->next_;
+            last->next_ = nullptr;
+            this->size_ -= count;
+            return chain;
+        }
+
+        sharpen::AsyncWaiter *PopAll() noexcept
+        {
+            sharpen::AsyncWaiter *chain = this->head_;
+            this->head_ = nullptr;
+            this->tail_ = nullptr;
+            this->size_ = 0;
+            return chain;
+        }
+
+        bool Empty() const noexcept
+        {
+            return this->head_ == nullptr;
+        }
+
+        sharpen::Size GetSize() const noexcept
+        {
+            return this->size_;
+        }
+
+        //resume every waiter of a chain
+        //a waiter may be released as soon as it is completed
+        static void CompleteChain(sharpen::AsyncWaiter *chain) noexcept
+        {
+            while (chain)
+            {
+                sharpen::AsyncWaiter *next = chain->next_;
+                chain->future_.Complete();
+                chain = next;
+            }
+        }
+    };
+}
+
+#endif
@@ -4,8 +4,11 @@
 
 #include <type_traits>
 #include <tuple>
+#include <atomic>
+#include <cassert>
 
 #include "AwaitableFuture.hpp"
+#include "IteratorOps.hpp"
 
 namespace sharpen
 {
@@ -131,6 +134,231 @@ namespace sharpen
         sharpen::AwaitAnyHelper<sharpen::Future<_T>...>::SetCallback(flag,future,futures...);
         future.Await();
     }
+
+    //shared by every callback of one WhenAll/WhenAny/WhenN call
+    //allocated once per call and released by the last reference
+    //every callback owns a reference through InternalWhenRef
+    //so replacing or destroying a callback which never fired releases it
+    class InternalWhenState:public sharpen::Noncopyable,public sharpen::Nonmovable
+    {
+    private:
+        std::atomic_size_t refs_;
+        std::atomic_size_t completed_;
+        std::atomic_size_t failed_;
+        sharpen::Size count_;
+        sharpen::Size need_;
+        bool countErrors_;
+        sharpen::AwaitableFuture<sharpen::Size> future_;
+
+        InternalWhenState(sharpen::Size count,sharpen::Size need,bool countErrors)
+            :refs_(1)
+            ,completed_(0)
+            ,failed_(0)
+            ,count_(count)
+            ,need_(need)
+            ,countErrors_(countErrors)
+            ,future_()
+        {}
+
+        ~InternalWhenState() noexcept = default;
+    public:
+        //count - number of futures
+        //need - number of futures we are waiting for
+        //countErrors - errors count as completion if true
+        static InternalWhenState *Make(sharpen::Size count,sharpen::Size need,bool countErrors)
+        {
+            assert(need != 0 && need <= count);
+            return new InternalWhenState(count,need,countErrors);
+        }
+
+        void Acquire() noexcept
+        {
+            this->refs_.fetch_add(1);
+        }
+
+        void Release() noexcept
+        {
+            if(this->refs_.fetch_sub(1) == 1)
+            {
+                delete this;
+            }
+        }
+
+        void Notify(bool completed,sharpen::Size index)
+        {
+            if (completed || this->countErrors_)
+            {
+                if(this->completed_.fetch_add(1) + 1 == this->need_)
+                {
+                    this->future_.Complete(index);
+                }
+            }
+            else if(this->failed_.fetch_add(1) + 1 == this->count_ - this->need_ + 1)
+            {
+                //quorum is unreachable
+                this->future_.Complete(this->count_);
+            }
+        }
+
+        //return the index of the future which satisfied the condition
+        //or count if the condition could not be satisfied
+        sharpen::Size Await()
+        {
+            return this->future_.Await();
+        }
+    };
+
+    template<typename _T>
+    inline sharpen::Future<_T> &InternalGetFuture(sharpen::Future<_T> &future) noexcept
+    {
+        return future;
+    }
+
+    template<typename _Ptr>
+    inline auto InternalGetFuture(const _Ptr &ptr) noexcept -> decltype(sharpen::InternalGetFuture(*ptr))
+    {
+        return sharpen::InternalGetFuture(*ptr);
+    }
+
+    //a reference to InternalWhenState held by a callback
+    class InternalWhenRef
+    {
+    private:
+        using Self = sharpen::InternalWhenRef;
+
+        sharpen::InternalWhenState *state_;
+    public:
+        explicit InternalWhenRef(sharpen::InternalWhenState *state) noexcept
+            :state_(state)
+        {
+            this->state_->Acquire();
+        }
+
+        InternalWhenRef(const Self &other) noexcept
+            :state_(other.state_)
+        {
+            if (this->state_)
+            {
+                this->state_->Acquire();
+            }
+        }
+
+        InternalWhenRef(Self &&other) noexcept
+            :state_(other.state_)
+        {
+            other.state_ = nullptr;
+        }
+
+        Self &operator=(const Self &other) = delete;
+
+        Self &operator=(Self &&other) = delete;
+
+        ~InternalWhenRef() noexcept
+        {
+            if (this->state_)
+            {
+                this->state_->Release();
+            }
+        }
+
+        sharpen::InternalWhenState *operator->() const noexcept
+        {
+            return this->state_;
+        }
+    };
+
+    template<typename _T>
+    inline void InternalWhenSetCallback(sharpen::Future<_T> &future,sharpen::InternalWhenState *state,sharpen::Size index)
+    {
+        sharpen::InternalWhenRef ref{state};
+        future.SetCallback([ref,index](sharpen::Future<_T> &f)
+        {
+            ref->Notify(f.IsCompleted(),index);
+        });
+    }
+
+    template<typename _Iterator>
+    inline sharpen::Size InternalWhen(_Iterator begin,_Iterator end,sharpen::Size count,sharpen::Size need,bool countErrors)
+    {
+        sharpen::InternalWhenState *state = sharpen::InternalWhenState::Make(count,need,countErrors);
+        sharpen::Size r;
+        try
+        {
+            sharpen::Size index{0};
+            for (; begin != end; ++begin,++index)
+            {
+                sharpen::InternalWhenSetCallback(sharpen::InternalGetFuture(*begin),state,index);
+            }
+            r = state->Await();
+        }
+        catch(const std::exception&)
+        {
+            state->Release();
+            throw;
+        }
+        state->Release();
+        return r;
+    }
+
+    //the futures' callbacks will be replaced
+    //elements could be futures or pointers to futures
+
+    //wait until all futures completed or failed
+    template<typename _Iterator,typename _Check = decltype(sharpen::InternalGetFuture(*std::declval<_Iterator>()))>
+    inline void WhenAll(_Iterator begin,_Iterator end)
+    {
+        sharpen::Size count{sharpen::GetRangeSize(begin,end)};
+        if (count == 0)
+        {
+            return;
+        }
+        sharpen::InternalWhen(begin,end,count,count,true);
+    }
+
+    //wait until any future completed or failed
+    //return the index of the first one
+    template<typename _Iterator,typename _Check = decltype(sharpen::InternalGetFuture(*std::declval<_Iterator>()))>
+    inline sharpen::Size WhenAny(_Iterator begin,_Iterator end)
+    {
+        sharpen::Size count{sharpen::GetRangeSize(begin,end)};
+        assert(count != 0);
+        return sharpen::InternalWhen(begin,end,count,1,true);
+    }
+
+    //wait until n futures completed
+    //return false if too many futures failed to reach n
+    template<typename _Iterator,typename _Check = decltype(sharpen::InternalGetFuture(*std::declval<_Iterator>()))>
+    inline bool WhenN(_Iterator begin,_Iterator end,sharpen::Size n)
+    {
+        sharpen::Size count{sharpen::GetRangeSize(begin,end)};
+        if (n == 0)
+        {
+            return true;
+        }
+        if (n > count)
+        {
+            return false;
+        }
+        return sharpen::InternalWhen(begin,end,count,n,false) != count;
+    }
+
+    template<typename _Container>
+    inline auto WhenAll(_Container &futures) -> decltype(sharpen::WhenAll(std::begin(futures),std::end(futures)))
+    {
+        return sharpen::WhenAll(std::begin(futures),std::end(futures));
+    }
+
+    template<typename _Container>
+    inline auto WhenAny(_Container &futures) -> decltype(sharpen::WhenAny(std::begin(futures),std::end(futures)))
+    {
+        return sharpen::WhenAny(std::begin(futures),std::end(futures));
+    }
+
+    template<typename _Container>
+    inline auto WhenN(_Container &futures,sharpen::Size n) -> decltype(sharpen::WhenN(std::begin(futures),std::end(futures),n))
+    {
+        return sharpen::WhenN(std::begin(futures),std::end(futures),n);
+    }
 }
 
 #endif
\ No newline at end of file
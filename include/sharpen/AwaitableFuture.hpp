@@ -126,7 +126,7 @@ namespace sharpen
     template <typename _T>
     inline sharpen::AwaitableFuturePtr<_T> MakeAwaitableFuture()
     {
-        return std::make_shared<sharpen::AwaitableFuture<_T>>();
+        return sharpen::ObjectPool<sharpen::AwaitableFuture<_T>>::MakeShared();
     }
 }
 
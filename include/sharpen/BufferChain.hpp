@@ -0,0 +1,109 @@
+#pragma once
+#ifndef _SHARPEN_BUFFERCHAIN_HPP
+#define _SHARPEN_BUFFERCHAIN_HPP
+
+#include <deque>
+
+#include "BufferSlice.hpp"
+#include "TypeDef.hpp"
+
+namespace sharpen
+{
+    class ByteBuffer;
+
+    //rope of buffer slices
+    //segments are shared and never copied by append, prepend, split or consume
+    class BufferChain
+    {
+    private:
+        using Self = sharpen::BufferChain;
+        using Segments = std::deque<sharpen::BufferSlice>;
+
+        Segments segments_;
+        sharpen::Size size_;
+    public:
+        using ConstIterator = typename Segments::const_iterator;
+
+        BufferChain();
+
+        BufferChain(const Self &other) = default;
+
+        BufferChain(Self &&other);
+
+        Self &operator=(const Self &other) = default;
+
+        Self &operator=(Self &&other) noexcept;
+
+        ~BufferChain() noexcept = default;
+
+        void Swap(Self &other) noexcept;
+
+        inline void swap(Self &other) noexcept
+        {
+            this->Swap(other);
+        }
+
+        //empty slices are ignored
+        void Append(sharpen::BufferSlice slice);
+
+        //copy the bytes into a new segment
+        void Append(const sharpen::Char *data,sharpen::Size size);
+
+        void Append(const sharpen::ByteBuffer &buf);
+
+        void Append(Self other);
+
+        void Prepend(sharpen::BufferSlice slice);
+
+        void Prepend(const sharpen::Char *data,sharpen::Size size);
+
+        inline sharpen::Size GetSize() const noexcept
+        {
+            return this->size_;
+        }
+
+        inline bool Empty() const noexcept
+        {
+            return this->size_ == 0;
+        }
+
+        inline sharpen::Size GetSegmentCount() const noexcept
+        {
+            return this->segments_.size();
+        }
+
+        const sharpen::BufferSlice &GetSegment(sharpen::Size index) const;
+
+        //throw std::out_of_range if index is out of the chain
+        sharpen::Char Get(sharpen::Size index) const;
+
+        //drop the first size bytes
+        //throw std::out_of_range if size is greater than the chain
+        void Consume(sharpen::Size size);
+
+        //remove the first size bytes and return them
+        //a segment on the boundary is sliced
+        //throw std::out_of_range if size is greater than the chain
+        Self Split(sharpen::Size size);
+
+        //copy at most size bytes from the front
+        //return the number of bytes copied
+        sharpen::Size CopyTo(sharpen::Char *buf,sharpen::Size size) const;
+
+        sharpen::ByteBuffer Flatten() const;
+
+        void Clear() noexcept;
+
+        inline ConstIterator Begin() const noexcept
+        {
+            return this->segments_.cbegin();
+        }
+
+        inline ConstIterator End() const noexcept
+        {
+            return this->segments_.cend();
+        }
+    };
+}
+
+#endif
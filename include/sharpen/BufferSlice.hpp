@@ -0,0 +1,139 @@
+#pragma once
+#ifndef _SHARPEN_BUFFERSLICE_HPP
+#define _SHARPEN_BUFFERSLICE_HPP
+
+#include <atomic>
+#include <utility>
+
+#include "TypeDef.hpp"
+
+namespace sharpen
+{
+    class ByteBuffer;
+
+    //view of a reference counted block
+    //copies and slices share the block
+    //blocks come from SizeClassAllocator
+    //so a released block goes to the free list of the thread (the event loop) releasing it
+    class BufferSlice
+    {
+    private:
+        using Self = sharpen::BufferSlice;
+
+        struct Block
+        {
+            std::atomic<sharpen::Size> ref_;
+            sharpen::Size capacity_;
+        };
+
+        Block *block_;
+        sharpen::Size offset_;
+        sharpen::Size size_;
+
+        static Block *AllocBlock(sharpen::Size size);
+
+        static sharpen::Char *GetBlockData(Block *block) noexcept;
+
+        void Release() noexcept;
+    public:
+        using Iterator = sharpen::Char*;
+
+        using ConstIterator = const sharpen::Char*;
+
+        BufferSlice() noexcept;
+
+        //the bytes are not initialized
+        explicit BufferSlice(sharpen::Size size);
+
+        BufferSlice(const sharpen::Char *p,sharpen::Size size);
+
+        explicit BufferSlice(const sharpen::ByteBuffer &buf);
+
+        BufferSlice(const Self &other) noexcept;
+
+        BufferSlice(Self &&other) noexcept;
+
+        Self &operator=(const Self &other) noexcept;
+
+        Self &operator=(Self &&other) noexcept;
+
+        ~BufferSlice() noexcept;
+
+        void Swap(Self &other) noexcept;
+
+        inline void swap(Self &other) noexcept
+        {
+            this->Swap(other);
+        }
+
+        inline sharpen::Size GetSize() const noexcept
+        {
+            return this->size_;
+        }
+
+        inline bool Empty() const noexcept
+        {
+            return this->size_ == 0;
+        }
+
+        const sharpen::Char *Data() const noexcept;
+
+        //writes are seen by every slice sharing the block
+        sharpen::Char *Data() noexcept;
+
+        sharpen::Char Get(sharpen::Size index) const;
+
+        sharpen::Char &Get(sharpen::Size index);
+
+        inline sharpen::Char operator[](sharpen::Size index) const
+        {
+            return this->Data()[index];
+        }
+
+        inline sharpen::Char &operator[](sharpen::Size index)
+        {
+            return this->Data()[index];
+        }
+
+        //share [offset,offset + size) of this slice
+        //throw std::out_of_range if the range is out of this slice
+        Self Slice(sharpen::Size offset,sharpen::Size size) const;
+
+        inline Self Slice(sharpen::Size offset) const
+        {
+            return this->Slice(offset,this->size_ - (offset < this->size_ ? offset:this->size_));
+        }
+
+        //return true if no other slice shares the block
+        bool IsUnique() const noexcept;
+
+        sharpen::Size GetRefCount() const noexcept;
+
+        //copy the bytes
+        sharpen::ByteBuffer ToByteBuffer() const;
+
+        void Clear() noexcept;
+
+        inline Iterator Begin() noexcept
+        {
+            return this->Data();
+        }
+
+        inline ConstIterator Begin() const noexcept
+        {
+            return this->Data();
+        }
+
+        inline Iterator End() noexcept
+        {
+            return this->Data() + this->size_;
+        }
+
+        inline ConstIterator End() const noexcept
+        {
+            return this->Data() + this->size_;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,117 @@
+#pragma once
+#ifndef _SHARPEN_BUFFEREDSTREAMREADER_HPP
+#define _SHARPEN_BUFFEREDSTREAMREADER_HPP
+
+#include "INetStreamChannel.hpp"
+#include "ByteBuffer.hpp"
+#include "ByteScan.hpp"
+#include "Noncopyable.hpp"
+
+//initial size of the receive window
+#ifndef SHARPEN_STREAM_READER_WINDOW_SIZE
+#define SHARPEN_STREAM_READER_WINDOW_SIZE 4096
+#endif
+
+//the window never grows beyond this size
+#ifndef SHARPEN_STREAM_READER_MAX_WINDOW_SIZE
+#define SHARPEN_STREAM_READER_MAX_WINDOW_SIZE (1024*1024)
+#endif
+
+namespace sharpen
+{
+    //buffered reads over a stream channel
+    //bytes are received into one window
+    //which is compacted only when its tail is full
+    //a delimiter or a frame longer than the max window size causes std::length_error
+    //every method must be called from a fiber
+    class BufferedStreamReader:public sharpen::Noncopyable
+    {
+    private:
+        using Self = sharpen::BufferedStreamReader;
+
+        sharpen::NetStreamChannelPtr channel_;
+        sharpen::ByteBuffer window_;
+        //buffered bytes are [begin_,end_)
+        sharpen::Size begin_;
+        sharpen::Size end_;
+        sharpen::Size maxWindowSize_;
+        bool eof_;
+
+        //make room at the tail of the window
+        void Reserve();
+
+        inline const sharpen::Char *BufferBegin() const noexcept
+        {
+            return this->window_.Data() + this->begin_;
+        }
+
+        inline const sharpen::Char *BufferEnd() const noexcept
+        {
+            return this->window_.Data() + this->end_;
+        }
+
+        //search delim from the window and read more if needed
+        //return the index of the end of the delimiter
+        //or 0 if the stream ends first
+        sharpen::Size LocateAsync(const sharpen::Char *delim,sharpen::Size delimSize);
+    public:
+        explicit BufferedStreamReader(sharpen::NetStreamChannelPtr channel);
+
+        BufferedStreamReader(sharpen::NetStreamChannelPtr channel,sharpen::Size windowSize,sharpen::Size maxWindowSize);
+
+        BufferedStreamReader(Self &&other) noexcept = default;
+
+        ~BufferedStreamReader() noexcept = default;
+
+        //receive once into the window
+        //return the number of bytes received
+        //0 means the stream ends
+        sharpen::Size FillAsync();
+
+        //append bytes up to and including delim to buf
+        //if the stream ends first the rest is appended
+        //return the number of bytes appended
+        //0 means the stream ends
+        sharpen::Size ReadUntilAsync(sharpen::ByteBuffer &buf,sharpen::Char delim);
+
+        sharpen::Size ReadUntilAsync(sharpen::ByteBuffer &buf,const sharpen::Char *delim,sharpen::Size delimSize);
+
+        //append a line without \n or \r\n to line
+        //return false if the stream ends before any byte
+        bool ReadLineAsync(sharpen::ByteBuffer &line);
+
+        //read size bytes
+        //return less than size only if the stream ends
+        sharpen::Size ReadExactAsync(sharpen::Char *buf,sharpen::Size size);
+
+        sharpen::Size ReadExactAsync(sharpen::ByteBuffer &buf,sharpen::Size size);
+
+        //read at most size bytes
+        //large reads bypass the window when it is empty
+        sharpen::Size ReadAsync(sharpen::Char *buf,sharpen::Size size);
+
+        //wait until at least size bytes are buffered or the stream ends
+        //the span is valid until the next call
+        sharpen::ByteSpan PeekAsync(sharpen::Size size);
+
+        //drop size buffered bytes
+        void Consume(sharpen::Size size);
+
+        inline sharpen::Size GetBufferedSize() const noexcept
+        {
+            return this->end_ - this->begin_;
+        }
+
+        inline bool IsEof() const noexcept
+        {
+            return this->eof_ && this->begin_ == this->end_;
+        }
+
+        inline sharpen::NetStreamChannelPtr &Channel() noexcept
+        {
+            return this->channel_;
+        }
+    };
+}
+
+#endif
@@ -4,11 +4,17 @@
 
 #include <vector>
 #include <algorithm>
+#include <iterator>
 #include <type_traits>
 
 #include "Noncopyable.hpp"
 #include "TypeDef.hpp"
 
+//payloads up to this size are stored in the buffer itself
+#ifndef SHARPEN_BYTEBUFFER_INLINE_SIZE
+#define SHARPEN_BYTEBUFFER_INLINE_SIZE 32
+#endif
+
 namespace sharpen
 {
     class ByteBuffer
@@ -18,27 +24,45 @@ namespace sharpen
         using Self = ByteBuffer;
         
     protected:
-        Vector vector_;
+        //points to inline_ or to a heap block
+        sharpen::Char *data_;
+
+        sharpen::Size size_;
+
+        sharpen::Size capacity_;
 
         sharpen::Size mark_;
 
+        sharpen::Char inline_[SHARPEN_BYTEBUFFER_INLINE_SIZE];
+
     private:
         void CheckAndMoveMark();
 
+        inline bool IsInline() const noexcept
+        {
+            return this->data_ == this->inline_;
+        }
+
+        //make capacity_ at least size
+        //grow geometrically
+        void Grow(sharpen::Size size);
+
+        void FreeHeap() noexcept;
+
     public:
-        using Iterator = typename Vector::iterator;
+        using Iterator = sharpen::Char*;
 
-        using ConstIterator = typename Vector::const_iterator;
+        using ConstIterator = const sharpen::Char*;
 
-        using ReverseIterator = typename Vector::reverse_iterator;
+        using ReverseIterator = std::reverse_iterator<Iterator>;
 
-        using ConstReverseIterator = typename Vector::const_reverse_iterator;
+        using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
 
         ByteBuffer();
 
         explicit ByteBuffer(sharpen::Size size);
 
-        explicit ByteBuffer(Vector &&vector) noexcept;
+        explicit ByteBuffer(Vector &&vector);
 
         ByteBuffer(const sharpen::Char *p,sharpen::Size size);
 
@@ -46,7 +70,7 @@ namespace sharpen
 
         ByteBuffer(Self &&other) noexcept;
 
-        virtual ~ByteBuffer() noexcept = default;
+        virtual ~ByteBuffer() noexcept;
 
         Self &operator=(const Self &other);
 
@@ -92,6 +116,14 @@ namespace sharpen
             return this->Get(index);
         }
 
+        inline sharpen::Size GetCapacity() const noexcept
+        {
+            return this->capacity_;
+        }
+
+        //make room for size bytes
+        //the capacity at least doubles when it grows
+        //so repeated calls with increasing sizes stay amortized O(1)
         void Reserve(sharpen::Size size);
 
         void Reset();
@@ -104,6 +136,12 @@ namespace sharpen
 
         void ExtendTo(sharpen::Size size,sharpen::Char defaultValue);
 
+        //new bytes are not initialized
+        //use it when they are overwritten at once
+        void ExtendUninitialized(sharpen::Size size);
+
+        void ExtendToUninitialized(sharpen::Size size);
+
         void Shrink();
 
         void Append(const sharpen::Char *p,sharpen::Size size);
@@ -115,7 +153,7 @@ namespace sharpen
         {
             while (begin != end)
             {
-                this->vector_.push_back(*begin);
+                this->PushBack(*begin);
                 ++begin;
             }
         }
@@ -136,42 +174,42 @@ namespace sharpen
 
         inline Iterator Begin()
         {
-            return this->vector_.begin();
+            return this->data_;
         }
 
         inline ConstIterator Begin() const
         {
-            return this->vector_.cbegin();
+            return this->data_;
         }
 
         inline ReverseIterator ReverseBegin()
         {
-            return this->vector_.rbegin();
+            return ReverseIterator(this->End());
         }
 
         inline ConstReverseIterator ReverseBegin() const
         {
-            return this->vector_.crbegin();
+            return ConstReverseIterator(this->End());
         }
 
         inline Iterator End()
         {
-            return this->vector_.end();
+            return this->data_ + this->size_;
         }
 
         inline ConstIterator End() const
         {
-            return this->vector_.cend();
+            return this->data_ + this->size_;
         }
 
         inline ReverseIterator ReverseEnd()
         {
-            return this->vector_.rend();
+            return ReverseIterator(this->Begin());
         }
 
         inline ConstReverseIterator ReverseEnd() const
         {
-            return this->vector_.crend();
+            return ConstReverseIterator(this->Begin());
         }
 
         ConstIterator Find(sharpen::Char e) const;
@@ -182,6 +220,15 @@ namespace sharpen
 
         ConstReverseIterator ReverseFind(sharpen::Char e) const;
 
+        //find the first byte which is one of set[0,setSize)
+        Iterator FindAnyOf(const sharpen::Char *set,sharpen::Size setSize);
+
+        ConstIterator FindAnyOf(const sharpen::Char *set,sharpen::Size setSize) const;
+
+        Iterator Search(const sharpen::Char *pattern,sharpen::Size patternSize);
+
+        ConstIterator Search(const sharpen::Char *pattern,sharpen::Size patternSize) const;
+
         template<typename _Iterator,typename _Check = decltype(std::declval<Self>().Get(0) == *std::declval<_Iterator>())>
         Iterator Search(const _Iterator begin,const _Iterator end)
         {
@@ -196,7 +243,8 @@ namespace sharpen
 
         inline void Clear()
         {
-            this->vector_.clear();
+            this->size_ = 0;
+            this->mark_ = 0;
         }
     };
 } 
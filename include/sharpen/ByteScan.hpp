@@ -0,0 +1,202 @@
+#pragma once
+#ifndef _SHARPEN_BYTESCAN_HPP
+#define _SHARPEN_BYTESCAN_HPP
+
+#include <iterator>
+
+#include "TypeDef.hpp"
+
+namespace sharpen
+{
+    //scanning primitives used by buffers and codecs
+    //they use sse2 or avx2 when the cpu has them
+    //every function returns end if nothing is found
+
+    const sharpen::Char *ScanByte(const sharpen::Char *begin,const sharpen::Char *end,sharpen::Char c) noexcept;
+
+    //return the last c in [begin,end)
+    const sharpen::Char *ReverseScanByte(const sharpen::Char *begin,const sharpen::Char *end,sharpen::Char c) noexcept;
+
+    //find the first byte which is one of set[0,setSize)
+    const sharpen::Char *ScanAnyOf(const sharpen::Char *begin,const sharpen::Char *end,const sharpen::Char *set,sharpen::Size setSize) noexcept;
+
+    //find the first occurrence of pattern
+    //an empty pattern matches begin
+    const sharpen::Char *ScanPattern(const sharpen::Char *begin,const sharpen::Char *end,const sharpen::Char *pattern,sharpen::Size patternSize) noexcept;
+
+    //the name of the implementation in use
+    //"avx2" "sse2" or "scalar"
+    const char *GetByteScanImplementation() noexcept;
+
+    //non-owning view of bytes
+    class ByteSpan
+    {
+    private:
+        const sharpen::Char *data_;
+        sharpen::Size size_;
+    public:
+        constexpr ByteSpan() noexcept
+            :data_(nullptr)
+            ,size_(0)
+        {}
+
+        constexpr ByteSpan(const sharpen::Char *data,sharpen::Size size) noexcept
+            :data_(data)
+            ,size_(size)
+        {}
+
+        inline const sharpen::Char *Data() const noexcept
+        {
+            return this->data_;
+        }
+
+        inline sharpen::Size GetSize() const noexcept
+        {
+            return this->size_;
+        }
+
+        inline bool Empty() const noexcept
+        {
+            return this->size_ == 0;
+        }
+
+        inline sharpen::Char operator[](sharpen::Size index) const noexcept
+        {
+            return this->data_[index];
+        }
+
+        inline const sharpen::Char *Begin() const noexcept
+        {
+            return this->data_;
+        }
+
+        inline const sharpen::Char *End() const noexcept
+        {
+            return this->data_ + this->size_;
+        }
+    };
+
+    //iterate the pieces between delimiters
+    //n delimiters always produce n + 1 pieces
+    class ByteSplitIterator
+    {
+    private:
+        using Self = sharpen::ByteSplitIterator;
+
+        const sharpen::Char *begin_;
+        const sharpen::Char *next_;
+        const sharpen::Char *end_;
+        sharpen::Char delimiter_;
+        bool done_;
+
+        void Locate() noexcept
+        {
+            this->next_ = sharpen::ScanByte(this->begin_,this->end_,this->delimiter_);
+        }
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = sharpen::ByteSpan;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const sharpen::ByteSpan*;
+        using reference = sharpen::ByteSpan;
+
+        //end iterator
+        ByteSplitIterator() noexcept
+            :begin_(nullptr)
+            ,next_(nullptr)
+            ,end_(nullptr)
+            ,delimiter_(0)
+            ,done_(true)
+        {}
+
+        ByteSplitIterator(const sharpen::Char *begin,const sharpen::Char *end,sharpen::Char delimiter) noexcept
+            :begin_(begin)
+            ,next_(nullptr)
+            ,end_(end)
+            ,delimiter_(delimiter)
+            ,done_(false)
+        {
+            this->Locate();
+        }
+
+        inline sharpen::ByteSpan operator*() const noexcept
+        {
+            return sharpen::ByteSpan{this->begin_,static_cast<sharpen::Size>(this->next_ - this->begin_)};
+        }
+
+        inline Self &operator++() noexcept
+        {
+            if (this->next_ == this->end_)
+            {
+                this->done_ = true;
+                return *this;
+            }
+            this->begin_ = this->next_ + 1;
+            this->Locate();
+            return *this;
+        }
+
+        inline Self operator++(int) noexcept
+        {
+            Self tmp{*this};
+            ++*this;
+            return tmp;
+        }
+
+        inline bool operator==(const Self &other) const noexcept
+        {
+            if (this->done_ || other.done_)
+            {
+                return this->done_ == other.done_;
+            }
+            return this->begin_ == other.begin_;
+        }
+
+        inline bool operator!=(const Self &other) const noexcept
+        {
+            return !(*this == other);
+        }
+    };
+
+    class ByteSplitRange
+    {
+    private:
+        const sharpen::Char *begin_;
+        const sharpen::Char *end_;
+        sharpen::Char delimiter_;
+    public:
+        ByteSplitRange(const sharpen::Char *begin,const sharpen::Char *end,sharpen::Char delimiter) noexcept
+            :begin_(begin)
+            ,end_(end)
+            ,delimiter_(delimiter)
+        {}
+
+        inline sharpen::ByteSplitIterator Begin() const noexcept
+        {
+            return sharpen::ByteSplitIterator{this->begin_,this->end_,this->delimiter_};
+        }
+
+        inline sharpen::ByteSplitIterator End() const noexcept
+        {
+            return sharpen::ByteSplitIterator{};
+        }
+
+        //use by range-for
+        inline sharpen::ByteSplitIterator begin() const noexcept
+        {
+            return this->Begin();
+        }
+
+        inline sharpen::ByteSplitIterator end() const noexcept
+        {
+            return this->End();
+        }
+    };
+
+    inline sharpen::ByteSplitRange SplitBytes(const sharpen::Char *begin,const sharpen::Char *end,sharpen::Char delimiter) noexcept
+    {
+        return sharpen::ByteSplitRange{begin,end,delimiter};
+    }
+}
+
+#endif
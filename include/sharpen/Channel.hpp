@@ -0,0 +1,591 @@
+#pragma once
+#ifndef _SHARPEN_CHANNEL_HPP
+#define _SHARPEN_CHANNEL_HPP
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <cassert>
+
+#include "AwaitableFuture.hpp"
+#include "SpinLock.hpp"
+#include "TypeDef.hpp"
+
+namespace sharpen
+{
+    //shared by every waiter of one select
+    //the first channel which claims it wins
+    class InternalChannelSelect:public sharpen::Noncopyable,public sharpen::Nonmovable
+    {
+    private:
+        std::atomic_bool claimed_;
+        sharpen::AwaitableFuture<sharpen::Size> future_;
+    public:
+        InternalChannelSelect()
+            :claimed_(false)
+            ,future_()
+        {}
+
+        ~InternalChannelSelect() noexcept = default;
+
+        bool TryClaim() noexcept
+        {
+            return !this->claimed_.exchange(true);
+        }
+
+        void Complete(sharpen::Size index)
+        {
+            this->future_.Complete(index);
+        }
+
+        sharpen::Size Await()
+        {
+            return this->future_.Await();
+        }
+    };
+
+    //a waiter lives in a channel case
+    //which lives on the stack of the waiting fiber
+    template<typename _T>
+    struct InternalChannelWaiter
+    {
+        sharpen::InternalChannelSelect *select_;
+        sharpen::Size index_;
+        //receiver - destination
+        //sender - source
+        _T *value_;
+        bool ok_;
+        bool queued_;
+        InternalChannelWaiter *prev_;
+        InternalChannelWaiter *next_;
+    };
+
+    //intrusive doubly linked fifo
+    //guarded by the channel lock
+    template<typename _T>
+    class InternalChannelWaiterList:public sharpen::Noncopyable,public sharpen::Nonmovable
+    {
+    private:
+        using Waiter = sharpen::InternalChannelWaiter<_T>;
+
+        Waiter *head_;
+        Waiter *tail_;
+    public:
+        InternalChannelWaiterList() noexcept
+            :head_(nullptr)
+            ,tail_(nullptr)
+        {}
+
+        ~InternalChannelWaiterList() noexcept = default;
+
+        void Push(Waiter *waiter) noexcept
+        {
+            waiter->prev_ = this->tail_;
+            waiter->next_ = nullptr;
+            if (this->tail_)
+            {
+                this->tail_->next_ = waiter;
+            }
+            else
+            {
+                this->head_ = waiter;
+            }
+            this->tail_ = waiter;
+            waiter->queued_ = true;
+        }
+
+        void Remove(Waiter *waiter) noexcept
+        {
+            assert(waiter->queued_);
+            if (waiter->prev_)
+            {
+                waiter->prev_->next_ = waiter->next_;
+            }
+            else
+            {
+                this->head_ = waiter->next_;
+            }
+            if (waiter->next_)
+            {
+                waiter->next_->prev_ = waiter->prev_;
+            }
+            else
+            {
+                this->tail_ = waiter->prev_;
+            }
+            waiter->prev_ = nullptr;
+            waiter->next_ = nullptr;
+            waiter->queued_ = false;
+        }
+
+        //pop the first waiter whose select could be claimed
+        //waiters of finished selects are dropped
+        Waiter *PopAndClaim() noexcept
+        {
+            while (this->head_)
+            {
+                Waiter *waiter = this->head_;
+                this->Remove(waiter);
+                if (waiter->select_->TryClaim())
+                {
+                    return waiter;
+                }
+            }
+            return nullptr;
+        }
+
+        bool Empty() const noexcept
+        {
+            return this->head_ == nullptr;
+        }
+    };
+
+    //the waiter which should be resumed
+    //after all channel locks are released
+    struct InternalChannelWakeup
+    {
+        sharpen::InternalChannelSelect *select_;
+        sharpen::Size index_;
+
+        void Notify()
+        {
+            if (this->select_)
+            {
+                this->select_->Complete(this->index_);
+            }
+        }
+    };
+
+    class IChannelCase
+    {
+    private:
+        using Self = sharpen::IChannelCase;
+    public:
+        IChannelCase() noexcept = default;
+
+        IChannelCase(const Self &) noexcept = default;
+
+        IChannelCase(Self &&) noexcept = default;
+
+        virtual ~IChannelCase() noexcept = default;
+
+        virtual sharpen::SpinLock &GetLock() noexcept = 0;
+
+        //must hold lock
+        //return true if the operation finished
+        //(completed or failed because the channel is closed)
+        virtual bool TryExecuteWithoutLock(sharpen::InternalChannelWakeup &wakeup) = 0;
+
+        //must hold lock
+        virtual void EnqueueWithoutLock(sharpen::InternalChannelSelect *select,sharpen::Size index) noexcept = 0;
+
+        //must hold lock
+        virtual void DequeueWithoutLock() noexcept = 0;
+
+        //return false if the channel was closed
+        virtual bool Ok() const noexcept = 0;
+    };
+
+    //lock every channel in address order
+    //execute the first ready case
+    //or wait for one if block is true
+    //return the index of the executed case
+    //or count if block is false and no case is ready
+    sharpen::Size InternalSelect(sharpen::IChannelCase **cases,sharpen::SpinLock **locks,sharpen::Size count,bool block);
+
+    template<typename _T>
+    class ChannelSendCase;
+
+    template<typename _T>
+    class ChannelReceiveCase;
+
+    //go-style channel between fibers
+    //capacity 0 means unbuffered
+    //a sender of an unbuffered channel waits until a receiver takes the value
+    template<typename _T>
+    class Channel:public sharpen::Noncopyable,public sharpen::Nonmovable
+    {
+    private:
+        using Self = sharpen::Channel<_T>;
+        using Slot = typename std::aligned_storage<sizeof(_T),alignof(_T)>::type;
+        using Storage = std::unique_ptr<Slot[]>;
+        using Waiter = sharpen::InternalChannelWaiter<_T>;
+        using WaiterList = sharpen::InternalChannelWaiterList<_T>;
+
+        friend class sharpen::ChannelSendCase<_T>;
+        friend class sharpen::ChannelReceiveCase<_T>;
+
+        mutable sharpen::SpinLock lock_;
+        Storage slots_;
+        sharpen::Size capacity_;
+        sharpen::Size head_;
+        sharpen::Size size_;
+        bool closed_;
+        WaiterList senders_;
+        WaiterList receivers_;
+
+        _T *GetSlot(sharpen::Size index) noexcept
+        {
+            return reinterpret_cast<_T*>(this->slots_.get() + index % this->capacity_);
+        }
+
+        void PushSlot(_T &&obj)
+        {
+            assert(this->size_ != this->capacity_);
+            new (this->GetSlot(this->head_ + this->size_)) _T(std::move(obj));
+            this->size_ += 1;
+        }
+
+        void PopSlot(_T &obj)
+        {
+            assert(this->size_ != 0);
+            _T *slot = this->GetSlot(this->head_);
+            obj = std::move(*slot);
+            slot->~_T();
+            this->head_ = (this->head_ + 1) % this->capacity_;
+            this->size_ -= 1;
+        }
+
+        //must hold lock
+        bool TrySendWithoutLock(_T &obj,bool &ok,sharpen::InternalChannelWakeup &wakeup)
+        {
+            if (this->closed_)
+            {
+                ok = false;
+                return true;
+            }
+            Waiter *receiver = this->receivers_.PopAndClaim();
+            if (receiver)
+            {
+                //hand off to receiver directly
+                *receiver->value_ = std::move(obj);
+                receiver->ok_ = true;
+                wakeup.select_ = receiver->select_;
+                wakeup.index_ = receiver->index_;
+                ok = true;
+                return true;
+            }
+            if (this->size_ != this->capacity_)
+            {
+                this->PushSlot(std::move(obj));
+                ok = true;
+                return true;
+            }
+            return false;
+        }
+
+        //must hold lock
+        bool TryReceiveWithoutLock(_T &obj,bool &ok,sharpen::InternalChannelWakeup &wakeup)
+        {
+            if (this->size_ != 0)
+            {
+                this->PopSlot(obj);
+                //refill by a waiting sender
+                Waiter *sender = this->senders_.PopAndClaim();
+                if (sender)
+                {
+                    this->PushSlot(std::move(*sender->value_));
+                    sender->ok_ = true;
+                    wakeup.select_ = sender->select_;
+                    wakeup.index_ = sender->index_;
+                }
+                ok = true;
+                return true;
+            }
+            Waiter *sender = this->senders_.PopAndClaim();
+            if (sender)
+            {
+                obj = std::move(*sender->value_);
+                sender->ok_ = true;
+                wakeup.select_ = sender->select_;
+                wakeup.index_ = sender->index_;
+                ok = true;
+                return true;
+            }
+            if (this->closed_)
+            {
+                ok = false;
+                return true;
+            }
+            return false;
+        }
+
+        //must hold lock
+        //chain claimed waiters by next_
+        static void CloseWaiters(WaiterList &list,Waiter *&chain) noexcept
+        {
+            Waiter *waiter = list.PopAndClaim();
+            while (waiter)
+            {
+                waiter->ok_ = false;
+                waiter->next_ = chain;
+                chain = waiter;
+                waiter = list.PopAndClaim();
+            }
+        }
+    public:
+        Channel()
+            :Channel(0)
+        {}
+
+        explicit Channel(sharpen::Size capacity)
+            :lock_()
+            ,slots_(capacity ? new Slot[capacity]:nullptr)
+            ,capacity_(capacity)
+            ,head_(0)
+            ,size_(0)
+            ,closed_(false)
+            ,senders_()
+            ,receivers_()
+        {}
+
+        ~Channel() noexcept
+        {
+            assert(this->senders_.Empty() && this->receivers_.Empty());
+            while (this->size_ != 0)
+            {
+                this->GetSlot(this->head_)->~_T();
+                this->head_ = (this->head_ + 1) % this->capacity_;
+                this->size_ -= 1;
+            }
+        }
+
+        //return false if the channel is closed
+        bool SendAsync(_T obj);
+
+        //return false if the channel is closed and drained
+        bool ReceiveAsync(_T &obj);
+
+        //send without waiting
+        //return false if the channel is full or closed
+        bool TrySend(_T obj);
+
+        //receive without waiting
+        //return false if the channel is empty
+        bool TryReceive(_T &obj);
+
+        //wake every waiter
+        //pending senders and later senders fail
+        //receivers drain the buffered values first
+        void Close() noexcept
+        {
+            Waiter *chain{nullptr};
+            {
+                std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+                if (this->closed_)
+                {
+                    return;
+                }
+                this->closed_ = true;
+                Self::CloseWaiters(this->receivers_,chain);
+                Self::CloseWaiters(this->senders_,chain);
+            }
+            while (chain)
+            {
+                Waiter *next = chain->next_;
+                chain->select_->Complete(chain->index_);
+                chain = next;
+            }
+        }
+
+        bool IsClosed() const noexcept
+        {
+            std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+            return this->closed_;
+        }
+
+        sharpen::Size GetSize() const noexcept
+        {
+            std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+            return this->size_;
+        }
+
+        sharpen::Size GetCapacity() const noexcept
+        {
+            return this->capacity_;
+        }
+    };
+
+    template<typename _T>
+    class ChannelSendCase:public sharpen::IChannelCase,public sharpen::Noncopyable
+    {
+    private:
+        using Self = sharpen::ChannelSendCase<_T>;
+
+        sharpen::Channel<_T> *channel_;
+        _T value_;
+        sharpen::InternalChannelWaiter<_T> waiter_;
+    public:
+        ChannelSendCase(sharpen::Channel<_T> &channel,_T value)
+            :channel_(&channel)
+            ,value_(std::move(value))
+            ,waiter_()
+        {}
+
+        //must not be moved after selected
+        ChannelSendCase(Self &&other) noexcept
+            :channel_(other.channel_)
+            ,value_(std::move(other.value_))
+            ,waiter_(other.waiter_)
+        {}
+
+        virtual ~ChannelSendCase() noexcept = default;
+
+        virtual sharpen::SpinLock &GetLock() noexcept override
+        {
+            return this->channel_->lock_;
+        }
+
+        virtual bool TryExecuteWithoutLock(sharpen::InternalChannelWakeup &wakeup) override
+        {
+            return this->channel_->TrySendWithoutLock(this->value_,this->waiter_.ok_,wakeup);
+        }
+
+        virtual void EnqueueWithoutLock(sharpen::InternalChannelSelect *select,sharpen::Size index) noexcept override
+        {
+            this->waiter_.select_ = select;
+            this->waiter_.index_ = index;
+            this->waiter_.value_ = &this->value_;
+            this->waiter_.ok_ = false;
+            this->channel_->senders_.Push(&this->waiter_);
+        }
+
+        virtual void DequeueWithoutLock() noexcept override
+        {
+            if (this->waiter_.queued_)
+            {
+                this->channel_->senders_.Remove(&this->waiter_);
+            }
+        }
+
+        virtual bool Ok() const noexcept override
+        {
+            return this->waiter_.ok_;
+        }
+    };
+
+    template<typename _T>
+    class ChannelReceiveCase:public sharpen::IChannelCase,public sharpen::Noncopyable
+    {
+    private:
+        using Self = sharpen::ChannelReceiveCase<_T>;
+
+        sharpen::Channel<_T> *channel_;
+        _T *target_;
+        sharpen::InternalChannelWaiter<_T> waiter_;
+    public:
+        ChannelReceiveCase(sharpen::Channel<_T> &channel,_T &target)
+            :channel_(&channel)
+            ,target_(&target)
+            ,waiter_()
+        {}
+
+        //must not be moved after selected
+        ChannelReceiveCase(Self &&other) noexcept
+            :channel_(other.channel_)
+            ,target_(other.target_)
+            ,waiter_(other.waiter_)
+        {}
+
+        virtual ~ChannelReceiveCase() noexcept = default;
+
+        virtual sharpen::SpinLock &GetLock() noexcept override
+        {
+            return this->channel_->lock_;
+        }
+
+        virtual bool TryExecuteWithoutLock(sharpen::InternalChannelWakeup &wakeup) override
+        {
+            return this->channel_->TryReceiveWithoutLock(*this->target_,this->waiter_.ok_,wakeup);
+        }
+
+        virtual void EnqueueWithoutLock(sharpen::InternalChannelSelect *select,sharpen::Size index) noexcept override
+        {
+            this->waiter_.select_ = select;
+            this->waiter_.index_ = index;
+            this->waiter_.value_ = this->target_;
+            this->waiter_.ok_ = false;
+            this->channel_->receivers_.Push(&this->waiter_);
+        }
+
+        virtual void DequeueWithoutLock() noexcept override
+        {
+            if (this->waiter_.queued_)
+            {
+                this->channel_->receivers_.Remove(&this->waiter_);
+            }
+        }
+
+        virtual bool Ok() const noexcept override
+        {
+            return this->waiter_.ok_;
+        }
+    };
+
+    template<typename _T>
+    inline sharpen::ChannelSendCase<_T> MakeSendCase(sharpen::Channel<_T> &channel,_T value)
+    {
+        return sharpen::ChannelSendCase<_T>(channel,std::move(value));
+    }
+
+    template<typename _T>
+    inline sharpen::ChannelReceiveCase<_T> MakeReceiveCase(sharpen::Channel<_T> &channel,_T &target)
+    {
+        return sharpen::ChannelReceiveCase<_T>(channel,target);
+    }
+
+    //wait until one of the cases is executed
+    //return its index
+    //earlier cases are preferred if several are ready
+    template<typename ..._Cases>
+    inline sharpen::Size SelectAsync(_Cases &&...cases)
+    {
+        sharpen::IChannelCase *caseArray[] = {&cases...};
+        sharpen::SpinLock *lockArray[sizeof...(cases)];
+        return sharpen::InternalSelect(caseArray,lockArray,sizeof...(cases),true);
+    }
+
+    //execute the first ready case without waiting
+    //return its index or the number of cases if none is ready
+    template<typename ..._Cases>
+    inline sharpen::Size TrySelect(_Cases &&...cases)
+    {
+        sharpen::IChannelCase *caseArray[] = {&cases...};
+        sharpen::SpinLock *lockArray[sizeof...(cases)];
+        return sharpen::InternalSelect(caseArray,lockArray,sizeof...(cases),false);
+    }
+
+    template<typename _T>
+    inline bool sharpen::Channel<_T>::SendAsync(_T obj)
+    {
+        sharpen::ChannelSendCase<_T> sendCase(*this,std::move(obj));
+        sharpen::SelectAsync(sendCase);
+        return sendCase.Ok();
+    }
+
+    template<typename _T>
+    inline bool sharpen::Channel<_T>::ReceiveAsync(_T &obj)
+    {
+        sharpen::ChannelReceiveCase<_T> receiveCase(*this,obj);
+        sharpen::SelectAsync(receiveCase);
+        return receiveCase.Ok();
+    }
+
+    template<typename _T>
+    inline bool sharpen::Channel<_T>::TrySend(_T obj)
+    {
+        sharpen::ChannelSendCase<_T> sendCase(*this,std::move(obj));
+        return sharpen::TrySelect(sendCase) == 0 && sendCase.Ok();
+    }
+
+    template<typename _T>
+    inline bool sharpen::Channel<_T>::TryReceive(_T &obj)
+    {
+        sharpen::ChannelReceiveCase<_T> receiveCase(*this,obj);
+        return sharpen::TrySelect(receiveCase) == 0 && receiveCase.Ok();
+    }
+}
+
+#endif
@@ -0,0 +1,81 @@
+#pragma once
+#ifndef _SHARPEN_COMPUTEPOOL_HPP
+#define _SHARPEN_COMPUTEPOOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Noncopyable.hpp"
+#include "Nonmovable.hpp"
+#include "TypeDef.hpp"
+
+namespace sharpen
+{
+    //plain worker threads for cpu-bound work
+    //so that parallel algorithms do not occupy the event loops
+    class ComputePool:public sharpen::Noncopyable,public sharpen::Nonmovable
+    {
+    private:
+        using Task = std::function<void()>;
+
+        std::vector<std::thread> workers_;
+        std::deque<Task> tasks_;
+        std::mutex lock_;
+        std::condition_variable cond_;
+        bool running_;
+
+        void Run();
+    public:
+        ComputePool();
+
+        explicit ComputePool(sharpen::Size workerCount);
+
+        //wait for every queued task
+        ~ComputePool() noexcept;
+
+        void Submit(Task task);
+
+        sharpen::Size GetWorkerNumber() const noexcept
+        {
+            return this->workers_.size();
+        }
+    };
+
+    //where a parallel algorithm runs
+    //the event engine by default
+    class ParallelExecutor
+    {
+    private:
+        using Task = std::function<void()>;
+
+        sharpen::ComputePool *pool_;
+    public:
+        ParallelExecutor() noexcept
+            :pool_(nullptr)
+        {}
+
+        ParallelExecutor(sharpen::ComputePool &pool) noexcept
+            :pool_(&pool)
+        {}
+
+        //nullptr means the event engine
+        sharpen::ComputePool *GetPool() const noexcept
+        {
+            return this->pool_;
+        }
+
+        sharpen::Size GetParallelNumber() const noexcept;
+
+        void Launch(Task task) const;
+
+        //an event loop thread must not run cpu-bound work for a compute pool
+        //any other caller helps the workers
+        bool CallerShouldHelp() const noexcept;
+    };
+}
+
+#endif
@@ -3,6 +3,7 @@
 #define _SHARPEN_COPYONWRITEOBJECT_HPP
 
 #include <utility>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <functional>
@@ -11,54 +12,120 @@
 #include "Noncopyable.hpp"
 #include "Nonmovable.hpp"
 #include "SpinLock.hpp"
+#include "EpochReclaimer.hpp"
 
 namespace sharpen
 {
+    //keep a read section open while the object is used
+    //it should not cross a fiber switch
+    template<typename _T>
+    class CopyOnWriteReadGuard:public sharpen::Noncopyable
+    {
+    private:
+        using Self = sharpen::CopyOnWriteReadGuard<_T>;
+
+        const _T *obj_;
+    public:
+        explicit CopyOnWriteReadGuard(const std::atomic<_T*> &obj)
+            :obj_(nullptr)
+        {
+            sharpen::EpochReclaimer::Enter();
+            this->obj_ = obj.load(std::memory_order_acquire);
+        }
+
+        CopyOnWriteReadGuard(Self &&other) noexcept
+            :obj_(other.obj_)
+        {
+            other.obj_ = nullptr;
+        }
 
+        ~CopyOnWriteReadGuard() noexcept
+        {
+            if (this->obj_)
+            {
+                sharpen::EpochReclaimer::Leave();
+            }
+        }
+
+        const _T &operator*() const noexcept
+        {
+            assert(this->obj_);
+            return *this->obj_;
+        }
+
+        const _T *operator->() const noexcept
+        {
+            assert(this->obj_);
+            return this->obj_;
+        }
+
+        const _T *Get() const noexcept
+        {
+            return this->obj_;
+        }
+    };
+
+    //readers never lock and never touch a shared reference count
+    //writers copy the object, modify the copy and publish it
+    //the old object is freed by EpochReclaimer once its readers have left
     template<typename _T,typename _Lock = sharpen::SpinLock>
     class CopyOnWriteObject:public sharpen::Noncopyable,public sharpen::Nonmovable
     {
     private:
         using Lock = _Lock;
-        using Ptr = std::shared_ptr<_T>;
-        using Writer = std::function<void(Ptr&)>;
+        using Writer = std::function<void(_T&)>;
+        using ReadGuard = sharpen::CopyOnWriteReadGuard<_T>;
 
-        Ptr obj_;
+        std::atomic<_T*> obj_;
+        //serialize writers
         Lock lock_;
     public:
-        std::thread
         template<typename ..._Args>
         explicit CopyOnWriteObject(_Args &&...args)
-            :obj_(std::make_shared<_T>(std::forward<_Args>(args)...))
+            :obj_(new _T(std::forward<_Args>(args)...))
             ,lock_()
         {}
 
-        ~CopyOnWriteObject() = default;
+        //no reader should be alive
+        ~CopyOnWriteObject() noexcept
+        {
+            delete this->obj_.load(std::memory_order_relaxed);
+        }
 
-        Ptr Read() const
+        ReadGuard Read() const
         {
-            Ptr p;
-            {
-                std::unique_lock<Lock> lock(this->lock_);
-                p = this->obj_;
-                assert(!p.unique());
-            }
-            return p;
+            return ReadGuard(this->obj_);
+        }
+
+        template<typename _Fn>
+        auto Read(_Fn &&fn) const -> decltype(fn(std::declval<const _T&>()))
+        {
+            ReadGuard guard(this->obj_);
+            return fn(*guard);
         }
 
         void Write(Writer writer)
         {
+            std::unique_lock<Lock> lock(this->lock_);
+            _T *old = this->obj_.load(std::memory_order_relaxed);
+            std::unique_ptr<_T> copy(new _T(*old));
+            writer(*copy);
+            this->obj_.store(copy.release(),std::memory_order_release);
+            lock.unlock();
+            sharpen::EpochReclaimer::Retire(old);
+        }
+
+        //replace the object without copying
+        void Store(_T obj)
+        {
+            std::unique_ptr<_T> p(new _T(std::move(obj)));
+            _T *old;
             {
                 std::unique_lock<Lock> lock(this->lock_);
-                if (!this->obj_.unique())
-                {
-                    Ptr p = std::make_shared<_T>(*this->obj_);
-                    this->obj_ = std::move(p);
-                }
-                assert(this->obj_.unique());
-                writer(this->obj_);
+                old = this->obj_.exchange(p.release(),std::memory_order_acq_rel);
             }
+            sharpen::EpochReclaimer::Retire(old);
         }
     };
 }
-#endif
\ No newline at end of file
+#endif
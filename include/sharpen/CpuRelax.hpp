@@ -0,0 +1,33 @@
+#pragma once
+#ifndef _SHARPEN_CPURELAX_HPP
+#define _SHARPEN_CPURELAX_HPP
+
+#include "CompilerInfo.hpp"
+#include "ForceInline.hpp"
+
+#ifdef SHARPEN_COMPILER_MSVC
+#include <intrin.h>
+#endif
+
+namespace sharpen
+{
+    //hint the cpu that we are in a spin-wait loop
+    SHARPEN_FORCEINLINE void CpuRelax() noexcept
+    {
+#ifdef SHARPEN_COMPILER_MSVC
+#if (defined (_M_IX86)) || (defined (_M_X64))
+        _mm_pause();
+#else
+        __yield();
+#endif
+#elif (defined (__i386__)) || (defined (__x86_64__))
+        __builtin_ia32_pause();
+#elif (defined (__aarch64__)) || (defined (__arm__))
+        asm volatile("yield" ::: "memory");
+#else
+        asm volatile("" ::: "memory");
+#endif
+    }
+}
+
+#endif
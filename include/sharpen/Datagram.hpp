@@ -0,0 +1,118 @@
+#pragma once
+#ifndef _SHARPEN_DATAGRAM_HPP
+#define _SHARPEN_DATAGRAM_HPP
+
+#include "IEndPoint.hpp"
+#include "TypeDef.hpp"
+
+namespace sharpen
+{
+    class PosixDatagramChannel;
+
+    //one datagram and its endpoints
+    //the buffer is owned by the caller
+    class Datagram
+    {
+    private:
+        using Self = sharpen::Datagram;
+        using Addr = sockaddr_storage;
+
+        friend class sharpen::PosixDatagramChannel;
+
+        sharpen::Char *buf_;
+        sharpen::Size capacity_;
+        sharpen::Size size_;
+        //source of received datagrams or destination of sent datagrams
+        Addr remote_;
+        sharpen::Uint32 remoteLen_;
+        //destination of received datagrams or source of sent datagrams
+        Addr local_;
+        sharpen::Uint32 localLen_;
+        //size of the segments of an offloaded datagram
+        sharpen::Uint16 segmentSize_;
+        bool truncated_;
+    public:
+        Datagram() noexcept;
+
+        //the size is capacity
+        Datagram(sharpen::Char *buf,sharpen::Size capacity) noexcept;
+
+        Datagram(const Self &other) noexcept = default;
+
+        Self &operator=(const Self &other) noexcept = default;
+
+        ~Datagram() noexcept = default;
+
+        void SetBuffer(sharpen::Char *buf,sharpen::Size capacity) noexcept;
+
+        inline sharpen::Char *Data() noexcept
+        {
+            return this->buf_;
+        }
+
+        inline const sharpen::Char *Data() const noexcept
+        {
+            return this->buf_;
+        }
+
+        inline sharpen::Size GetCapacity() const noexcept
+        {
+            return this->capacity_;
+        }
+
+        inline sharpen::Size GetSize() const noexcept
+        {
+            return this->size_;
+        }
+
+        //throw std::length_error if size is larger than capacity
+        void SetSize(sharpen::Size size);
+
+        //return true if the received datagram is larger than capacity
+        inline bool IsTruncated() const noexcept
+        {
+            return this->truncated_;
+        }
+
+        inline bool HasRemoteEndPoint() const noexcept
+        {
+            return this->remoteLen_ != 0;
+        }
+
+        //throw std::length_error if the endpoint cannot hold the address
+        void GetRemoteEndPoint(sharpen::IEndPoint &endPoint) const;
+
+        void SetRemoteEndPoint(const sharpen::IEndPoint &endPoint);
+
+        inline bool HasLocalEndPoint() const noexcept
+        {
+            return this->localLen_ != 0;
+        }
+
+        //throw std::length_error if the endpoint cannot hold the address
+        void GetLocalEndPoint(sharpen::IEndPoint &endPoint) const;
+
+        //choose the source address of a sent datagram
+        void SetLocalEndPoint(const sharpen::IEndPoint &endPoint);
+
+        inline void ClearLocalEndPoint() noexcept
+        {
+            this->localLen_ = 0;
+        }
+
+        //0 if the datagram is not segmented
+        inline sharpen::Uint16 GetSegmentSize() const noexcept
+        {
+            return this->segmentSize_;
+        }
+
+        //split a sent datagram into segments of size bytes by the kernel or the nic
+        //0 means no segmentation
+        inline void SetSegmentSize(sharpen::Uint16 size) noexcept
+        {
+            this->segmentSize_ = size;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,117 @@
+#pragma once
+#ifndef _SHARPEN_EPOCHRECLAIMER_HPP
+#define _SHARPEN_EPOCHRECLAIMER_HPP
+
+#include <atomic>
+
+#include "Noncopyable.hpp"
+#include "Nonmovable.hpp"
+#include "SpinLock.hpp"
+#include "TypeDef.hpp"
+
+namespace sharpen
+{
+    //per-thread reader state
+    //only the owner thread writes epoch_ and nesting_
+    struct InternalEpochRecord
+    {
+        //0 means the thread is not in a read section
+        std::atomic<sharpen::Uint64> epoch_;
+        std::atomic_bool inUse_;
+        sharpen::Size nesting_;
+        InternalEpochRecord *next_;
+    };
+
+    //epoch based reclamation
+    //readers publish the epoch they entered in a thread-local record
+    //so a read section never performs an atomic read-modify-write
+    //writers retire old objects and free them
+    //once every reader which may reference them has left
+    class EpochReclaimer:public sharpen::Noncopyable,public sharpen::Nonmovable
+    {
+    private:
+        using Self = sharpen::EpochReclaimer;
+        using Record = sharpen::InternalEpochRecord;
+        using Deleter = void(*)(void*);
+
+        struct Retired
+        {
+            void *obj_;
+            Deleter deleter_;
+            sharpen::Uint64 epoch_;
+            Retired *next_;
+        };
+
+        static std::atomic<sharpen::Uint64> epoch_;
+        static std::atomic<Record*> records_;
+        static sharpen::SpinLock retiredLock_;
+        static Retired *retired_;
+
+        //free the records and the retired objects at exit
+        struct Cleaner
+        {
+            ~Cleaner() noexcept;
+        };
+
+        static Cleaner cleaner_;
+
+        static Record *AcquireRecord();
+
+        static Record *GetLocalRecord();
+
+        //minimal epoch of active readers
+        //or UINT64_MAX if there is none
+        static sharpen::Uint64 GetMinActiveEpoch() noexcept;
+
+        template<typename _T>
+        static void DeleteObject(void *obj) noexcept
+        {
+            delete reinterpret_cast<_T*>(obj);
+        }
+
+        static void Retire(void *obj,Deleter deleter);
+    public:
+        //enter a read section
+        //sections can nest
+        //a fiber must not switch inside a read section
+        //the first call of a thread may allocate its record
+        //and throw std::bad_alloc
+        static void Enter();
+
+        static void Leave() noexcept;
+
+        //free obj after every current reader left
+        //obj must have been unpublished before
+        template<typename _T>
+        static void Retire(_T *obj)
+        {
+            Self::Retire(obj,&Self::DeleteObject<_T>);
+        }
+
+        //free every retired object whose readers have left
+        //return the number of freed objects
+        static sharpen::Size Reclaim();
+
+        //wait until every current reader has left
+        //then free every retired object
+        //must not be called inside a read section
+        static void Synchronize();
+    };
+
+    //raii read section
+    class EpochGuard:public sharpen::Noncopyable,public sharpen::Nonmovable
+    {
+    public:
+        EpochGuard()
+        {
+            sharpen::EpochReclaimer::Enter();
+        }
+
+        ~EpochGuard() noexcept
+        {
+            sharpen::EpochReclaimer::Leave();
+        }
+    };
+}
+
+#endif
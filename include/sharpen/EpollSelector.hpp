@@ -13,6 +13,7 @@
 #include "EventFd.hpp"
 #include "Nonmovable.hpp"
 #include "EpollEventStruct.hpp"
+#include "SpinLock.hpp"
 
 namespace sharpen
 {
@@ -30,6 +31,7 @@ namespace sharpen
         Map map_;
 
         EventBuf eventBuf_;
+        sharpen::SpinLock lock_;
 
         static bool CheckChannel(sharpen::ChannelPtr channel) noexcept;
     public:
@@ -43,6 +45,9 @@ namespace sharpen
         virtual void Notify() override;
         
         virtual void Resister(WeakChannelPtr channel) override;
+
+        //should be called in the loop thread after the events are dispatched
+        virtual void Deregister(sharpen::FileHandle handle) override;
     };
 }
 
@@ -9,6 +9,7 @@
 #include "Noncopyable.hpp"
 #include "Nonmovable.hpp"
 #include "IFiberScheduler.hpp"
+#include "ILoopPlacementPolicy.hpp"
 #include "TypeTraits.hpp"
 
 namespace sharpen
@@ -28,6 +29,7 @@ namespace sharpen
         sharpen::Size pos_;
         std::unique_ptr<sharpen::EventLoop> mainLoop_;
         std::vector<sharpen::EventLoop*> loops_;
+        sharpen::LoopPlacementPolicyPtr policy_;
 
         static thread_local SwitchCallback switchCb_;
 
@@ -54,6 +56,13 @@ namespace sharpen
 
         sharpen::EventLoop *RoundRobinLoop() noexcept;
 
+        //choose a loop for a new channel by the placement policy
+        sharpen::EventLoop *SelectLoop() noexcept;
+
+        //the default policy is LeastLoadedPlacementPolicy
+        //should be called before registering channels
+        void SetPlacementPolicy(sharpen::LoopPlacementPolicyPtr policy);
+
         virtual void Schedule(sharpen::FiberPtr &&fiber) override;
 
         virtual bool IsProcesser() const override;
@@ -94,6 +103,11 @@ namespace sharpen
         {
             return this->loops_.size();
         }
+
+        const std::vector<sharpen::EventLoop*> &GetLoops() const noexcept
+        {
+            return this->loops_;
+        }
     };
 }
 
@@ -2,10 +2,13 @@
 #ifndef _SHARPEN_IEVENTLOOP_HPP
 #define _SHARPEN_IEVENTLOOP_HPP
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <set>
 
 #include "Noncopyable.hpp"
 #include "Nonmovable.hpp"
@@ -17,6 +20,16 @@
 
 namespace sharpen
 {
+    //a snapshot of the work of an event loop
+    struct EventLoopLoad
+    {
+        //channels bound to the loop
+        sharpen::Size channels_;
+        //tasks waiting for the next iteration
+        sharpen::Size pendingTasks_;
+        //moving average of the busy time per iteration in per mille
+        sharpen::Uint32 busyRatio_;
+    };
     
     class EventLoop:public sharpen::Noncopyable,public sharpen::Nonmovable
     {
@@ -27,6 +40,7 @@ namespace sharpen
         using SelectorPtr = std::shared_ptr<sharpen::ISelector>;
         using EventVector = std::vector<sharpen::IoEvent*>;
         using WeakChannelPtr = std::weak_ptr<sharpen::IChannel>;
+        using HandleSet = std::set<sharpen::FileHandle>;
         
         SelectorPtr selector_;
         TaskVector tasks_;
@@ -35,6 +49,9 @@ namespace sharpen
         Lock lock_;
         bool running_;
         bool waiting_;
+        Lock channelLock_;
+        HandleSet channels_;
+        std::atomic<sharpen::Uint32> busyRatio_;
 
         //one loop per thread
         thread_local static EventLoop *localLoop_;
@@ -43,6 +60,9 @@ namespace sharpen
 
         //execute pending tasks
         void ExecuteTask();
+
+        //update the moving average and return the end of this iteration
+        std::chrono::steady_clock::time_point UpdateBusyRatio(std::chrono::steady_clock::time_point idleBegin,std::chrono::steady_clock::time_point busyBegin) noexcept;
     public:
         //create event loop with a selector and an uniqued task list
         explicit EventLoop(SelectorPtr selector);
@@ -52,6 +72,15 @@ namespace sharpen
         //bind a channel to event loop
         //the channel must be supported by selector
         void Bind(WeakChannelPtr channel);
+
+        //called when a bound handle is closed
+        //ignore handles which are not bound
+        void Unbind(sharpen::FileHandle handle) noexcept;
+
+        //remove a bound handle from the selector
+        //return false if the handle is not bound
+        //should be called in the loop thread after the events are dispatched
+        bool Detach(sharpen::FileHandle handle);
         
         sharpen::ISelector &GetSelector() const noexcept
         {
@@ -82,6 +111,9 @@ namespace sharpen
         static sharpen::FiberPtr GetLocalFiber() noexcept;
 
         bool IsWaiting() const noexcept;
+
+        //could be called by any thread
+        sharpen::EventLoopLoad GetLoad() noexcept;
     };
 }
 
@@ -6,6 +6,7 @@
 #include <functional>
 
 #include "MemoryStack.hpp"
+#include "ObjectPool.hpp"
 #include "Noncopyable.hpp"
 #include "Nonmovable.hpp"
 
@@ -85,7 +86,7 @@ namespace sharpen
         template<typename _Fn,typename ..._Args>
         static sharpen::FiberPtr MakeFiber(sharpen::Size stackSize,_Fn &&fn,_Args &&...args)
         {
-            sharpen::FiberPtr fiber = std::make_shared<sharpen::Fiber>();
+            sharpen::FiberPtr fiber = sharpen::ObjectPool<sharpen::Fiber>::MakeShared();
             fiber->stack_ = std::move(sharpen::MemoryStack(nullptr,stackSize));
             fiber->task_ = std::move(std::bind(std::forward<_Fn>(fn),std::forward<_Args>(args)...));
             return fiber;
@@ -8,6 +8,7 @@
 #include <exception>
 #include <stdexcept>
 
+#include "ObjectPool.hpp"
 #include "SpinLock.hpp"
 #include "TypeDef.hpp"
 
@@ -28,9 +29,9 @@ namespace sharpen
         using Self = Future<_Value>;
         using Callback = std::function<void(Self&)>;
 
-        std::unique_ptr<sharpen::SpinLock> lock_;
-        std::unique_ptr<_Value> value_;
-        std::unique_ptr<std::condition_variable_any> cond_;
+        sharpen::PoolPtr<sharpen::SpinLock> lock_;
+        sharpen::PoolPtr<_Value> value_;
+        sharpen::PoolPtr<std::condition_variable_any> cond_;
         Callback callback_;
         FutureState state_;
         std::exception_ptr error_;
@@ -46,9 +47,9 @@ namespace sharpen
         }
     public:
         Future()
-            :lock_(new sharpen::SpinLock())
+            :lock_(sharpen::ObjectPool<sharpen::SpinLock>::New())
             ,value_(nullptr)
-            ,cond_(new std::condition_variable_any())
+            ,cond_(sharpen::ObjectPool<std::condition_variable_any>::New())
             ,callback_()
             ,state_(sharpen::FutureState::Pending)
             ,error_()
@@ -117,7 +118,7 @@ namespace sharpen
                     return;
                 }
                 this->state_ = sharpen::FutureState::Completed;
-                this->value_.reset(new _Value(args...));
+                this->value_.reset(sharpen::ObjectPool<_Value>::New(args...));
             }
             this->ExecuteCallback();
         }
@@ -249,8 +250,8 @@ namespace sharpen
         using Self = Future<void>;
         using Callback = std::function<void(Self&)>;
 
-        std::unique_ptr<sharpen::SpinLock> lock_;
-        std::unique_ptr<std::condition_variable_any> cond_;
+        sharpen::PoolPtr<sharpen::SpinLock> lock_;
+        sharpen::PoolPtr<std::condition_variable_any> cond_;
         Callback callback_;
         FutureState state_;
         std::exception_ptr error_;
@@ -268,8 +269,8 @@ namespace sharpen
     public:
 
         Future()
-            :lock_(new sharpen::SpinLock())
-            ,cond_(new std::condition_variable_any())
+            :lock_(sharpen::ObjectPool<sharpen::SpinLock>::New())
+            ,cond_(sharpen::ObjectPool<std::condition_variable_any>::New())
             ,callback_()
             ,state_(sharpen::FutureState::Pending)
             ,error_()
@@ -451,8 +452,7 @@ namespace sharpen
     template<typename _Value>
     inline sharpen::FuturePtr<_Value> MakeFuturePtr()
     {
-        auto p = std::make_shared<sharpen::Future<_Value>>();
-        return std::move(p);
+        return sharpen::ObjectPool<sharpen::Future<_Value>>::MakeShared();
     }
 } 
 
@@ -5,6 +5,7 @@
 #include "TcpServer.hpp"
 #include "HttpRequest.hpp"
 #include "HttpResponse.hpp"
+#include "Arena.hpp"
 
 namespace sharpen
 {
@@ -18,7 +19,15 @@ namespace sharpen
     protected:
         virtual void OnNewChannel(sharpen::NetStreamChannelPtr channel) override;
 
-        virtual void OnNewMessage(sharpen::NetStreamChannelPtr channel,const sharpen::HttpRequest &req,sharpen::HttpResponse &res) = 0;
+        //override one of the OnNewMessage overloads
+        //the default implementation throws std::logic_error
+        virtual void OnNewMessage(sharpen::NetStreamChannelPtr channel,const sharpen::HttpRequest &req,sharpen::HttpResponse &res);
+
+        //arena belongs to the connection and holds the serialized response
+        //it is reset after the response was written
+        //objects allocated from it must not outlive the request
+        //the default implementation calls the overload without arena
+        virtual void OnNewMessage(sharpen::NetStreamChannelPtr channel,const sharpen::HttpRequest &req,sharpen::HttpResponse &res,sharpen::Arena &arena);
     public:
         
         HttpServer(sharpen::AddressFamily af,const sharpen::IEndPoint &endpoint,sharpen::EventEngine &engine);
@@ -15,12 +15,23 @@ namespace sharpen
     class IoEvent;
 
     class EventEngine;
+
+    template<typename _Value>
+    class Future;
     
     class IChannel:public std::enable_shared_from_this<sharpen::IChannel>
     {
     private:
         using Self = sharpen::IChannel;
         using Closer = std::function<void(sharpen::FileHandle)>;
+
+        static void DoMigrate(std::shared_ptr<Self> channel,sharpen::EventLoop *loop,sharpen::Future<void> *future) noexcept;
+
+        //runs in the source loop after the tasks of the detaching iteration
+        static void PostMigrate(std::shared_ptr<Self> channel,sharpen::EventLoop *loop,sharpen::Future<void> *future) noexcept;
+
+        //runs in the target loop
+        static void CompleteMigrate(std::shared_ptr<Self> channel,sharpen::EventLoop *loop,sharpen::Future<void> *future) noexcept;
         
     protected:
         sharpen::EventLoop *loop_;
@@ -43,6 +54,13 @@ namespace sharpen
         virtual void Register(sharpen::EventLoop *loop);
 
         void Register(sharpen::EventEngine &engine);
+
+        //move the channel and its pending operations to another loop
+        //pending operations are completed in the new loop
+        //do not start new operations on the channel until the future is completed
+        void MigrateAsync(sharpen::EventLoop *loop,sharpen::Future<void> &future);
+
+        void MigrateAsync(sharpen::EventLoop *loop);
         
         //close channel
         void Close() noexcept;
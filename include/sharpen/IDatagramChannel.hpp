@@ -0,0 +1,60 @@
+#pragma once
+#ifndef _SHARPEN_IDATAGRAMCHANNEL_HPP
+#define _SHARPEN_IDATAGRAMCHANNEL_HPP
+
+#include "IChannel.hpp"
+#include "IEndPoint.hpp"
+#include "Datagram.hpp"
+#include "Future.hpp"
+#include "INetStreamChannel.hpp"
+
+namespace sharpen
+{
+    class IDatagramChannel:public sharpen::IChannel
+    {
+    private:
+        using Self = sharpen::IDatagramChannel;
+    public:
+
+        IDatagramChannel() = default;
+
+        virtual ~IDatagramChannel() noexcept = default;
+
+        IDatagramChannel(const Self &) = default;
+
+        IDatagramChannel(Self &&) noexcept = default;
+
+        //receive up to count datagrams
+        //the future is completed with the number of received datagrams once any arrives
+        //the source and destination endpoints of every datagram are filled
+        virtual void ReceiveManyAsync(sharpen::Datagram *datagrams,sharpen::Size count,sharpen::Future<sharpen::Size> &future) = 0;
+
+        sharpen::Size ReceiveManyAsync(sharpen::Datagram *datagrams,sharpen::Size count);
+
+        //send count datagrams to their remote endpoints
+        //the future is completed with the number of sent datagrams
+        //the datagrams and their buffers must be alive until the future is completed
+        virtual void SendManyAsync(const sharpen::Datagram *datagrams,sharpen::Size count,sharpen::Future<sharpen::Size> &future) = 0;
+
+        sharpen::Size SendManyAsync(const sharpen::Datagram *datagrams,sharpen::Size count);
+
+        //receive coalesced datagrams of one flow as a single datagram
+        //see Datagram::GetSegmentSize
+        //return false if the kernel does not support it
+        virtual bool SetReceiveOffload(bool val) noexcept = 0;
+
+        void Bind(const sharpen::IEndPoint &endpoint);
+
+        void GetLocalEndPoint(sharpen::IEndPoint &endPoint) const;
+
+        void SetReuseAddress(bool val);
+
+        virtual void Cancel() noexcept = 0;
+    };
+
+    using DatagramChannelPtr = std::shared_ptr<sharpen::IDatagramChannel>;
+
+    sharpen::DatagramChannelPtr MakeUdpChannel(sharpen::AddressFamily af);
+}
+
+#endif
@@ -34,6 +34,13 @@ namespace sharpen
         virtual const NativeAddr *GetAddrPtr() const noexcept = 0;
 
         virtual sharpen::Uint32 GetAddrLen() const = 0;
+
+        //called after the system fills the address with len bytes
+        //endpoints of variable length keep it
+        virtual void SetAddrLen(sharpen::Uint32 len) noexcept
+        {
+            (void)len;
+        }
     };
 }
 
@@ -12,6 +12,8 @@
 
 namespace sharpen
 {
+    class IOutputPipeChannel;
+
     class IInputPipeChannel:public sharpen::IChannel,public sharpen::IAsyncReadable
     {
     private:
@@ -48,6 +50,23 @@ namespace sharpen
         sharpen::Size GetsAsync(char *buf,sharpen::Size bufSize);
 
         std::string GetsAsync();
+
+        //return the capacity set by the kernel
+        //the default implementation throws std::logic_error
+        virtual sharpen::Size SetPipeSize(sharpen::Size size);
+
+        //0 if unknown
+        virtual sharpen::Size GetPipeSize() const noexcept;
+
+        //copy up to size bytes to the pipe of to without consuming them
+        //in order with other reads
+        //the future is completed with 0 at the end of stream
+        //waits until the pipe of to could accept more bytes if it is full
+        //to must outlive the future
+        //the default implementation throws std::logic_error
+        virtual void TeeAsync(sharpen::IOutputPipeChannel &to,sharpen::Size size,sharpen::Future<sharpen::Size> &future);
+
+        sharpen::Size TeeAsync(sharpen::IOutputPipeChannel &to,sharpen::Size size);
     };
 
     using InputPipeChannelPtr = std::shared_ptr<sharpen::IInputPipeChannel>;
@@ -0,0 +1,32 @@
+#pragma once
+#ifndef _SHARPEN_ILOOPPLACEMENTPOLICY_HPP
+#define _SHARPEN_ILOOPPLACEMENTPOLICY_HPP
+
+#include <memory>
+#include <vector>
+
+#include "EventLoop.hpp"
+#include "Noncopyable.hpp"
+#include "Nonmovable.hpp"
+
+namespace sharpen
+{
+    //choose the event loop of a new channel
+    class ILoopPlacementPolicy:public sharpen::Noncopyable,public sharpen::Nonmovable
+    {
+    private:
+
+    public:
+        ILoopPlacementPolicy() noexcept = default;
+
+        virtual ~ILoopPlacementPolicy() noexcept = default;
+
+        //loops is never empty
+        //could be called by many threads at the same time
+        virtual sharpen::EventLoop *SelectLoop(const std::vector<sharpen::EventLoop*> &loops) noexcept = 0;
+    };
+
+    using LoopPlacementPolicyPtr = std::unique_ptr<sharpen::ILoopPlacementPolicy>;
+}
+
+#endif
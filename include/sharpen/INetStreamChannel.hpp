@@ -8,6 +8,7 @@
 #include "IAsyncWritable.hpp"
 #include "IFileChannel.hpp"
 #include "IEndPoint.hpp"
+#include "BufferChain.hpp"
 
 namespace sharpen
 {
@@ -30,6 +31,15 @@ namespace sharpen
         
         INetStreamChannel(Self &&) noexcept = default;
 
+        using sharpen::IAsyncWritable::WriteAsync;
+
+        //write every segment of chain in order
+        //the chain must be alive until the future is completed
+        //the default implementation flattens the chain
+        virtual void WriteAsync(const sharpen::BufferChain &chain,sharpen::Future<sharpen::Size> &future);
+
+        sharpen::Size WriteAsync(const sharpen::BufferChain &chain);
+
         virtual void SendFileAsync(sharpen::FileChannelPtr file,sharpen::Uint64 size,sharpen::Uint64 offset,sharpen::Future<void> &future) = 0;
         
         virtual void SendFileAsync(sharpen::FileChannelPtr file,sharpen::Future<void> &future) = 0;
@@ -69,16 +79,81 @@ namespace sharpen
         void PollWriteAsync();
 
         virtual void Cancel() noexcept = 0;
+
+        //coalesce the writes issued in one loop iteration into as few writev calls as possible
+        //the default implementation ignores it
+        virtual void SetWriteCoalescing(bool coalesce) noexcept;
+
+        //writes issued while the queued bytes reach the mark wait until they drop below it
+        //0 means no limit
+        //the default implementation ignores it
+        virtual void SetWriteHighWaterMark(sharpen::Size mark) noexcept;
+
+        //bytes queued but not yet written
+        //only tracked when a high-water mark is set
+        virtual sharpen::Size GetPendingWriteSize() const noexcept;
+
+        //write system calls issued by the channel
+        //the default implementation returns 0
+        virtual sharpen::Size GetWriteCallCount() const noexcept;
+
+        //writes of at least threshold bytes are sent without copying
+        //their futures are completed when the kernel releases the buffer
+        //the buffer must not be changed or freed before that
+        //cancel waits for the release of sent writes
+        //destroying the channel fails them at once, so the buffer must outlive the connection
+        //0 means disabled
+        //the default implementation ignores it
+        virtual void SetZeroCopyThreshold(sharpen::Size threshold) noexcept;
+
+        //0 if zero copy is disabled or unsupported
+        virtual sharpen::Size GetZeroCopyThreshold() const noexcept;
+
+        //pass handles to the peer of a unix domain socket
+        //the handles are written with one marker byte in order with other writes
+        //the default implementation throws std::logic_error
+        virtual void SendHandlesAsync(const sharpen::FileHandle *handles,sharpen::Size count,sharpen::Future<void> &future);
+
+        void SendHandlesAsync(const sharpen::FileHandle *handles,sharpen::Size count);
+
+        //receive the handles sent by SendHandlesAsync at this point of the stream
+        //the future is completed with the number of received handles
+        //the caller owns the received handles
+        //the default implementation throws std::logic_error
+        virtual void ReceiveHandlesAsync(sharpen::FileHandle *handles,sharpen::Size count,sharpen::Future<sharpen::Size> &future);
+
+        sharpen::Size ReceiveHandlesAsync(sharpen::FileHandle *handles,sharpen::Size count);
+
+        //move up to size bytes from the channel into the write end of a pipe
+        //in order with other reads
+        //the future is completed with 0 at the end of stream
+        //the pipe must have room for size bytes
+        //the default implementation throws std::logic_error
+        virtual void SpliceToPipeAsync(sharpen::FileHandle pipe,sharpen::Size size,sharpen::Future<sharpen::Size> &future);
+
+        sharpen::Size SpliceToPipeAsync(sharpen::FileHandle pipe,sharpen::Size size);
+
+        //move size bytes from the read end of a pipe to the channel
+        //in order with other writes
+        //the pipe must hold size bytes
+        //the default implementation throws std::logic_error
+        virtual void SpliceFromPipeAsync(sharpen::FileHandle pipe,sharpen::Size size,sharpen::Future<sharpen::Size> &future);
+
+        sharpen::Size SpliceFromPipeAsync(sharpen::FileHandle pipe,sharpen::Size size);
     };
 
     enum class AddressFamily
     {
         Ip,
-        Ipv6
+        Ipv6,
+        Unix
     };
 
+    //AddressFamily::Unix makes a unix domain stream channel
     sharpen::NetStreamChannelPtr MakeTcpStreamChannel(sharpen::AddressFamily af);
 
+    sharpen::NetStreamChannelPtr MakeUnixStreamChannel();
+
     void StartupNetSupport();
 
     void CleanupNetSupport();
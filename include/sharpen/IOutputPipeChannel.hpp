@@ -38,6 +38,27 @@ namespace sharpen
             std::snprintf(buf.Data(),buf.GetSize(),format,std::forward<_Args>(args)...);
             return this->WriteAsync(buf);
         }
+
+        //return the capacity set by the kernel
+        //the default implementation throws std::logic_error
+        virtual sharpen::Size SetPipeSize(sharpen::Size size);
+
+        //0 if unknown
+        virtual sharpen::Size GetPipeSize() const noexcept;
+
+        //map the pages of buf into the pipe instead of copying them
+        //in order with other writes
+        //buf must not be modified until the reader consumes the bytes
+        //the default implementation throws std::logic_error
+        virtual void VmspliceAsync(const sharpen::Char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> &future);
+
+        sharpen::Size VmspliceAsync(const sharpen::Char *buf,sharpen::Size bufSize);
+
+        //completed when the pipe could accept more bytes
+        //the default implementation throws std::logic_error
+        virtual void PollWriteAsync(sharpen::Future<void> &future);
+
+        void PollWriteAsync();
     };
 
     using OutputPipeChannelPtr = std::shared_ptr<sharpen::IOutputPipeChannel>;
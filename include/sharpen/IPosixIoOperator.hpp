@@ -64,6 +64,9 @@ namespace sharpen
 
         void Execute(sharpen::FileHandle handle,bool &executed,bool &blocking);
 
+        //return true if no task is queued
+        bool Empty() const;
+
         static bool IsBlockingError(sharpen::ErrorCode code);
 
         void CancelAllIo(sharpen::ErrorCode err) noexcept;
@@ -39,6 +39,10 @@ namespace sharpen
         
         //register file handle
         virtual void Resister(WeakChannelPtr channel) = 0;
+
+        //remove a registered file handle
+        //throw std::logic_error if the selector could not do it
+        virtual void Deregister(sharpen::FileHandle handle);
     };
 
     using SelectorPtr = std::shared_ptr<sharpen::ISelector>;
@@ -0,0 +1,48 @@
+#pragma once
+#ifndef _SHARPEN_LOOPPLACEMENTPOLICY_HPP
+#define _SHARPEN_LOOPPLACEMENTPOLICY_HPP
+
+#include <atomic>
+
+#include "ILoopPlacementPolicy.hpp"
+
+namespace sharpen
+{
+    //ignore the load of loops
+    class RoundRobinPlacementPolicy:public sharpen::ILoopPlacementPolicy
+    {
+    private:
+        std::atomic<sharpen::Size> pos_;
+    public:
+        RoundRobinPlacementPolicy() noexcept;
+
+        virtual ~RoundRobinPlacementPolicy() noexcept = default;
+
+        virtual sharpen::EventLoop *SelectLoop(const std::vector<sharpen::EventLoop*> &loops) noexcept override;
+    };
+
+    //choose the loop with the lowest weighted load
+    //score = channels * channelWeight + pendingTasks * taskWeight + busyRatio * busyWeight
+    //busyRatio is in per mille
+    //so a loop which is always busy counts as 16 channels by default
+    class LeastLoadedPlacementPolicy:public sharpen::ILoopPlacementPolicy
+    {
+    private:
+        std::atomic<sharpen::Size> pos_;
+        sharpen::Size channelWeight_;
+        sharpen::Size taskWeight_;
+        sharpen::Size busyWeight_;
+
+        sharpen::Size Score(const sharpen::EventLoopLoad &load) const noexcept;
+    public:
+        LeastLoadedPlacementPolicy() noexcept;
+
+        LeastLoadedPlacementPolicy(sharpen::Size channelWeight,sharpen::Size taskWeight,sharpen::Size busyWeight) noexcept;
+
+        virtual ~LeastLoadedPlacementPolicy() noexcept = default;
+
+        virtual sharpen::EventLoop *SelectLoop(const std::vector<sharpen::EventLoop*> &loops) noexcept override;
+    };
+}
+
+#endif
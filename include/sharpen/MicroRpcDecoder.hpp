@@ -5,6 +5,7 @@
 #include "MicroRpcStack.hpp"
 #include "Noncopyable.hpp"
 #include "MicroRpcParseException.hpp"
+#include "BufferSlice.hpp"
 
 namespace sharpen
 {
@@ -30,6 +31,9 @@ namespace sharpen
         bool completed_;
 
         const char *RunStateMachine(const char *begin,const char *end);
+
+        //return 0 if the field is incomplete
+        static sharpen::Size ComputeFieldSize(const char *data,sharpen::Size size);
     public:
         MicroRpcDecoder() noexcept;
 
@@ -41,6 +45,10 @@ namespace sharpen
 
         sharpen::Size Decode(const char *data,sharpen::Size size);
 
+        //complete fields share buf instead of being copied
+        //buf must not be written after decoding
+        sharpen::Size Decode(const sharpen::BufferSlice &buf);
+
         bool IsCompleted() const noexcept
         {
             return this->completed_;
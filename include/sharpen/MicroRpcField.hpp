@@ -6,6 +6,7 @@
 #include <cstring>
 
 #include "ByteBuffer.hpp"
+#include "BufferSlice.hpp"
 #include "MicroRpcVariable.hpp"
 #include "IntOps.hpp"
 #include "IteratorOps.hpp"
@@ -49,6 +50,13 @@ namespace sharpen
         using Self = sharpen::MicroRpcField;
 
         sharpen::ByteBuffer data_;
+        //set when the field shares the receive buffer
+        //data_ is empty then
+        sharpen::BufferSlice slice_;
+
+        char *RawBegin() noexcept;
+
+        const char *RawBegin() const noexcept;
 
         void InitHeader(sharpen::MicroRpcVariableType type);
 
@@ -65,7 +73,7 @@ namespace sharpen
             {
                 throw std::logic_error("bad cast");
             }
-            return sharpen::MicroRpcVariable<_T>{this->Data<_T>,reinterpret_cast<_T*>(&*this->RawData().End())};
+            return sharpen::MicroRpcVariable<_T>{this->Data<_T>,reinterpret_cast<const _T*>(this->RawBegin() + this->GetRawSize())};
         }
 
         template<typename _T,sharpen::MicroRpcVariableType _TypeEnum = sharpen::MicroRpcVariableTypeTrait<_T>::TypeEnum_,typename _Check = sharpen::EnableIf<std::is_same<void,_T>::value>>
@@ -96,7 +104,7 @@ namespace sharpen
                 sizeSpace += 1;
             }
             sharpen::Size totalSize{sizeSpace + variable.ComputeSize() + 1};
-            this->data_.ExtendTo(totalSize);
+            this->data_.ExtendToUninitialized(totalSize);
             //copy size
             std::memcpy(this->data_.Data() + 1,&size,sizeSpace);
             //copy data
@@ -112,7 +120,7 @@ namespace sharpen
             //init header
             this->InitHeader(sharpen::MicroRpcVariableTypeTrait<_T>::TypeEnum_);
             //copy data
-            this->data_.ExtendTo(1 + sizeof(val));
+            this->data_.ExtendToUninitialized(1 + sizeof(val));
             sharpen::InternalMicroRpcVariableCopyTo<sizeof(val)>(this->RawData().Data() + 1,reinterpret_cast<const char*>(&val));
         }
 
@@ -147,7 +155,7 @@ namespace sharpen
             {
                 sizeSpace += 1;
             }
-            this->data_.ExtendTo(sizeSpace + size*typeSize + 1);
+            this->data_.ExtendToUninitialized(sizeSpace + size*typeSize + 1);
             //copy size
             std::memcpy(this->data_.Data() + 1,&size,sizeSpace);
             char *data = this->RawData().Data() + 1 + sizeSpace;
@@ -160,6 +168,14 @@ namespace sharpen
             }
         }
 
+        //share a complete encoded field
+        explicit MicroRpcField(sharpen::BufferSlice slice) noexcept
+            :data_()
+            ,slice_(std::move(slice))
+        {
+            assert(!this->slice_.Empty());
+        }
+
         MicroRpcField(const Self &other) = default;
 
         MicroRpcField(Self &&other) noexcept = default;
@@ -172,11 +188,24 @@ namespace sharpen
 
         void CopyTo(bool last,char *buf,sharpen::Size size) const;
 
+        //the owned bytes
+        //a sliced field must be unshared first
         sharpen::ByteBuffer &RawData() noexcept
         {
+            assert(!this->IsSliced());
+            return this->data_;
+        }
+
+        const sharpen::ByteBuffer &RawData() const noexcept
+        {
+            assert(!this->IsSliced());
             return this->data_;
         }
 
+        //copy a sliced field to its own buffer
+        //writes to a sliced field are seen by its copies until then
+        void Unshare();
+
         template<typename _T,sharpen::MicroRpcVariableType _TypeEnum = sharpen::MicroRpcVariableTypeTrait<_T>::TypeEnum_>
         _T *Data()
         {
@@ -197,24 +226,35 @@ namespace sharpen
             return reinterpret_cast<const _T*>(this->ComputeDataBody());
         }
 
-        const sharpen::ByteBuffer &RawData() const noexcept
+        //the encoded bytes of a sliced or an owned field
+        const char *GetRawBytes() const noexcept
         {
-            return this->data_;
+            return this->RawBegin();
+        }
+
+        bool IsSliced() const noexcept
+        {
+            return !this->slice_.Empty();
+        }
+
+        const sharpen::BufferSlice &GetSlice() const noexcept
+        {
+            return this->slice_;
         }
 
         sharpen::MicroRpcFieldHeader &Header() noexcept
         {
-            return *reinterpret_cast<sharpen::MicroRpcFieldHeader*>(this->data_.Data());
+            return *reinterpret_cast<sharpen::MicroRpcFieldHeader*>(this->RawBegin());
         }
 
         const sharpen::MicroRpcFieldHeader &Header() const noexcept
         {
-            return *reinterpret_cast<const sharpen::MicroRpcFieldHeader*>(this->data_.Data());
+            return *reinterpret_cast<const sharpen::MicroRpcFieldHeader*>(this->RawBegin());
         }
 
         sharpen::Size GetRawSize() const noexcept
         {
-            return this->data_.GetSize();
+            return this->IsSliced() ? this->slice_.GetSize():this->data_.GetSize();
         }
 
         sharpen::Uint64 GetSize() const;
@@ -2,111 +2,72 @@
 #ifndef _SHARPEN_OBJECTPOOL_HPP
 #define _SHARPEN_OBJECTPOOL_HPP
 
-#include <list>
-#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
 
-#include "Noncopyable.hpp"
+#include "SizeClassAllocator.hpp"
 #include "TypeDef.hpp"
 
 namespace sharpen
 {
+    //typed pool on top of SizeClassAllocator
+    //it is thread safe
+    //an object must be deleted as the type it was created as
+    //over-aligned types bypass the pool
     template<typename _T>
-    class ObjectPool:public sharpen::Noncopyable
+    class ObjectPool
     {
-    private:
-        using Self = sharpen::ObjectPool<_T>;
-        using List = std::list<_T>;
-        using Creator = std::function<_T()>;
-        using Deletor = std::function<void(_T&)>;
-        
-        List objects_;
-        Creator creator_;
-        Deletor deletor_;
-        sharpen::Size maxReserved_;
     public:
-        ObjectPool(Creator creator,sharpen::Size maxReserved)
-            :objects_()
-            ,creator_(std::move(creator))
-            ,deletor_()
-            ,maxReserved_(maxReserved)
-        {}
-        
-        ObjectPool(Creator creator,Deletor deletor,sharpen::Size maxReserved)
-            :objects_()
-            ,creator_(std::move(creator))
-            ,deletor_(std::move(deletor))
-            ,maxReserved_(maxReserved)
-        {}
-        
-        ObjectPool(Self &&other) noexcept
-            :objects_(std::move(other.objects_))
-            ,creator_(std::move(other.creator_))
-            ,deletor_(std::move(other.deletor_))
-            ,maxReserved_(other.maxReserved_)
-        {}
-        
-        ~ObjectPool() noexcept
+        template<typename ..._Args>
+        static _T *New(_Args &&...args)
         {
-            for(auto begin = std::begin(this->objects_),end = std::end(this->objects_);begin != end;++begin)
+            void *p = sharpen::SizeClassAllocator::Allocate(sizeof(_T),alignof(_T));
+            try
             {
-                this->deletor_(*begin);
+                return new (p) _T(std::forward<_Args>(args)...);
             }
-        }
-        
-        Self &operator=(Self &&other) noexcept
-        {
-            this->objects_ = std::move(other.objects_);
-            this->creator_ = std::move(other.creator_);
-            this->deletor_ = std::move(other.deletor_);
-            this->maxReserved = other.maxReserved_;
-            return *this;
-        }
-        
-        void Swap(Self &other) noexcept
-        {
-            if (&other != this)
+            catch(...)
             {
-                std::swap(this->objects_,other.objects_);
-                std::swap(this->creator_,other.creator_);
-                std::swap(this->deletor_,other.deletor_);
-                std::swap(this->maxReserved_,other.maxReserved_);
+                sharpen::SizeClassAllocator::Deallocate(p,sizeof(_T),alignof(_T));
+                throw;
             }
         }
-        
-        inline void swap(Self &other) noexcept
-        {
-            this->Swap(other);
-        }
-        
-        _T Get() noexcept
+
+        static void Delete(_T *obj) noexcept
         {
-            if(this->objects_.empty())
+            if (obj)
             {
-                return std::move(this->creator_());
+                obj->~_T();
+                sharpen::SizeClassAllocator::Deallocate(obj,sizeof(_T),alignof(_T));
             }
-            _T obj(std::move(this->objects_.front()));
-            this->objects_.pop_front();
-            return std::move(obj);
         }
-        
-        void Reserve(sharpen::Size n)
+
+        //the control block is pooled too
+        template<typename ..._Args>
+        static std::shared_ptr<_T> MakeShared(_Args &&...args)
         {
-            for(sharpen::Size i = 0;i < n;++i)
-            {
-                this->objects_.push_back(std::move(this->creator()));
-            }
+            return std::allocate_shared<_T>(sharpen::PoolAllocator<_T>(),std::forward<_Args>(args)...);
         }
-        
-        void GiveBack(_T &&obj)
+    };
+
+    template<typename _T>
+    struct PoolDeletor
+    {
+        void operator()(_T *obj) const noexcept
         {
-            if(this->objects_.size() > this->maxReserved_)
-            {
-                this->deletor_(obj);
-                return;
-            }
-            this->objects_.push_back(std::move(obj));
+            sharpen::ObjectPool<_T>::Delete(obj);
         }
     };
+
+    template<typename _T>
+    using PoolPtr = std::unique_ptr<_T,sharpen::PoolDeletor<_T>>;
+
+    template<typename _T,typename ..._Args>
+    inline sharpen::PoolPtr<_T> MakePoolPtr(_Args &&...args)
+    {
+        return sharpen::PoolPtr<_T>(sharpen::ObjectPool<_T>::New(std::forward<_Args>(args)...));
+    }
 }
 
 #endif
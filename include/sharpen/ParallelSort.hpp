@@ -0,0 +1,244 @@
+#pragma once
+#ifndef _SHARPEN_PARALLELSORT_HPP
+#define _SHARPEN_PARALLELSORT_HPP
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <vector>
+#include <cassert>
+
+#include "AsyncOps.hpp"
+
+//ranges smaller than this are sorted or merged by one worker
+#ifndef SHARPEN_PARALLEL_SORT_GRAIN
+#define SHARPEN_PARALLEL_SORT_GRAIN 2048
+#endif
+
+namespace sharpen
+{
+    //merge path partition
+    //return how many elements of [first1,first1 + size1) are in
+    //the first index elements of the stable merge
+    template<typename _Iterator1,typename _Iterator2,typename _Compare>
+    inline sharpen::Size InternalMergeSplit(_Iterator1 first1,sharpen::Size size1,_Iterator2 first2,sharpen::Size size2,sharpen::Size index,_Compare &comp)
+    {
+        sharpen::Size begin{index > size2 ? index - size2:0};
+        sharpen::Size end{(std::min)(index,size1)};
+        while (begin < end)
+        {
+            sharpen::Size i{begin + (end - begin)/2};
+            sharpen::Size j{index - i};
+            //equal elements of the first range go first
+            if (!comp(*(first2 + (j - 1)),*(first1 + i)))
+            {
+                begin = i + 1;
+            }
+            else
+            {
+                end = i;
+            }
+        }
+        return begin;
+    }
+
+    //merge [first1,first1 + size1) and [first2,first2 + size2)
+    //only write the output elements in [outBegin,outEnd)
+    template<typename _Iterator1,typename _Iterator2,typename _OutputIterator,typename _Compare>
+    inline void InternalMergePart(_Iterator1 first1,sharpen::Size size1,_Iterator2 first2,sharpen::Size size2,_OutputIterator out,sharpen::Size outBegin,sharpen::Size outEnd,_Compare &comp)
+    {
+        sharpen::Size i{sharpen::InternalMergeSplit(first1,size1,first2,size2,outBegin,comp)};
+        sharpen::Size iEnd{sharpen::InternalMergeSplit(first1,size1,first2,size2,outEnd,comp)};
+        sharpen::Size j{outBegin - i};
+        sharpen::Size jEnd{outEnd - iEnd};
+        std::merge(first1 + i,first1 + iEnd,first2 + j,first2 + jEnd,out + outBegin,comp);
+    }
+
+    //merge two sorted ranges into out
+    //the merge is stable
+    //the output is cut into parts which are located by binary search
+    //so every part is merged independently
+    template<typename _RandomIterator1,typename _RandomIterator2,typename _RandomOutputIterator,typename _Compare>
+    inline _RandomOutputIterator ParallelMerge(const sharpen::ParallelExecutor &executor,_RandomIterator1 first1,_RandomIterator1 last1,_RandomIterator2 first2,_RandomIterator2 last2,_RandomOutputIterator out,_Compare comp)
+    {
+        sharpen::Size size1{static_cast<sharpen::Size>(last1 - first1)};
+        sharpen::Size size2{static_cast<sharpen::Size>(last2 - first2)};
+        sharpen::Size size{size1 + size2};
+        if (size <= SHARPEN_PARALLEL_SORT_GRAIN)
+        {
+            return std::merge(first1,last1,first2,last2,out,comp);
+        }
+        sharpen::Size partSize{sharpen::InternalParallelBlockSize(executor,size,SHARPEN_PARALLEL_SORT_GRAIN)};
+        sharpen::Size parts{(size + partSize - 1)/partSize};
+        sharpen::InternalParallelFor(executor,0,parts,1,[&](sharpen::Size begin,sharpen::Size end)
+        {
+            for (; begin != end; ++begin)
+            {
+                sharpen::Size outBegin{begin*partSize};
+                sharpen::Size outEnd{(std::min)(outBegin + partSize,size)};
+                sharpen::InternalMergePart(first1,size1,first2,size2,out,outBegin,outEnd,comp);
+            }
+        });
+        return out + size;
+    }
+
+    template<typename _RandomIterator1,typename _RandomIterator2,typename _RandomOutputIterator>
+    inline _RandomOutputIterator ParallelMerge(const sharpen::ParallelExecutor &executor,_RandomIterator1 first1,_RandomIterator1 last1,_RandomIterator2 first2,_RandomIterator2 last2,_RandomOutputIterator out)
+    {
+        using Value = typename std::iterator_traits<_RandomIterator1>::value_type;
+        return sharpen::ParallelMerge(executor,first1,last1,first2,last2,out,std::less<Value>());
+    }
+
+    template<typename _RandomIterator1,typename _RandomIterator2,typename _RandomOutputIterator,typename _Compare>
+    inline _RandomOutputIterator ParallelMerge(_RandomIterator1 first1,_RandomIterator1 last1,_RandomIterator2 first2,_RandomIterator2 last2,_RandomOutputIterator out,_Compare comp)
+    {
+        return sharpen::ParallelMerge(sharpen::ParallelExecutor(),first1,last1,first2,last2,out,std::move(comp));
+    }
+
+    template<typename _RandomIterator1,typename _RandomIterator2,typename _RandomOutputIterator>
+    inline _RandomOutputIterator ParallelMerge(_RandomIterator1 first1,_RandomIterator1 last1,_RandomIterator2 first2,_RandomIterator2 last2,_RandomOutputIterator out)
+    {
+        return sharpen::ParallelMerge(sharpen::ParallelExecutor(),first1,last1,first2,last2,out);
+    }
+
+    //merge every pair of neighbouring runs of src into dst
+    //a run without a partner is moved
+    template<typename _Source,typename _Target,typename _Compare>
+    inline void InternalMergeRound(const sharpen::ParallelExecutor &executor,_Source src,_Target dst,sharpen::Size size,sharpen::Size runSize,_Compare &comp)
+    {
+        sharpen::Size pairSize{runSize*2};
+        sharpen::Size pairs{(size + pairSize - 1)/pairSize};
+        sharpen::Size partSize{sharpen::InternalParallelBlockSize(executor,size,SHARPEN_PARALLEL_SORT_GRAIN)};
+        //split the pairs into parts of about partSize elements
+        sharpen::Size partsPerPair{(pairSize + partSize - 1)/partSize};
+        sharpen::InternalParallelFor(executor,0,pairs*partsPerPair,1,[&](sharpen::Size begin,sharpen::Size end)
+        {
+            for (; begin != end; ++begin)
+            {
+                sharpen::Size pair{begin/partsPerPair};
+                sharpen::Size part{begin % partsPerPair};
+                sharpen::Size first{pair*pairSize};
+                sharpen::Size middle{(std::min)(first + runSize,size)};
+                sharpen::Size last{(std::min)(first + pairSize,size)};
+                sharpen::Size total{last - first};
+                sharpen::Size outBegin{(std::min)(part*partSize,total)};
+                sharpen::Size outEnd{(std::min)(outBegin + partSize,total)};
+                if (outBegin == outEnd)
+                {
+                    continue;
+                }
+                sharpen::InternalMergePart(std::make_move_iterator(src + first),middle - first,std::make_move_iterator(src + middle),last - middle,dst + first,outBegin,outEnd,comp);
+            }
+        });
+    }
+
+    //sort runs with sortRun then merge them in rounds
+    //the merges are stable
+    //so the result is stable if sortRun is stable
+    template<typename _RandomIterator,typename _Compare,typename _SortRun>
+    inline void InternalParallelMergeSort(const sharpen::ParallelExecutor &executor,_RandomIterator begin,_RandomIterator end,_Compare &comp,_SortRun sortRun)
+    {
+        using Value = typename std::iterator_traits<_RandomIterator>::value_type;
+        sharpen::Size size{static_cast<sharpen::Size>(end - begin)};
+        if (size <= SHARPEN_PARALLEL_SORT_GRAIN || executor.GetParallelNumber() == 1)
+        {
+            sortRun(begin,end,comp);
+            return;
+        }
+        sharpen::Size runSize{sharpen::InternalParallelBlockSize(executor,size,SHARPEN_PARALLEL_SORT_GRAIN)};
+        sharpen::Size runs{(size + runSize - 1)/runSize};
+        sharpen::InternalParallelFor(executor,0,runs,1,[&](sharpen::Size first,sharpen::Size last)
+        {
+            for (; first != last; ++first)
+            {
+                sharpen::Size runBegin{first*runSize};
+                sharpen::Size runEnd{(std::min)(runBegin + runSize,size)};
+                sortRun(begin + runBegin,begin + runEnd,comp);
+            }
+        });
+        std::vector<Value> buffer(size);
+        bool inBuffer{false};
+        for (; runSize < size; runSize *= 2)
+        {
+            if (inBuffer)
+            {
+                sharpen::InternalMergeRound(executor,buffer.begin(),begin,size,runSize,comp);
+            }
+            else
+            {
+                sharpen::InternalMergeRound(executor,begin,buffer.begin(),size,runSize,comp);
+            }
+            inBuffer = !inBuffer;
+        }
+        if (inBuffer)
+        {
+            auto src = buffer.begin();
+            sharpen::InternalParallelFor(executor,0,size,SHARPEN_PARALLEL_SORT_GRAIN,[src,begin](sharpen::Size first,sharpen::Size last)
+            {
+                std::move(src + first,src + last,begin + first);
+            });
+        }
+    }
+
+    //merge sort whose runs are sorted by std::sort
+    //the value type must be default constructible
+    template<typename _RandomIterator,typename _Compare>
+    inline void ParallelSort(const sharpen::ParallelExecutor &executor,_RandomIterator begin,_RandomIterator end,_Compare comp)
+    {
+        sharpen::InternalParallelMergeSort(executor,begin,end,comp,[](_RandomIterator first,_RandomIterator last,_Compare &comp)
+        {
+            std::sort(first,last,comp);
+        });
+    }
+
+    template<typename _RandomIterator>
+    inline void ParallelSort(const sharpen::ParallelExecutor &executor,_RandomIterator begin,_RandomIterator end)
+    {
+        using Value = typename std::iterator_traits<_RandomIterator>::value_type;
+        sharpen::ParallelSort(executor,begin,end,std::less<Value>());
+    }
+
+    template<typename _RandomIterator,typename _Compare>
+    inline void ParallelSort(_RandomIterator begin,_RandomIterator end,_Compare comp)
+    {
+        sharpen::ParallelSort(sharpen::ParallelExecutor(),begin,end,std::move(comp));
+    }
+
+    template<typename _RandomIterator>
+    inline void ParallelSort(_RandomIterator begin,_RandomIterator end)
+    {
+        sharpen::ParallelSort(sharpen::ParallelExecutor(),begin,end);
+    }
+
+    //equal elements keep their order
+    //the value type must be default constructible
+    template<typename _RandomIterator,typename _Compare>
+    inline void ParallelStableSort(const sharpen::ParallelExecutor &executor,_RandomIterator begin,_RandomIterator end,_Compare comp)
+    {
+        sharpen::InternalParallelMergeSort(executor,begin,end,comp,[](_RandomIterator first,_RandomIterator last,_Compare &comp)
+        {
+            std::stable_sort(first,last,comp);
+        });
+    }
+
+    template<typename _RandomIterator>
+    inline void ParallelStableSort(const sharpen::ParallelExecutor &executor,_RandomIterator begin,_RandomIterator end)
+    {
+        using Value = typename std::iterator_traits<_RandomIterator>::value_type;
+        sharpen::ParallelStableSort(executor,begin,end,std::less<Value>());
+    }
+
+    template<typename _RandomIterator,typename _Compare>
+    inline void ParallelStableSort(_RandomIterator begin,_RandomIterator end,_Compare comp)
+    {
+        sharpen::ParallelStableSort(sharpen::ParallelExecutor(),begin,end,std::move(comp));
+    }
+
+    template<typename _RandomIterator>
+    inline void ParallelStableSort(_RandomIterator begin,_RandomIterator end)
+    {
+        sharpen::ParallelStableSort(sharpen::ParallelExecutor(),begin,end);
+    }
+}
+
+#endif
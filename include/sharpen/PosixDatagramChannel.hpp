@@ -0,0 +1,102 @@
+#pragma once
+#ifndef _SHARPEN_POSIXDATAGRAMCHANNEL_HPP
+#define _SHARPEN_POSIXDATAGRAMCHANNEL_HPP
+
+#include "SystemMacro.hpp"
+
+//recvmmsg and sendmmsg
+#ifdef SHARPEN_IS_LINUX
+
+#define SHARPEN_HAS_POSIXDATAGRAM
+
+#include <deque>
+#include <vector>
+#include <functional>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "IDatagramChannel.hpp"
+#include "Noncopyable.hpp"
+#include "Nonmovable.hpp"
+#include "SystemError.hpp"
+
+//datagrams passed to one recvmmsg or sendmmsg
+#ifndef SHARPEN_DATAGRAM_BATCH_SIZE
+#define SHARPEN_DATAGRAM_BATCH_SIZE 64
+#endif
+
+namespace sharpen
+{
+    class PosixDatagramChannel:public sharpen::IDatagramChannel,public sharpen::Noncopyable,public sharpen::Nonmovable
+    {
+    private:
+        using Mybase = sharpen::IDatagramChannel;
+        using Callback = std::function<void(ssize_t)>;
+
+        struct ReceiveTask
+        {
+            sharpen::Datagram *datagrams_;
+            sharpen::Size count_;
+            Callback cb_;
+        };
+
+        struct SendTask
+        {
+            const sharpen::Datagram *datagrams_;
+            sharpen::Size count_;
+            sharpen::Size sent_;
+            Callback cb_;
+        };
+
+        int af_;
+        bool readable_;
+        bool writeable_;
+        std::deque<ReceiveTask> receiveTasks_;
+        std::deque<SendTask> sendTasks_;
+        //batch buffers
+        std::vector<mmsghdr> msgs_;
+        std::vector<iovec> iovs_;
+        std::vector<char> controls_;
+        //port of destination endpoints
+        sharpen::UintPort localPort_;
+
+        void PrepareBatch(sharpen::Size count);
+
+        void ParseControl(msghdr &msg,sharpen::Datagram &datagram);
+
+        sharpen::Size BuildControl(const sharpen::Datagram &datagram,char *control) const noexcept;
+
+        void DoReceive();
+
+        void DoSend();
+
+        void TryReceive(sharpen::Datagram *datagrams,sharpen::Size count,Callback cb);
+
+        void TrySend(const sharpen::Datagram *datagrams,sharpen::Size count,Callback cb);
+
+        void RequestReceive(sharpen::Datagram *datagrams,sharpen::Size count,sharpen::Future<sharpen::Size> *future);
+
+        void RequestSend(const sharpen::Datagram *datagrams,sharpen::Size count,sharpen::Future<sharpen::Size> *future);
+
+        static void CompleteIoCallback(sharpen::IChannel *channel,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept;
+
+        void DoCancel(sharpen::ErrorCode err) noexcept;
+    public:
+        PosixDatagramChannel(sharpen::FileHandle handle,int af);
+
+        virtual ~PosixDatagramChannel() noexcept;
+
+        virtual void ReceiveManyAsync(sharpen::Datagram *datagrams,sharpen::Size count,sharpen::Future<sharpen::Size> &future) override;
+
+        virtual void SendManyAsync(const sharpen::Datagram *datagrams,sharpen::Size count,sharpen::Future<sharpen::Size> &future) override;
+
+        virtual bool SetReceiveOffload(bool val) noexcept override;
+
+        virtual void OnEvent(sharpen::IoEvent *event) override;
+
+        virtual void Cancel() noexcept override;
+    };
+}
+
+#endif
+#endif
@@ -5,6 +5,8 @@
 #include "SystemMacro.hpp"
 #ifdef SHARPEN_IS_NIX
 
+#include <deque>
+#include <exception>
 #include <functional>
 
 #include "IInputPipeChannel.hpp"
@@ -14,6 +16,11 @@
 
 #define SHARPEN_HAS_POSIXINPUTPIPE
 
+//F_SETPIPE_SZ, vmsplice and tee are only supported by linux
+#ifdef SHARPEN_IS_LINUX
+#define SHARPEN_HAS_PIPESPLICE
+#endif
+
 namespace sharpen
 {
     class PosixInputPipeChannel:public sharpen::IInputPipeChannel,public sharpen::Noncopyable,public sharpen::Nonmovable
@@ -22,18 +29,41 @@ namespace sharpen
         using Mybase = sharpen::IInputPipeChannel;
         using Callback = std::function<void(ssize_t)>;
 
+        //a read that must wait for the reads queued before it
+        struct OrderedRead
+        {
+            char *buf_;
+            sharpen::Size size_;
+            Callback cb_;
+            //nullptr unless the bytes are copied to a pipe by tee
+            sharpen::IOutputPipeChannel *to_;
+        };
+
         sharpen::PosixIoReader reader_;
         bool readable_;
+        std::deque<OrderedRead> orderedReads_;
+        //the tee at the front waits for its destination
+        bool teeWaiting_;
 
         void HandleRead();
 
         void DoRead();
 
+        void DoOrderedRead();
+
+        bool DoTee(OrderedRead &read);
+
+        void WaitTee(sharpen::IOutputPipeChannel &to);
+
+        void HandleTeeWait(std::exception_ptr err);
+
         void TryRead(char *buf,sharpen::Size bufSize,Callback cb);
 
+        void TryTee(sharpen::IOutputPipeChannel *to,sharpen::Size size,Callback cb);
+
         void RequestRead(char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> *future);
 
-        static void CompleteReadCallback(sharpen::EventLoop *loop,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept;
+        static void CompleteReadCallback(sharpen::IChannel *channel,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept;
     public:
         explicit PosixInputPipeChannel(sharpen::FileHandle handle);
 
@@ -44,6 +74,14 @@ namespace sharpen
         virtual void ReadAsync(sharpen::ByteBuffer &buf,sharpen::Size bufferOffset,sharpen::Future<sharpen::Size> &future) override;
 
         virtual void OnEvent(sharpen::IoEvent *event) override;
+
+#ifdef SHARPEN_HAS_PIPESPLICE
+        virtual sharpen::Size SetPipeSize(sharpen::Size size) override;
+
+        virtual sharpen::Size GetPipeSize() const noexcept override;
+
+        virtual void TeeAsync(sharpen::IOutputPipeChannel &to,sharpen::Size size,sharpen::Future<sharpen::Size> &future) override;
+#endif
     };
 }
 
@@ -12,12 +12,23 @@ namespace sharpen
     {
     private:
         using Mybase = sharpen::IPosixIoOperator;
+
+        sharpen::Size calls_;
     protected:
         virtual void DoExecute(sharpen::FileHandle handle,bool &executed,bool &blocking) override;
     public:
-        PosixIoWriter() = default;
+        PosixIoWriter()
+            :Mybase()
+            ,calls_(0)
+        {}
 
         ~PosixIoWriter() noexcept = default;
+
+        //writev calls issued so far
+        inline sharpen::Size GetCallCount() const noexcept
+        {
+            return this->calls_;
+        }
     };
 }
 
@@ -8,11 +8,17 @@
 
 #define SHARPEN_HAS_POSIXSOCKET
 
+//splice(2) is only supported by linux
+#ifdef SHARPEN_IS_LINUX
+#define SHARPEN_HAS_SPLICE
+#endif
+
 #include "INetStreamChannel.hpp"
 #include "PosixIoReader.hpp"
 #include "PosixIoWriter.hpp"
 
 #include <vector>
+#include <deque>
 #include <sys/uio.h>
 #include <atomic>
 
@@ -29,6 +35,71 @@ namespace sharpen
         using StatusBit = std::atomic_bool;
         using Callback = std::function<void(ssize_t)>;
         using Callbacks = std::vector<Callback>;
+        using IoBuffers = std::vector<iovec>;
+
+        //shared by the callbacks of one gather write
+        struct GatherWriteState
+        {
+            sharpen::Size pending_;
+            sharpen::Size size_;
+            bool completed_;
+        };
+
+        //a write waiting for the queued bytes to drop below the high-water mark
+        struct ParkedWrite
+        {
+            char *buf_;
+            sharpen::Size size_;
+            Callback cb_;
+        };
+
+        enum class WriteKind
+        {
+            //queued behind other ordered writes only
+            Copy,
+            //sent with MSG_ZEROCOPY
+            ZeroCopy,
+            //one marker byte carrying handles
+            Handles,
+            //moved from a pipe by splice
+            Splice
+        };
+
+        //a write that must wait for the bytes queued before it
+        //every successful zero copy send consumes one notification id
+        struct OrderedWrite
+        {
+            char *buf_;
+            sharpen::Size size_;
+            sharpen::Size sent_;
+            sharpen::Uint32 firstId_;
+            sharpen::Uint32 calls_;
+            sharpen::Uint32 released_;
+            Callback cb_;
+            WriteKind kind_;
+            std::vector<sharpen::FileHandle> handles_;
+            sharpen::FileHandle pipe_;
+            //set if the write is cancelled while the kernel holds its pages
+            sharpen::ErrorCode err_;
+        };
+
+        enum class ReadKind
+        {
+            //one marker byte carrying handles
+            Handles,
+            //moved to a pipe by splice
+            Splice
+        };
+
+        //a read that must wait for the reads queued before it
+        struct OrderedRead
+        {
+            sharpen::FileHandle *handles_;
+            sharpen::Size count_;
+            Callback cb_;
+            ReadKind kind_;
+            sharpen::FileHandle pipe_;
+        };
 
         enum class IoStatus
         {
@@ -49,6 +120,19 @@ namespace sharpen
         ConnectCallback connectCb_;
         Callbacks pollReadCbs_;
         Callbacks pollWriteCbs_;
+        //outbound queue
+        bool coalesceWrites_;
+        bool flushScheduled_;
+        sharpen::Size highWaterMark_;
+        sharpen::Size pendingWriteBytes_;
+        std::deque<ParkedWrite> parkedWrites_;
+        //zero copy
+        sharpen::Size zeroCopyThreshold_;
+        sharpen::Uint32 zeroCopyNextId_;
+        std::deque<OrderedWrite> orderedWrites_;
+        std::deque<OrderedWrite> zeroCopyInflight_;
+        //handle passing and splice
+        std::deque<OrderedRead> orderedReads_;
 
         sharpen::FileHandle DoAccept();
 
@@ -70,10 +154,54 @@ namespace sharpen
 
         bool HandleConnect();
 
+        void EnqueueWrite(char *buf,sharpen::Size bufSize,Callback cb);
+
+        void QueueWrite(char *buf,sharpen::Size bufSize,Callback cb);
+
+        void AdmitWrite(char *buf,sharpen::Size bufSize,Callback cb);
+
+        bool AdmitParkedWrites();
+
+        void DoSetWriteHighWaterMark(sharpen::Size mark);
+
+        void CompleteQueuedWrite(sharpen::Size bufSize,const Callback &cb,ssize_t size);
+
+        void StartWrite();
+
+        void DoOrderedWrite();
+
+        bool DoSendHandles(OrderedWrite &write);
+
+        void DoOrderedRead();
+
+        bool DoReceiveHandles(OrderedRead &read);
+
+        bool DoSpliceFromPipe(OrderedWrite &write);
+
+        bool DoSpliceToPipe(OrderedRead &read);
+
+        void HandleErrorQueue();
+
+        void ReleaseZeroCopyIds(sharpen::Uint32 first,sharpen::Uint32 last) noexcept;
+
+        static void ReleaseZeroCopyIds(OrderedWrite &write,sharpen::Uint32 first,sharpen::Uint32 last) noexcept;
+
+        void FlushWrites();
+
         void TryRead(char *buf,sharpen::Size bufSize,Callback cb);
 
         void TryWrite(const char *buf,sharpen::Size bufSize,Callback cb);
 
+        void TryWriteBuffers(IoBuffers bufs,Callbacks cbs);
+
+        void TrySendHandles(std::vector<sharpen::FileHandle> handles,Callback cb);
+
+        void TryReceiveHandles(sharpen::FileHandle *handles,sharpen::Size count,Callback cb);
+
+        void TrySpliceToPipe(sharpen::FileHandle pipe,sharpen::Size size,Callback cb);
+
+        void TrySpliceFromPipe(sharpen::FileHandle pipe,sharpen::Size size,Callback cb);
+
         void TryAccept(AcceptCallback cb);
 
         void TryConnect(const sharpen::IEndPoint &endPoint,ConnectCallback cb);
@@ -86,6 +214,16 @@ namespace sharpen
 
         void RequestWrite(const char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> *future);
 
+        void RequestWriteChain(const sharpen::BufferChain &chain,sharpen::Future<sharpen::Size> *future);
+
+        void RequestSendHandles(const sharpen::FileHandle *handles,sharpen::Size count,sharpen::Future<void> *future);
+
+        void RequestReceiveHandles(sharpen::FileHandle *handles,sharpen::Size count,sharpen::Future<sharpen::Size> *future);
+
+        void RequestSpliceToPipe(sharpen::FileHandle pipe,sharpen::Size size,sharpen::Future<sharpen::Size> *future);
+
+        void RequestSpliceFromPipe(sharpen::FileHandle pipe,sharpen::Size size,sharpen::Future<sharpen::Size> *future);
+
         void RequestSendFile(sharpen::FileHandle handle,sharpen::Uint64 offset,sharpen::Size size,sharpen::Future<void> *future);
 
         void RequestConnect(const sharpen::IEndPoint &endPoint,sharpen::Future<void> *future);
@@ -96,15 +234,17 @@ namespace sharpen
 
         void RequestPollWrite(sharpen::Future<void> *future);
 
-        static void CompleteConnectCallback(sharpen::EventLoop *loop,sharpen::Future<void> *future) noexcept;
+        static void CompleteConnectCallback(sharpen::IChannel *channel,sharpen::Future<void> *future) noexcept;
 
-        static void CompleteIoCallback(sharpen::EventLoop *loop,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept;
+        static void CompleteIoCallback(sharpen::IChannel *channel,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept;
 
-        static void CompleteSendFileCallback(sharpen::EventLoop *loop,sharpen::Future<void> *future,void *mem,sharpen::Size memLen,ssize_t) noexcept;
+        static void CompleteSendFileCallback(sharpen::IChannel *channel,sharpen::Future<void> *future,void *mem,sharpen::Size memLen,ssize_t) noexcept;
 
-        static void CompleteAcceptCallback(sharpen::EventLoop *loop,sharpen::Future<sharpen::NetStreamChannelPtr> *future,sharpen::FileHandle accept) noexcept;
+        static void CompleteAcceptCallback(sharpen::IChannel *channel,sharpen::Future<sharpen::NetStreamChannelPtr> *future,sharpen::FileHandle accept) noexcept;
 
-        static void CompletePollCallback(sharpen::EventLoop *loop,sharpen::Future<void> *future,ssize_t size) noexcept;
+        static void CompleteGatherWriteCallback(sharpen::IChannel *channel,sharpen::Future<sharpen::Size> *future,std::shared_ptr<GatherWriteState> state,ssize_t size) noexcept;
+
+        static void CompletePollCallback(sharpen::IChannel *channel,sharpen::Future<void> *future,ssize_t size) noexcept;
 
         static bool IsAcceptBlock(sharpen::ErrorCode err) noexcept;
 
@@ -119,6 +259,9 @@ namespace sharpen
         
         virtual void WriteAsync(const sharpen::ByteBuffer &buf,sharpen::Size bufferOffset,sharpen::Future<sharpen::Size> &future) override;
 
+        //segments are written by writev in batches of at most IOV_MAX
+        virtual void WriteAsync(const sharpen::BufferChain &chain,sharpen::Future<sharpen::Size> &future) override;
+
         virtual void ReadAsync(sharpen::Char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> &future) override;
         
         virtual void ReadAsync(sharpen::ByteBuffer &buf,sharpen::Size bufferOffset,sharpen::Future<sharpen::Size> &future) override;
@@ -140,6 +283,34 @@ namespace sharpen
         virtual void PollWriteAsync(sharpen::Future<void> &future) override;
 
         virtual void Cancel() noexcept override;
+
+        //writes are flushed at the end of the loop iteration
+        //by writev in batches of at most IOV_MAX
+        //should be set before issuing writes
+        virtual void SetWriteCoalescing(bool coalesce) noexcept override;
+
+        //lowering the mark admits parked writes in order
+        virtual void SetWriteHighWaterMark(sharpen::Size mark) noexcept override;
+
+        virtual sharpen::Size GetPendingWriteSize() const noexcept override;
+
+        virtual sharpen::Size GetWriteCallCount() const noexcept override;
+
+        //falls back to copying if the kernel does not support SO_ZEROCOPY
+        //should be set before issuing writes
+        virtual void SetZeroCopyThreshold(sharpen::Size threshold) noexcept override;
+
+        virtual sharpen::Size GetZeroCopyThreshold() const noexcept override;
+
+        virtual void SendHandlesAsync(const sharpen::FileHandle *handles,sharpen::Size count,sharpen::Future<void> &future) override;
+
+        virtual void ReceiveHandlesAsync(sharpen::FileHandle *handles,sharpen::Size count,sharpen::Future<sharpen::Size> &future) override;
+
+#ifdef SHARPEN_HAS_SPLICE
+        virtual void SpliceToPipeAsync(sharpen::FileHandle pipe,sharpen::Size size,sharpen::Future<sharpen::Size> &future) override;
+
+        virtual void SpliceFromPipeAsync(sharpen::FileHandle pipe,sharpen::Size size,sharpen::Future<sharpen::Size> &future) override;
+#endif
     };
 }
 
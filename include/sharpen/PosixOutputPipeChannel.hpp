@@ -6,7 +6,9 @@
 
 #ifdef SHARPEN_IS_NIX
 
+#include <deque>
 #include <functional>
+#include <vector>
 
 #include "IOutputPipeChannel.hpp"
 #include "Noncopyable.hpp"
@@ -15,6 +17,11 @@
 
 #define SHARPEN_HAS_POSIXOUTPUTPIPE
 
+//F_SETPIPE_SZ, vmsplice and tee are only supported by linux
+#ifdef SHARPEN_IS_LINUX
+#define SHARPEN_HAS_PIPESPLICE
+#endif
+
 namespace sharpen
 {
     class PosixOutputPipeChannel:public sharpen::IOutputPipeChannel,public sharpen::Noncopyable,public sharpen::Nonmovable
@@ -22,19 +29,42 @@ namespace sharpen
     private:
         using Mybase = sharpen::IOutputPipeChannel;
         using Callback = std::function<void(ssize_t)>;
+
+        //a write that must wait for the bytes queued before it
+        struct OrderedWrite
+        {
+            char *buf_;
+            sharpen::Size size_;
+            sharpen::Size sent_;
+            Callback cb_;
+            //mapped by vmsplice
+            bool map_;
+        };
         
         sharpen::PosixIoWriter writer_;
         bool writeable_;
+        std::deque<OrderedWrite> orderedWrites_;
+        std::vector<Callback> pollWriteCbs_;
         
         void DoWrite();
 
+        void DoPollWrite();
+
+        void DoOrderedWrite();
+
         void HandleWrite();
 
         void TryWrite(const char *buf,sharpen::Size bufSize,Callback cb);
 
+        void TryVmsplice(const char *buf,sharpen::Size bufSize,Callback cb);
+
+        void TryPollWrite(Callback cb);
+
         void RequestWrite(const char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> *future);
         
-        static void CompleteWriteCallback(sharpen::EventLoop *loop,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept;
+        static void CompleteWriteCallback(sharpen::IChannel *channel,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept;
+
+        static void CompletePollCallback(sharpen::IChannel *channel,sharpen::Future<void> *future,ssize_t size) noexcept;
     
     public:
         explicit PosixOutputPipeChannel(sharpen::FileHandle handle);
@@ -46,6 +76,18 @@ namespace sharpen
         virtual void WriteAsync(const sharpen::ByteBuffer &buf,sharpen::Size bufferOffset,sharpen::Future<sharpen::Size> &future) override;
 
         virtual void OnEvent(sharpen::IoEvent *event) override;
+
+        using Mybase::PollWriteAsync;
+
+        virtual void PollWriteAsync(sharpen::Future<void> &future) override;
+
+#ifdef SHARPEN_HAS_PIPESPLICE
+        virtual sharpen::Size SetPipeSize(sharpen::Size size) override;
+
+        virtual sharpen::Size GetPipeSize() const noexcept override;
+
+        virtual void VmspliceAsync(const sharpen::Char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> &future) override;
+#endif
     };
 }
 
@@ -28,6 +28,7 @@ namespace sharpen
     //and expect to get a _Response as response
     //_Encoder should has ByteBuffer Encode(const _Request &req) function
     //_Decoder should has size_t Decode(const char *data,size_t size) and bool IsCompleted() function
+    //size_t Decode(const BufferSlice &buf) is used instead if _Decoder has it
     //all requests will be sended in a order
     //all response should be returned in same order or you may get a wrong message
     template<typename _Request,typename _Encoder,typename _Response,typename _Decoder>
@@ -51,7 +52,8 @@ namespace sharpen
         Pair pair_;
         sharpen::Future<sharpen::Size> readFuture_;
         sharpen::NetStreamChannelPtr conn_;
-        sharpen::ByteBuffer readBuf_;
+        sharpen::BufferSlice readBuf_;
+        sharpen::Size readMark_;
         WaiterList waiters_;
         _Response res_;
         sharpen::Size lastRead_;
@@ -105,11 +107,11 @@ namespace sharpen
         {
             if(this->lastRead_ != 0)
             {
-                sharpen::Size size = this->Decoder().Decode(this->readBuf_.Data() + this->readBuf_.GetMark(),this->lastRead_ - this->readBuf_.GetMark());
-                this->readBuf_.Mark(this->readBuf_.GetMark() + size);
-                if(this->readBuf_.GetMark() == this->lastRead_)
+                sharpen::Size size = sharpen::RpcDecode(this->Decoder(),this->readBuf_.Slice(this->readMark_,this->lastRead_ - this->readMark_));
+                this->readMark_ += size;
+                if(this->readMark_ == this->lastRead_)
                 {
-                    this->readBuf_.Mark(0);
+                    this->readMark_ = 0;
                     this->lastRead_ = 0;
                 }
                 this->ReturnResponse();
@@ -174,7 +176,12 @@ namespace sharpen
             {
                 this->readFuture_.Reset();
                 this->readFuture_.SetCallback(std::bind(&Self::ReadCallback,this,this->token_,std::placeholders::_1));
-                this->conn_->ReadAsync(this->readBuf_,0,this->readFuture_);
+                //returned responses may still share the block
+                if(!this->readBuf_.IsUnique())
+                {
+                    this->readBuf_ = sharpen::BufferSlice{4096};
+                }
+                this->conn_->ReadAsync(this->readBuf_.Data(),this->readBuf_.GetSize(),this->readFuture_);
             }
         }
 
@@ -217,6 +224,7 @@ namespace sharpen
             ,readFuture_()
             ,conn_(std::move(conn))
             ,readBuf_(4096)
+            ,readMark_(0)
             ,waiters_()
             ,res_()
             ,lastRead_(0)
@@ -3,6 +3,7 @@
 #define _SHARPEN_RPCCONCEPTS_HPP
 
 #include "TypeTraits.hpp"
+#include "BufferSlice.hpp"
 
 namespace sharpen
 {
@@ -26,6 +27,33 @@ namespace sharpen
     template<typename _Message,typename _Decoder>
     using IsRpcDecoder = sharpen::IsMatches<sharpen::InternalIsRpcDecoder,_Message,_Decoder>;
 
+    //a decoder which could share the received bytes
+    template<typename _Decoder>
+    using InternalIsRpcSliceDecoder = auto(*)() -> decltype(sharpen::DeclLvalue<sharpen::Size>() = std::declval<_Decoder>().Decode(std::declval<const sharpen::BufferSlice&>()));
+
+    template<typename _Decoder>
+    using IsRpcSliceDecoder = sharpen::IsMatches<sharpen::InternalIsRpcSliceDecoder,_Decoder>;
+
+    template<typename _Decoder,typename _Check = sharpen::EnableIf<sharpen::IsRpcSliceDecoder<_Decoder>::Value>>
+    inline sharpen::Size InternalRpcDecode(_Decoder &decoder,const sharpen::BufferSlice &buf,int)
+    {
+        return decoder.Decode(buf);
+    }
+
+    template<typename _Decoder>
+    inline sharpen::Size InternalRpcDecode(_Decoder &decoder,const sharpen::BufferSlice &buf,...)
+    {
+        return decoder.Decode(buf.Data(),buf.GetSize());
+    }
+
+    //decode a slice of the receive buffer
+    //the decoded message may share it
+    template<typename _Decoder>
+    inline sharpen::Size RpcDecode(_Decoder &decoder,const sharpen::BufferSlice &buf)
+    {
+        return sharpen::InternalRpcDecode(decoder,buf,0);
+    }
+
     template<typename _Message>
     using InternalIsRpcMessage = auto(*)()->decltype(sharpen::DeclLvalue<_Message>().Clear());
 
@@ -2,9 +2,12 @@
 #ifndef _SHARPEN_RPCCONTEXT_HPP
 #define _SHARPEN_RPCCONTEXT_HPP
 
+#include <memory>
+
 #include "INetStreamChannel.hpp"
 #include "CompressedPair.hpp"
 #include "Option.hpp"
+#include "Arena.hpp"
 
 namespace sharpen
 {
@@ -19,6 +22,7 @@ namespace sharpen
         _Request req_;
         Pair pair_;
         sharpen::Option<_Data> data_;
+        std::unique_ptr<sharpen::Arena> arena_;
     public:
         explicit RpcContext(sharpen::NetStreamChannelPtr conn)
             :RpcContext(std::move(conn),_Encoder{},_Decoder{})
@@ -33,6 +37,7 @@ namespace sharpen
             ,req_()
             ,pair_()
             ,data_()
+            ,arena_()
         {
             this->pair_.First() = std::move(encoder);
             this->pair_.Second() = std::move(decoder);
@@ -100,6 +105,27 @@ namespace sharpen
         {
             return this->data_;
         }
+
+        //created on first use
+        //reset before the next request is decoded
+        //objects allocated from it must not outlive the request
+        sharpen::Arena &RequestArena()
+        {
+            if (!this->arena_)
+            {
+                //only the fiber of the connection allocates
+                this->arena_.reset(new sharpen::Arena{4096,sharpen::ArenaMode::Exclusive});
+            }
+            return *this->arena_;
+        }
+
+        void ResetRequestArena() noexcept
+        {
+            if (this->arena_)
+            {
+                this->arena_->Reset();
+            }
+        }
     };
 
     template<typename _Encoder,typename _Request,typename _Decoder>
@@ -112,6 +138,7 @@ namespace sharpen
         sharpen::NetStreamChannelPtr conn_;
         _Request req_;
         Pair pair_;
+        std::unique_ptr<sharpen::Arena> arena_;
     public:
         explicit RpcContext(sharpen::NetStreamChannelPtr conn)
             :RpcContext(std::move(conn),_Encoder{},_Decoder{})
@@ -125,6 +152,7 @@ namespace sharpen
             :conn_(std::move(conn))
             ,req_()
             ,pair_()
+            ,arena_()
         {
             this->pair_.First() = std::move(encoder);
             this->pair_.Second() = std::move(decoder);
@@ -172,6 +200,27 @@ namespace sharpen
         {
             return this->pair_.Second();
         }
+
+        //created on first use
+        //reset before the next request is decoded
+        //objects allocated from it must not outlive the request
+        sharpen::Arena &RequestArena()
+        {
+            if (!this->arena_)
+            {
+                //only the fiber of the connection allocates
+                this->arena_.reset(new sharpen::Arena{4096,sharpen::ArenaMode::Exclusive});
+            }
+            return *this->arena_;
+        }
+
+        void ResetRequestArena() noexcept
+        {
+            if (this->arena_)
+            {
+                this->arena_->Reset();
+            }
+        }
     };
 }
 
@@ -32,6 +32,7 @@ namespace sharpen
     //_Encoder should has ByteBuffer Encode(_Response res) function
     //_Request should has void Clear() function
     //_Decoder should has size_t Decode(const char *data,size_t size) , bool IsCompleted() and void SetCompleted(bool completed) function
+    //size_t Decode(const BufferSlice &buf) is used instead if _Decoder has it
     //_Dispatcher should has std::string GetProcedureName(const _Request &req) function
     template<typename _Response,typename _Encoder,typename _Request,typename _Decoder,typename _Dispatcher,typename _Data>
     class InternalRpcServer<_Response,_Encoder,_Request,_Decoder,_Dispatcher,_Data,sharpen::EnableIf<sharpen::RpcServerRequires<_Response,_Encoder,_Request,_Decoder,_Dispatcher>::Value>>:public sharpen::TcpServer
@@ -84,7 +85,8 @@ namespace sharpen
         virtual void OnNewChannel(sharpen::NetStreamChannelPtr channel) override
         {
             Context ctx(std::move(channel),this->encoderBuilder_ ? this->encoderBuilder_():_Encoder{},this->decoderBuilder_? this->decoderBuilder_():_Decoder{});
-            sharpen::ByteBuffer buf{4096};
+            sharpen::BufferSlice buf{4096};
+            sharpen::Size mark{0};
             sharpen::TimerPtr timer;
             sharpen::AwaitableFuture<bool> timeout;
             sharpen::AwaitableFuture<sharpen::Size> future;
@@ -94,14 +96,20 @@ namespace sharpen
             }
             while (true)
             {
+                ctx.ResetRequestArena();
                 ctx.Request().Clear();
                 ctx.Decoder().SetCompleted(false);
                 sharpen::Size lastSize{0};
                 while (!ctx.Decoder().IsCompleted())
                 {                  
                     sharpen::Size size{0};
-                    if(buf.GetMark() == 0)
+                    if(mark == 0)
                     {
+                        //the last request may still share the block
+                        if(!buf.IsUnique())
+                        {
+                            buf = sharpen::BufferSlice{4096};
+                        }
                         future.Reset();
                         //timeout model
                         if(this->timeout_.HasValue())
@@ -112,7 +120,7 @@ namespace sharpen
                             timer->WaitAsync(timeout,this->timeout_.Get());
                             using FnPtr = void(*)(sharpen::Future<bool>&,sharpen::Future<sharpen::Size>*,Context*);
                             timeout.SetCallback(std::bind(static_cast<FnPtr>(&TimeoutCallback),std::placeholders::_1,&future,&ctx));
-                            ctx.Connection()->ReadAsync(buf,0,future);
+                            ctx.Connection()->ReadAsync(buf.Data(),buf.GetSize(),future);
                             try
                             {
                                 size = future.Await();
@@ -136,7 +144,7 @@ namespace sharpen
                         }
                         else
                         {
-                            ctx.Connection()->ReadAsync(buf,0,future);
+                            ctx.Connection()->ReadAsync(buf.Data(),buf.GetSize(),future);
                             size = future.Await();
                         }
                         if(size == 0)
@@ -147,16 +155,16 @@ namespace sharpen
                     }
                     else
                     {
-                        size = lastSize - buf.GetMark();
+                        size = lastSize - mark;
                     }
-                    sharpen::Size dSize = ctx.Decoder().Decode(buf.Data() + buf.GetMark(),size);
+                    sharpen::Size dSize = sharpen::RpcDecode(ctx.Decoder(),buf.Slice(mark,size));
                     if(dSize != size)
                     {
-                        buf.Mark(buf.GetMark() + dSize);
+                        mark += dSize;
                     }
                     else
                     {
-                        buf.Mark(0);
+                        mark = 0;
                     }
                 }
                 _Dispatcher &dispatcher = this->GetDispatcher();
@@ -0,0 +1,168 @@
+#pragma once
+#ifndef _SHARPEN_SHMSTREAMCHANNEL_HPP
+#define _SHARPEN_SHMSTREAMCHANNEL_HPP
+
+#include "SystemMacro.hpp"
+
+//memfd and eventfd are only supported by linux
+#ifdef SHARPEN_IS_LINUX
+
+#include <deque>
+#include <functional>
+
+#include "INetStreamChannel.hpp"
+#include "Noncopyable.hpp"
+#include "Nonmovable.hpp"
+#include "SystemError.hpp"
+
+#define SHARPEN_HAS_SHMSTREAMCHANNEL
+
+namespace sharpen
+{
+    //stream channel over two single producer single consumer rings in a memfd
+    //each side registers its own eventfd to the loop
+    //a side only writes the eventfd of the peer when the peer is waiting
+    //so a busy stream costs no syscalls
+    class ShmStreamChannel:public sharpen::INetStreamChannel,public sharpen::Noncopyable,public sharpen::Nonmovable
+    {
+    private:
+        using Mybase = sharpen::INetStreamChannel;
+        using Callback = std::function<void(ssize_t)>;
+
+        //shared by both sides
+        struct Ring;
+
+        struct ReadTask
+        {
+            char *buf_;
+            sharpen::Size size_;
+            Callback cb_;
+        };
+
+        struct WriteTask
+        {
+            const char *buf_;
+            sharpen::Size size_;
+            sharpen::Size written_;
+            Callback cb_;
+        };
+
+        void *mem_;
+        sharpen::Size memSize_;
+        Ring *input_;
+        Ring *output_;
+        char *inputData_;
+        char *outputData_;
+        sharpen::Size capacity_;
+        sharpen::FileHandle peerEvent_;
+        std::deque<ReadTask> reads_;
+        std::deque<WriteTask> writes_;
+        std::deque<Callback> pollReadCbs_;
+        std::deque<Callback> pollWriteCbs_;
+
+        void Notify() noexcept;
+
+        void Shutdown(sharpen::FileHandle handle) noexcept;
+
+        //bytes readable from the input ring
+        //mark this side waiting if there are none
+        //more than the capacity if the peer broke the ring
+        sharpen::Size WaitReadable() noexcept;
+
+        //bytes writable to the output ring
+        //mark this side waiting if there are none
+        //more than the capacity if the peer broke the ring
+        sharpen::Size WaitWritable() noexcept;
+
+        void DoRead();
+
+        void DoWrite();
+
+        void DoPoll();
+
+        void DoCancel(sharpen::ErrorCode err) noexcept;
+
+        void TryRead(char *buf,sharpen::Size bufSize,Callback cb);
+
+        void TryWrite(const char *buf,sharpen::Size bufSize,Callback cb);
+
+        void TryPollRead(Callback cb);
+
+        void TryPollWrite(Callback cb);
+
+        static void CompleteIoCallback(sharpen::IChannel *channel,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept;
+
+        static void CompletePollCallback(sharpen::IChannel *channel,sharpen::Future<void> *future,ssize_t size) noexcept;
+    public:
+        //the channel owns the mapping and both eventfds
+        //side 0 writes the first ring and reads the second one
+        //the capacity is taken from memSize which must be validated
+        ShmStreamChannel(void *mem,sharpen::Size memSize,sharpen::FileHandle event,sharpen::FileHandle peerEvent,sharpen::Size side) noexcept;
+
+        virtual ~ShmStreamChannel() noexcept;
+
+        using Mybase::WriteAsync;
+
+        using Mybase::ReadAsync;
+
+        using Mybase::SendFileAsync;
+
+        using Mybase::AcceptAsync;
+
+        using Mybase::ConnectAsync;
+
+        using Mybase::PollReadAsync;
+
+        using Mybase::PollWriteAsync;
+
+        virtual void WriteAsync(const sharpen::Char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> &future) override;
+
+        virtual void WriteAsync(const sharpen::ByteBuffer &buf,sharpen::Size bufferOffset,sharpen::Future<sharpen::Size> &future) override;
+
+        virtual void ReadAsync(sharpen::Char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> &future) override;
+
+        virtual void ReadAsync(sharpen::ByteBuffer &buf,sharpen::Size bufferOffset,sharpen::Future<sharpen::Size> &future) override;
+
+        //throw std::logic_error
+        virtual void SendFileAsync(sharpen::FileChannelPtr file,sharpen::Uint64 size,sharpen::Uint64 offset,sharpen::Future<void> &future) override;
+
+        //throw std::logic_error
+        virtual void SendFileAsync(sharpen::FileChannelPtr file,sharpen::Future<void> &future) override;
+
+        //throw std::logic_error
+        virtual void AcceptAsync(sharpen::Future<sharpen::NetStreamChannelPtr> &future) override;
+
+        //throw std::logic_error
+        virtual void ConnectAsync(const sharpen::IEndPoint &endpoint,sharpen::Future<void> &future) override;
+
+        //throw std::logic_error
+        virtual void Listen(sharpen::Uint16 queueLength) override;
+
+        virtual void PollReadAsync(sharpen::Future<void> &future) override;
+
+        virtual void PollWriteAsync(sharpen::Future<void> &future) override;
+
+        virtual void OnEvent(sharpen::IoEvent *event) override;
+
+        virtual void Cancel() noexcept override;
+
+        inline sharpen::Size GetCapacity() const noexcept
+        {
+            return this->capacity_;
+        }
+    };
+
+    //create both sides in this process
+    //capacity is rounded up to a power of two
+    void MakeShmStreamChannelPair(sharpen::Size capacity,sharpen::NetStreamChannelPtr &first,sharpen::NetStreamChannelPtr &second);
+
+    //create the rings and pass them to the peer over a registered unix domain stream channel
+    //the peer calls AcceptShmStreamChannel
+    sharpen::NetStreamChannelPtr ConnectShmStreamChannel(sharpen::INetStreamChannel &unixChannel,sharpen::Size capacity);
+
+    //receive the rings passed by ConnectShmStreamChannel
+    sharpen::NetStreamChannelPtr AcceptShmStreamChannel(sharpen::INetStreamChannel &unixChannel);
+}
+
+#endif
+#endif
@@ -0,0 +1,98 @@
+#pragma once
+#ifndef _SHARPEN_SIZECLASSALLOCATOR_HPP
+#define _SHARPEN_SIZECLASSALLOCATOR_HPP
+
+#include <new>
+#include <cstddef>
+
+#include "TypeDef.hpp"
+
+//larger blocks are allocated by operator new directly
+#ifndef SHARPEN_SIZE_CLASS_MAX
+#define SHARPEN_SIZE_CLASS_MAX 32768
+#endif
+
+//bytes a thread cache keeps per size class before giving objects back
+#ifndef SHARPEN_THREAD_CACHE_LIMIT
+#define SHARPEN_THREAD_CACHE_LIMIT 65536
+#endif
+
+namespace sharpen
+{
+    //small object allocator
+    //sizes are rounded up to one of the size classes
+    //16 byte steps up to 256 and 4 classes per power of 2 after that
+    //every thread caches free objects of every class
+    //and exchanges them in batches with a central transfer cache
+    //memory is never returned to the system
+    class SizeClassAllocator
+    {
+    public:
+        static constexpr sharpen::Size classCount_ = 44;
+
+        //alignment of every object
+        static constexpr sharpen::Size alignment_ = 16;
+
+        //size must not be greater than SHARPEN_SIZE_CLASS_MAX
+        static sharpen::Size GetClassIndex(sharpen::Size size) noexcept;
+
+        static sharpen::Size GetClassSize(sharpen::Size index) noexcept;
+
+        //objects of one batch moved between a thread and the central cache
+        static sharpen::Size GetBatchSize(sharpen::Size index) noexcept;
+
+        //the result is aligned to 16 bytes
+        static void *Allocate(sharpen::Size size);
+
+        //size must be the size passed to Allocate
+        static void Deallocate(void *p,sharpen::Size size) noexcept;
+
+        //over-aligned blocks are allocated by operator new directly
+        //alignment must be a power of 2
+        static void *Allocate(sharpen::Size size,sharpen::Size alignment);
+
+        //size and alignment must be the ones passed to Allocate
+        static void Deallocate(void *p,sharpen::Size size,sharpen::Size alignment) noexcept;
+
+        //give cached objects of this thread back to the central cache
+        static void FlushThreadCache() noexcept;
+    };
+
+    //stl allocator on top of SizeClassAllocator
+    template<typename _T>
+    class PoolAllocator
+    {
+    public:
+        using value_type = _T;
+
+        PoolAllocator() noexcept = default;
+
+        template<typename _U>
+        PoolAllocator(const sharpen::PoolAllocator<_U> &) noexcept
+        {}
+
+        _T *allocate(std::size_t n)
+        {
+            return reinterpret_cast<_T*>(sharpen::SizeClassAllocator::Allocate(n*sizeof(_T),alignof(_T)));
+        }
+
+        void deallocate(_T *p,std::size_t n) noexcept
+        {
+            sharpen::SizeClassAllocator::Deallocate(p,n*sizeof(_T),alignof(_T));
+        }
+    };
+
+    template<typename _T,typename _U>
+    inline bool operator==(const sharpen::PoolAllocator<_T> &,const sharpen::PoolAllocator<_U> &) noexcept
+    {
+        return true;
+    }
+
+    template<typename _T,typename _U>
+    inline bool operator!=(const sharpen::PoolAllocator<_T> &,const sharpen::PoolAllocator<_U> &) noexcept
+    {
+        return false;
+    }
+}
+
+#endif
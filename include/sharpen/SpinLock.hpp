@@ -6,21 +6,68 @@
 
 #include "Noncopyable.hpp"
 #include "Nonmovable.hpp"
+#include "TypeDef.hpp"
+
+//number of pause instructions to spend spinning before sleeping
+#ifndef SHARPEN_SPINLOCK_SPIN_LIMIT
+#define SHARPEN_SPINLOCK_SPIN_LIMIT 1024
+#endif
+
+//max number of pause instructions between two checks
+#ifndef SHARPEN_SPINLOCK_MAX_BACKOFF
+#define SHARPEN_SPINLOCK_MAX_BACKOFF 64
+#endif
+
+//SHARPEN_SPINLOCK_STATISTICS changes the layout of SpinLock
+//enable it by the cmake option so every target agrees
 
 namespace sharpen
 {
+    struct SpinLockStatistics
+    {
+        //times the lock was acquired
+        sharpen::Uint64 acquisitions_;
+        //times the lock was found held
+        sharpen::Uint64 contentions_;
+        //times a thread went to sleep on the lock
+        sharpen::Uint64 sleeps_;
+    };
 
+    //test-and-test-and-set lock with exponential backoff
+    //a thread which cannot get the lock after spinning sleeps on a futex
     class SpinLock:public sharpen::Noncopyable,public sharpen::Nonmovable
     {
     private:
-        using Flag = std::atomic_flag;
+        using Self = sharpen::SpinLock;
 
-        Flag flag_;
+        //0 - unlocked
+        //1 - locked
+        //2 - locked and there may be sleepers
+        std::atomic<sharpen::Uint32> state_;
+#ifdef SHARPEN_SPINLOCK_STATISTICS
+        std::atomic<sharpen::Uint64> acquisitions_;
+        std::atomic<sharpen::Uint64> contentions_;
+        std::atomic<sharpen::Uint64> sleeps_;
+#endif
+
+        void LockSlow();
+
+        void Wake() noexcept;
     public:
         SpinLock();
 
         //use by stl
-        void lock();
+        void lock()
+        {
+            sharpen::Uint32 expected{0};
+            if (!this->state_.compare_exchange_strong(expected,1,std::memory_order_acquire,std::memory_order_relaxed))
+            {
+                this->LockSlow();
+            }
+#ifdef SHARPEN_SPINLOCK_STATISTICS
+            this->acquisitions_.fetch_add(1,std::memory_order_relaxed);
+#endif
+        }
 
         inline void Lock()
         {
@@ -28,16 +75,44 @@ namespace sharpen
         }
 
         //use by stl
-        void unlock() noexcept;
+        bool try_lock() noexcept
+        {
+            sharpen::Uint32 expected{0};
+            if (this->state_.load(std::memory_order_relaxed) == 0 && this->state_.compare_exchange_strong(expected,1,std::memory_order_acquire,std::memory_order_relaxed))
+            {
+#ifdef SHARPEN_SPINLOCK_STATISTICS
+                this->acquisitions_.fetch_add(1,std::memory_order_relaxed);
+#endif
+                return true;
+            }
+            return false;
+        }
+
+        inline bool TryLock() noexcept
+        {
+            return this->try_lock();
+        }
+
+        //use by stl
+        void unlock() noexcept
+        {
+            if (this->state_.exchange(0,std::memory_order_release) == 2)
+            {
+                this->Wake();
+            }
+        }
 
         void Unlock() noexcept
         {
             this->unlock();
         }
 
+        //all zero if SHARPEN_SPINLOCK_STATISTICS is not defined
+        sharpen::SpinLockStatistics GetStatistics() const noexcept;
+
         ~SpinLock() = default;
     };
 
-} 
+}
 
-#endif
\ No newline at end of file
+#endif
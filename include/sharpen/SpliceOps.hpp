@@ -0,0 +1,21 @@
+#pragma once
+#ifndef _SHARPEN_SPLICEOPS_HPP
+#define _SHARPEN_SPLICEOPS_HPP
+
+#include "INetStreamChannel.hpp"
+
+namespace sharpen
+{
+    //move up to size bytes from one stream channel to another through a pipe
+    //the bytes never enter user space
+    //return less than size only if from reaches the end of stream
+    //throw std::logic_error if a channel does not support splice
+    sharpen::Size SpliceAsync(sharpen::INetStreamChannel &from,sharpen::INetStreamChannel &to,sharpen::Size size);
+
+    //forward both directions until both reach the end of stream
+    //the end of stream is forwarded by shutting down the write side of the peer
+    //if a direction fails both channels are cancelled and the error is rethrown
+    void ProxyAsync(sharpen::INetStreamChannel &a,sharpen::INetStreamChannel &b);
+}
+
+#endif
@@ -15,6 +15,8 @@ namespace sharpen
 
         sharpen::NetStreamChannelPtr listener_;
     public:
+        //AddressFamily::Unix listens on a unix domain socket
+        //the socket file is not removed
         explicit TcpAcceptor(sharpen::AddressFamily af,const sharpen::IEndPoint &endpoint,sharpen::EventEngine &engine);
 
         ~TcpAcceptor() noexcept = default;
@@ -32,6 +32,10 @@ namespace sharpen
 
         void Stop() noexcept;
 
+        //serve a registered channel which is not accepted by this server
+        //such as a shared memory channel
+        void ServeAsync(sharpen::NetStreamChannelPtr channel);
+
         inline void GetLocalEndPoint(sharpen::IEndPoint &endpoint) const
         {
             this->acceptor_.GetLocalEndPoint(endpoint);
@@ -0,0 +1,77 @@
+#pragma once
+#ifndef _SHARPEN_UNIXENDPOINT_HPP
+#define _SHARPEN_UNIXENDPOINT_HPP
+
+#include "SystemMacro.hpp"
+
+#ifdef SHARPEN_IS_NIX
+
+#include <string>
+#include <sys/un.h>
+
+#include "IEndPoint.hpp"
+#include "TypeDef.hpp"
+
+namespace sharpen
+{
+    //address of a unix domain socket
+    //a path in the file system or a name in the abstract namespace
+    class UnixEndPoint:public sharpen::IEndPoint
+    {
+    private:
+        using MyAddr = sockaddr_un;
+        using MyBase = sharpen::IEndPoint;
+        using Self = sharpen::UnixEndPoint;
+
+        MyAddr addr_;
+        sharpen::Uint32 len_;
+    public:
+        //an unnamed endpoint which can hold any address
+        UnixEndPoint() noexcept;
+
+        explicit UnixEndPoint(const char *path);
+
+        UnixEndPoint(const Self &other) = default;
+
+        UnixEndPoint(Self &&other) noexcept = default;
+
+        ~UnixEndPoint() noexcept = default;
+
+        Self &operator=(const Self &other) = default;
+
+        Self &operator=(Self &&other) noexcept = default;
+
+        bool operator==(const Self &other) const noexcept;
+
+        inline bool operator!=(const Self &other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+        virtual NativeAddr *GetAddrPtr() noexcept override;
+
+        virtual const NativeAddr *GetAddrPtr() const noexcept override;
+
+        virtual sharpen::Uint32 GetAddrLen() const override
+        {
+            return this->len_;
+        }
+
+        virtual void SetAddrLen(sharpen::Uint32 len) noexcept override;
+
+        //throw std::length_error if the path is too long
+        void SetPath(const char *path);
+
+        //the name may contain '\0'
+        //throw std::length_error if the name is too long
+        void SetAbstractName(const char *name,sharpen::Size size);
+
+        bool IsAbstract() const noexcept;
+
+        //the path or the abstract name
+        std::string GetPath() const;
+    };
+}
+
+#endif
+#endif
@@ -1,28 +1,53 @@
 #include <sharpen/Arena.hpp>
 
 #include <mutex>
+#include <new>
 
-sharpen::Arena::Arena(sharpen::Size blockSize)
-    :smallBlocks_(sharpen::Arena::AllocSmallBlock(blockSize + sizeof(*this->smallBlocks_)))
+namespace
+{
+    inline char *AlignUp(char *p,sharpen::Size alignment) noexcept
+    {
+        sharpen::Uintptr addr{reinterpret_cast<sharpen::Uintptr>(p)};
+        addr = (addr + alignment - 1) & ~static_cast<sharpen::Uintptr>(alignment - 1);
+        return reinterpret_cast<char*>(addr);
+    }
+}
+
+sharpen::Arena::Arena(sharpen::Size blockSize,sharpen::ArenaMode mode,sharpen::Size maxSmallSize)
+    :smallBlocks_(nullptr)
+    ,current_(nullptr)
     ,largeBlocks_(nullptr)
     ,lock_()
-{}
-
-sharpen::Arena::SmallBlock *sharpen::Arena::AllocSmallBlock(sharpen::Size size) noexcept
+    ,blockSize_(blockSize)
+    ,maxSmallSize_(maxSmallSize)
+    ,mode_(mode)
 {
-    if (size < sizeof(SmallBlock))
+    assert(blockSize >= 4*alignof(std::max_align_t));
+    assert(maxSmallSize <= blockSize);
+    this->smallBlocks_ = sharpen::Arena::AllocSmallBlock(blockSize);
+    if (!this->smallBlocks_)
     {
-        return nullptr;
+        throw std::bad_alloc();
     }
-    SmallBlock *sb = reinterpret_cast<SmallBlock*>(std::malloc(size));
+    this->current_ = this->smallBlocks_;
+}
+
+char *sharpen::Arena::GetBlockData(SmallBlock *block) noexcept
+{
+    return reinterpret_cast<char*>(block) + sharpen::Arena::GetBlockHeaderSize();
+}
+
+sharpen::Arena::SmallBlock *sharpen::Arena::AllocSmallBlock(sharpen::Size size) noexcept
+{
+    SmallBlock *sb = reinterpret_cast<SmallBlock*>(std::malloc(sharpen::Arena::GetBlockHeaderSize() + size));
     if (!sb)
     {
         return nullptr;
     }
-    char *byte = reinterpret_cast<char*>(sb);
+    char *data = sharpen::Arena::GetBlockData(sb);
     sb->next_ = nullptr;
-    new (&sb->curr_) std::atomic<char*>(byte + sizeof(*sb));
-    sb->end_ = byte + size;
+    new (&sb->curr_) std::atomic<char*>(data);
+    sb->end_ = data + size;
     return sb;
 }
 
@@ -36,60 +61,145 @@ sharpen::Arena::~Arena() noexcept
         std::free(sb);
         sb = tmp;   
     }
-    LargeBlock *lb = this->largeBlocks_;
-    while (lb != nullptr)
-    {
-        LargeBlock *tmp = lb->next_;
-        std::free(lb);
-        lb = tmp;
-    }
+    this->FreeLargeBlocks(nullptr);
 }
 
-void *sharpen::Arena::AllocSmall(sharpen::Size size) noexcept
+bool sharpen::Arena::NextBlock(SmallBlock *full) noexcept
 {
-    SmallBlock *sb = this->smallBlocks_;
-    char *curr = sb->curr_.load();
-    do
+    std::unique_lock<sharpen::SpinLock> lock(this->lock_,std::defer_lock);
+    if (this->mode_ == sharpen::ArenaMode::Shared)
     {
-        sharpen::Size remain = sb->end_ - curr;
-        if (remain < size)
+        lock.lock();
+        //another thread has switched the block
+        if (this->current_.load(std::memory_order_relaxed) != full)
         {
-            curr = nullptr;
-            break;
+            return true;
         }
-    } while (!sb->curr_.compare_exchange_weak(curr,curr + size));
-    if (curr)
+    }
+    SmallBlock *next = full->next_;
+    if (next)
     {
-        return curr;
+        //reuse a block kept by Reset or Rewind
+        next->curr_.store(sharpen::Arena::GetBlockData(next),std::memory_order_relaxed);
     }
+    else
     {
-        std::unique_lock<sharpen::SpinLock> lock(this->lock_);
-        sb = sharpen::Arena::AllocSmallBlock(maxAlloc_ + sizeof(*sb));
-        if (!sb)
+        next = sharpen::Arena::AllocSmallBlock(this->blockSize_);
+        if (!next)
+        {
+            return false;
+        }
+        full->next_ = next;
+    }
+    this->current_.store(next,std::memory_order_release);
+    return true;
+}
+
+void *sharpen::Arena::AllocSmall(sharpen::Size size,sharpen::Size alignment) noexcept
+{
+    while (true)
+    {
+        SmallBlock *sb = this->current_.load(std::memory_order_acquire);
+        char *curr = sb->curr_.load(std::memory_order_relaxed);
+        char *p;
+        if (this->mode_ == sharpen::ArenaMode::Exclusive)
+        {
+            p = AlignUp(curr,alignment);
+            if (p <= sb->end_ && static_cast<sharpen::Size>(sb->end_ - p) >= size)
+            {
+                sb->curr_.store(p + size,std::memory_order_relaxed);
+                return p;
+            }
+        }
+        else
+        {
+            do
+            {
+                p = AlignUp(curr,alignment);
+                if (p > sb->end_ || static_cast<sharpen::Size>(sb->end_ - p) < size)
+                {
+                    p = nullptr;
+                    break;
+                }
+            } while (!sb->curr_.compare_exchange_weak(curr,p + size,std::memory_order_relaxed));
+            if (p)
+            {
+                return p;
+            }
+        }
+        if (!this->NextBlock(sb))
         {
             return nullptr;
         }
-        sb->next_ = this->smallBlocks_;
-        curr = sb->curr_;
-        sb->curr_ += size;
-        this->smallBlocks_ = sb;
     }
-    return curr;
 }
 
-void *sharpen::Arena::AllocLarge(sharpen::Size size) noexcept
+void *sharpen::Arena::AllocLarge(sharpen::Size size,sharpen::Size alignment) noexcept
 {
-    LargeBlock *lb = reinterpret_cast<LargeBlock*>(std::malloc(sizeof(*lb) + size));
+    if (size > std::numeric_limits<sharpen::Size>::max() - sizeof(LargeBlock) - alignment)
+    {
+        return nullptr;
+    }
+    LargeBlock *lb = reinterpret_cast<LargeBlock*>(std::malloc(sizeof(*lb) + alignment + size));
     if (!lb)
     {
         return nullptr;
     }
-    LargeBlock *first = this->largeBlocks_;
+    char *p = AlignUp(reinterpret_cast<char*>(lb) + sizeof(*lb),alignment);
+    if (this->mode_ == sharpen::ArenaMode::Exclusive)
+    {
+        lb->next_ = this->largeBlocks_.load(std::memory_order_relaxed);
+        this->largeBlocks_.store(lb,std::memory_order_relaxed);
+        return p;
+    }
+    LargeBlock *first = this->largeBlocks_.load(std::memory_order_relaxed);
     do
     {
         lb->next_ = first;
-    } while (this->largeBlocks_.compare_exchange_weak(first,lb));
-    char *byte = reinterpret_cast<char*>(lb);
-    byte += sizeof(*lb);
-    return byte;
-}
\ No newline at end of file
+    } while (!this->largeBlocks_.compare_exchange_weak(first,lb,std::memory_order_release,std::memory_order_relaxed));
+    return p;
+}
+
+void sharpen::Arena::FreeLargeBlocks(LargeBlock *until) noexcept
+{
+    LargeBlock *lb = this->largeBlocks_.load(std::memory_order_acquire);
+    while (lb != until)
+    {
+        assert(lb);
+        LargeBlock *tmp = lb->next_;
+        std::free(lb);
+        lb = tmp;
+    }
+    this->largeBlocks_.store(until,std::memory_order_relaxed);
+}
+
+void sharpen::Arena::Reset() noexcept
+{
+    this->FreeLargeBlocks(nullptr);
+    SmallBlock *sb = this->smallBlocks_;
+    while (sb != nullptr)
+    {
+        sb->curr_.store(sharpen::Arena::GetBlockData(sb),std::memory_order_relaxed);
+        sb = sb->next_;
+    }
+    this->current_.store(this->smallBlocks_,std::memory_order_release);
+}
+
+sharpen::ArenaSavepoint sharpen::Arena::Save() const noexcept
+{
+    sharpen::ArenaSavepoint point;
+    SmallBlock *sb = this->current_.load(std::memory_order_acquire);
+    point.block_ = sb;
+    point.curr_ = sb->curr_.load(std::memory_order_relaxed);
+    point.largeBlocks_ = this->largeBlocks_.load(std::memory_order_acquire);
+    return point;
+}
+
+void sharpen::Arena::Rewind(const sharpen::ArenaSavepoint &point) noexcept
+{
+    this->FreeLargeBlocks(reinterpret_cast<LargeBlock*>(point.largeBlocks_));
+    SmallBlock *sb = reinterpret_cast<SmallBlock*>(point.block_);
+    //blocks after sb are reset when they are reused
+    sb->curr_.store(point.curr_,std::memory_order_relaxed);
+    this->current_.store(sb,std::memory_order_release);
+}
@@ -5,20 +5,21 @@ sharpen::AsyncBarrier::AsyncBarrier(sharpen::Uint64 counter)
     :counter_(counter)
     ,waiters_()
     ,beginCounter_(counter)
+    ,lock_()
 {}
 
 void sharpen::AsyncBarrier::WaitAsync()
 {
-    sharpen::AsyncBarrier::MyFuture future;
+    Waiter waiter;
     {
         std::unique_lock<sharpen::SpinLock> lock(this->lock_);
         if (this->counter_ == 0)
         {
             return;
         }
-        this->waiters_.push_back(&future);
+        this->waiters_.Push(&waiter);
     }
-    future.Await();
+    waiter.future_.Await();
 }
 
 void sharpen::AsyncBarrier::Reset()
@@ -29,17 +30,17 @@ void sharpen::AsyncBarrier::Reset()
 
 void sharpen::AsyncBarrier::Notice() noexcept
 {
-    sharpen::AsyncBarrier::MyFuturePtr futurePtr;
+    Waiter *chain;
     {
         std::unique_lock<sharpen::SpinLock> lock(this->lock_);
         assert(this->counter_ != 0);
         this->counter_ -= 1;
-        if(this->counter_ != 0 || this->waiters_.empty())
+        if(this->counter_ != 0)
         {
             return;
         }
-        futurePtr = this->waiters_.front();
-        this->waiters_.pop_front();
+        //release every waiter
+        chain = this->waiters_.PopAll();
     }
-    futurePtr->Complete();
+    WaiterQueue::CompleteChain(chain);
 }
@@ -1,14 +1,36 @@
 #include <sharpen/AsyncMutex.hpp>
 
+#include <sharpen/CpuRelax.hpp>
+
 sharpen::AsyncMutex::AsyncMutex()
     :locked_(false)
     ,waiters_()
     ,lock_()
 {}
 
+bool sharpen::AsyncMutex::TryLock() noexcept
+{
+    std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+    if (this->locked_)
+    {
+        return false;
+    }
+    this->locked_ = true;
+    return true;
+}
+
 void sharpen::AsyncMutex::LockAsync()
 {
-    sharpen::AsyncMutex::MyFuture future;
+    //spin a little before parking
+    for (sharpen::Size i = 0; i != SHARPEN_ASYNC_SPIN_COUNT; ++i)
+    {
+        if (!this->locked_.load(std::memory_order_relaxed) && this->TryLock())
+        {
+            return;
+        }
+        sharpen::CpuRelax();
+    }
+    Waiter waiter;
     {
         std::unique_lock<sharpen::SpinLock> lock(this->lock_);
         if (!this->locked_)
@@ -16,21 +38,24 @@ void sharpen::AsyncMutex::LockAsync()
             this->locked_ = true;
             return;
         }
-        this->waiters_.push_back(&future);
+        this->waiters_.Push(&waiter);
     }
-    future.Await();
+    waiter.future_.Await();
 }
 
 void sharpen::AsyncMutex::Unlock() noexcept
 {
-    std::unique_lock<sharpen::SpinLock> lock(this->lock_);
-    if (this->waiters_.empty())
+    Waiter *waiter;
     {
-        this->locked_ = false;
-        return;
+        std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+        waiter = this->waiters_.Pop();
+        if (!waiter)
+        {
+            this->locked_ = false;
+            return;
+        }
     }
-    sharpen::AsyncMutex::MyFuturePtr futurePtr = this->waiters_.front();
-    this->waiters_.pop_front();
-    lock.unlock();
-    futurePtr->Complete();
+    //locked_ stays true
+    //the waiter owns the mutex now
+    WaiterQueue::CompleteChain(waiter);
 }
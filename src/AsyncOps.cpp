@@ -1,62 +1,224 @@
 #include <sharpen/AsyncOps.hpp>
 
-//[begin,end)
-void sharpen::ParallelFor(sharpen::Size begin,sharpen::Size end,sharpen::Size grainsSize,std::function<void(sharpen::Size)> fn)
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace
 {
-    if (begin >= end)
-    {
-        return;
-    }
-    sharpen::Size parallelNumber{sharpen::EventEngine::GetEngine().LoopNumber()};
-    //compute max grainsSize
-    sharpen::Size max {end - begin};
-    max /= parallelNumber;
-    if(max > grainsSize)
+    //unclaimed part of the range owned by a worker
+    struct ParallelSlot
     {
-        max = grainsSize;
-    }
-    //init iterator
-    std::atomic_size_t ite{begin};
-    //init future
-    sharpen::AwaitableFuture<void> future;
-    std::atomic_size_t comp{parallelNumber};
-    //launch fiber
-    for (sharpen::Size i = 0; i < parallelNumber; i++)
+        sharpen::SpinLock lock_;
+        sharpen::Size begin_;
+        sharpen::Size end_;
+        //keep slots on different cache lines
+        char padding_[64];
+    };
+
+    struct ParallelJob
     {
-        sharpen::Launch([&ite,max,end,parallelNumber,&fn,&comp,&future]()
+        std::unique_ptr<ParallelSlot[]> slots_;
+        sharpen::Size slotCount_;
+        sharpen::Size grainsSize_;
+        std::function<void(sharpen::Size,sharpen::Size)> fn_;
+        //items which are not finished
+        std::atomic_size_t pending_;
+        std::atomic_bool failed_;
+        sharpen::SpinLock errorLock_;
+        std::exception_ptr error_;
+        sharpen::AwaitableFuture<void> future_;
+
+        //claim a chunk from the front of our own range
+        bool Take(sharpen::Size index,sharpen::Size &begin,sharpen::Size &end) noexcept
         {
-            while(true)
+            ParallelSlot &slot = this->slots_[index];
+            std::unique_lock<sharpen::SpinLock> lock(slot.lock_);
+            if (slot.begin_ == slot.end_)
             {
-                sharpen::Size iterator = ite.load();
-                sharpen::Size size{0};
-                //get size
-                do
+                return false;
+            }
+            begin = slot.begin_;
+            end = slot.end_;
+            if (end - begin > this->grainsSize_)
+            {
+                end = begin + this->grainsSize_;
+            }
+            slot.begin_ = end;
+            return true;
+        }
+
+        //move the back half of another worker's range to our own
+        //a single item is taken as a whole
+        //or a caller could wait for a task which never runs
+        bool Steal(sharpen::Size index) noexcept
+        {
+            for (sharpen::Size i = 1; i != this->slotCount_; ++i)
+            {
+                ParallelSlot &victim = this->slots_[(index + i) % this->slotCount_];
+                sharpen::Size begin;
+                sharpen::Size end;
                 {
-                    assert(end >= iterator);
-                    size = end - iterator;
-                    if(size > max)
+                    std::unique_lock<sharpen::SpinLock> lock(victim.lock_);
+                    sharpen::Size size{victim.end_ - victim.begin_};
+                    if (size == 0)
                     {
-                        size = max;
+                        continue;
                     }
-                } while (!ite.compare_exchange_weak(iterator,iterator + size));
-                if (!size)
+                    begin = victim.begin_ + size/2;
+                    end = victim.end_;
+                    victim.end_ = begin;
+                }
+                ParallelSlot &slot = this->slots_[index];
+                std::unique_lock<sharpen::SpinLock> lock(slot.lock_);
+                assert(slot.begin_ == slot.end_);
+                slot.begin_ = begin;
+                slot.end_ = end;
+                return true;
+            }
+            return false;
+        }
+
+        void Fail(std::exception_ptr error) noexcept
+        {
+            std::unique_lock<sharpen::SpinLock> lock(this->errorLock_);
+            if (!this->error_)
+            {
+                this->error_ = std::move(error);
+            }
+            this->failed_ = true;
+        }
+    };
+
+    void RunParallelWorker(std::shared_ptr<ParallelJob> job,sharpen::Size index)
+    {
+        while (true)
+        {
+            sharpen::Size begin;
+            sharpen::Size end;
+            if (!job->Take(index,begin,end))
+            {
+                if (!job->Steal(index))
                 {
-                    sharpen::Size copy = comp.fetch_sub(1);
-                    copy -= 1;
-                    if (copy == 0)
-                    {
-                        future.Complete();
-                    }
                     return;
                 }
-                //execute function
-                for (sharpen::Size i = 0; i < size; i++)
+                continue;
+            }
+            //skip the rest after a failure
+            if (!job->failed_.load(std::memory_order_relaxed))
+            {
+                try
+                {
+                    job->fn_(begin,end);
+                }
+                catch(...)
                 {
-                    assert(fn);
-                    fn(i + iterator);
+                    job->Fail(std::current_exception());
                 }
             }
+            sharpen::Size size{end - begin};
+            if (job->pending_.fetch_sub(size) == size)
+            {
+                job->future_.Complete();
+            }
+        }
+    }
+}
+
+void sharpen::InternalParallelFor(const sharpen::ParallelExecutor &executor,sharpen::Size begin,sharpen::Size end,sharpen::Size grainsSize,std::function<void(sharpen::Size,sharpen::Size)> fn)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+    assert(fn);
+    if (grainsSize == 0)
+    {
+        grainsSize = 1;
+    }
+    sharpen::Size parallelNumber{executor.GetParallelNumber()};
+    bool help{executor.CallerShouldHelp()};
+    sharpen::Size launchNumber{parallelNumber};
+    sharpen::Size slotCount{parallelNumber};
+    if (help)
+    {
+        if (executor.GetPool())
+        {
+            slotCount += 1;
+        }
+        else
+        {
+            //the caller takes the place of one event loop
+            launchNumber -= 1;
+        }
+    }
+    std::shared_ptr<ParallelJob> job = std::make_shared<ParallelJob>();
+    job->slots_.reset(new ParallelSlot[slotCount]);
+    job->slotCount_ = slotCount;
+    job->grainsSize_ = grainsSize;
+    job->fn_ = std::move(fn);
+    job->pending_ = end - begin;
+    job->failed_ = false;
+    //split the range evenly
+    //idle workers steal from the others later
+    sharpen::Size size{(end - begin)/slotCount};
+    sharpen::Size remain{(end - begin)%slotCount};
+    for (sharpen::Size i = 0; i != slotCount; ++i)
+    {
+        ParallelSlot &slot = job->slots_[i];
+        slot.begin_ = begin;
+        begin += size;
+        if (i < remain)
+        {
+            begin += 1;
+        }
+        slot.end_ = begin;
+    }
+    assert(begin == end);
+    sharpen::Size first{help ? 1u:0u};
+    for (sharpen::Size i = 0; i != launchNumber; ++i)
+    {
+        sharpen::Size index{first + i};
+        executor.Launch([job,index]()
+        {
+            RunParallelWorker(job,index);
         });
     }
-    future.Await();
-}
\ No newline at end of file
+    if (help)
+    {
+        RunParallelWorker(job,0);
+    }
+    job->future_.Await();
+    if (job->error_)
+    {
+        std::rethrow_exception(job->error_);
+    }
+}
+
+sharpen::Size sharpen::InternalParallelBlockSize(const sharpen::ParallelExecutor &executor,sharpen::Size count,sharpen::Size grainsSize)
+{
+    //several blocks per worker let stealing balance the load
+    sharpen::Size blocks{executor.GetParallelNumber()*8};
+    sharpen::Size size{(count + blocks - 1)/blocks};
+    if (size < grainsSize)
+    {
+        size = grainsSize;
+    }
+    if (size == 0)
+    {
+        size = 1;
+    }
+    return size;
+}
+
+void sharpen::ParallelFor(const sharpen::ParallelExecutor &executor,sharpen::Size begin,sharpen::Size end,sharpen::Size grainsSize,std::function<void(sharpen::Size)> fn)
+{
+    assert(fn);
+    sharpen::InternalParallelFor(executor,begin,end,grainsSize,[&fn](sharpen::Size begin,sharpen::Size end)
+    {
+        for (; begin != end; ++begin)
+        {
+            fn(begin);
+        }
+    });
+}
@@ -11,7 +11,7 @@ sharpen::AsyncReadWriteLock::AsyncReadWriteLock()
 
 void sharpen::AsyncReadWriteLock::LockReadAsync()
 {
-    sharpen::AsyncReadWriteLock::MyFuture future;
+    Waiter waiter;
     {
         std::unique_lock<sharpen::SpinLock> lock(this->lock_);
         if (this->state_ != sharpen::ReadWriteLockState::UniquedWriting)
@@ -20,14 +20,14 @@ void sharpen::AsyncReadWriteLock::LockReadAsync()
             this->state_ = sharpen::ReadWriteLockState::SharedReading;
             return;
         }
-        this->readWaiters_.push_back(&future);
+        this->readWaiters_.Push(&waiter);
     }
-    future.Await();
+    waiter.future_.Await();
 }
 
 void sharpen::AsyncReadWriteLock::LockWriteAsync()
 {
-    sharpen::AsyncReadWriteLock::MyFuture future;
+    Waiter waiter;
     {
         std::unique_lock<sharpen::SpinLock> lock(this->lock_);
         if (this->state_ == sharpen::ReadWriteLockState::Free)
@@ -35,57 +35,57 @@ void sharpen::AsyncReadWriteLock::LockWriteAsync()
             this->state_ = sharpen::ReadWriteLockState::UniquedWriting;
             return;
         }
-        this->writeWaiters_.push_back(&future);	
+        this->writeWaiters_.Push(&waiter);
     }
-    future.Await();
+    waiter.future_.Await();
 }
 
 void sharpen::AsyncReadWriteLock::WriteUnlock() noexcept
 {
-    std::unique_lock<sharpen::SpinLock> lock(this->lock_);
-    if (!this->writeWaiters_.empty())
+    Waiter *chain;
     {
-        sharpen::AsyncReadWriteLock::MyFuturePtr futurePtr = this->writeWaiters_.front();
-        this->writeWaiters_.pop_front();
-        this->state_ = sharpen::ReadWriteLockState::UniquedWriting;
-        lock.unlock();
-        futurePtr->Complete();
-        return;
-    }
-    else if (!this->readWaiters_.empty())
-    {
-        sharpen::AsyncReadWriteLock::List list;
-        std::swap(list,this->readWaiters_);
-        this->readers_ = static_cast<sharpen::Uint32>(list.size());
-        this->state_ = sharpen::ReadWriteLockState::SharedReading;
-        lock.unlock();
-        for (auto begin = std::begin(list),end = std::end(list);begin != end;++begin)
+        std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+        if (!this->writeWaiters_.Empty())
+        {
+            //hand off to next writer
+            chain = this->writeWaiters_.Pop();
+            this->state_ = sharpen::ReadWriteLockState::UniquedWriting;
+        }
+        else if (!this->readWaiters_.Empty())
+        {
+            //hand off to all readers
+            this->readers_ = static_cast<sharpen::Uint32>(this->readWaiters_.GetSize());
+            chain = this->readWaiters_.PopAll();
+            this->state_ = sharpen::ReadWriteLockState::SharedReading;
+        }
+        else
         {
-            (*begin)->Complete();
+            this->state_ = sharpen::ReadWriteLockState::Free;
+            return;
         }
-        return;
     }
-    this->state_ = sharpen::ReadWriteLockState::Free;
+    WaiterQueue::CompleteChain(chain);
 }
 
 void sharpen::AsyncReadWriteLock::ReadUnlock() noexcept
 {
-    std::unique_lock<sharpen::SpinLock> lock(this->lock_);
-    this->readers_ -= 1;
-    if (this->readers_ != 0)
-    {
-        return;
-    }
-    if (!this->writeWaiters_.empty())
+    Waiter *waiter;
     {
-        sharpen::AsyncReadWriteLock::MyFuturePtr futurePtr = this->writeWaiters_.front();
-        this->writeWaiters_.pop_front();
+        std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+        this->readers_ -= 1;
+        if (this->readers_ != 0)
+        {
+            return;
+        }
+        waiter = this->writeWaiters_.Pop();
+        if (!waiter)
+        {
+            this->state_ = sharpen::ReadWriteLockState::Free;
+            return;
+        }
         this->state_ = sharpen::ReadWriteLockState::UniquedWriting;
-        lock.unlock();
-        futurePtr->Complete();
-        return;
     }
-    this->state_ = sharpen::ReadWriteLockState::Free;
+    WaiterQueue::CompleteChain(waiter);
 }
 
 void sharpen::AsyncReadWriteLock::Unlock() noexcept
@@ -1,14 +1,36 @@
 #include <sharpen/AsyncSemaphore.hpp>
 
+#include <sharpen/CpuRelax.hpp>
+
 sharpen::AsyncSemaphore::AsyncSemaphore(sharpen::Uint32 count)
     :waiters_()
     ,lock_()
     ,counter_(count)
 {}
 
+bool sharpen::AsyncSemaphore::TryLock() noexcept
+{
+    std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+    if (this->NeedWait())
+    {
+        return false;
+    }
+    this->counter_ -= 1;
+    return true;
+}
+
 void sharpen::AsyncSemaphore::LockAsync()
 {
-    sharpen::AsyncSemaphore::MyFuture future;
+    //spin a little before parking
+    for (sharpen::Size i = 0; i != SHARPEN_ASYNC_SPIN_COUNT; ++i)
+    {
+        if (this->counter_.load(std::memory_order_relaxed) != 0 && this->TryLock())
+        {
+            return;
+        }
+        sharpen::CpuRelax();
+    }
+    Waiter waiter;
     {
         std::unique_lock<sharpen::SpinLock> lock(this->lock_);
         if (!this->NeedWait())
@@ -16,9 +38,9 @@ void sharpen::AsyncSemaphore::LockAsync()
             this->counter_ -= 1;
             return;
         }
-        this->waiters_.push_back(&future);
+        this->waiters_.Push(&waiter);
     }
-    future.Await();
+    waiter.future_.Await();
 }
 
 bool sharpen::AsyncSemaphore::NeedWait() const
@@ -28,53 +50,20 @@ bool sharpen::AsyncSemaphore::NeedWait() const
 
 void sharpen::AsyncSemaphore::Unlock() noexcept
 {
-    std::unique_lock<sharpen::SpinLock> lock(this->lock_);
-    if (this->waiters_.empty())
-    {
-        this->counter_ += 1;
-        return;
-    }
-    sharpen::AsyncSemaphore::MyFuturePtr futurePtr = this->waiters_.front();
-    this->waiters_.pop_front();
-    lock.unlock();
-    futurePtr->Complete();
+    this->Unlock(1);
 }
 
 void sharpen::AsyncSemaphore::Unlock(sharpen::Uint32 count) noexcept
 {
-    std::unique_lock<sharpen::SpinLock> lock(this->lock_);
-    if (this->waiters_.empty())
-    {
-        this->counter_ += count;
-        return;
-    }
-    if(count >= this->waiters_.size())
-    {
-        sharpen::AsyncSemaphore::List futures;
-        this->waiters_.swap(futures);
-        this->counter_ += static_cast<sharpen::Uint32>(count - this->waiters_.size());
-        lock.unlock();
-        for(auto begin = futures.begin(),end = futures.end();begin != end; ++begin)
-        {
-            (*begin)->Complete();
-        }
-    }
-    else
+    Waiter *chain;
     {
-        auto begin = this->waiters_.begin();
-        auto end = begin;
-        for(;count != 0;--count)
-        {
-            ++end;
-        }
-        sharpen::AsyncSemaphore::List futures(std::make_move_iterator(begin),std::make_move_iterator(end));
-        lock.unlock();
-        begin = futures.begin();
-        end = futures.end();
-        while(begin != end)
+        std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+        sharpen::Size size = this->waiters_.GetSize();
+        chain = this->waiters_.Pop(count);
+        if (size < count)
         {
-            (*begin)->Complete();
-            ++begin;
+            this->counter_ += static_cast<sharpen::Uint32>(count - size);
         }
     }
+    WaiterQueue::CompleteChain(chain);
 }
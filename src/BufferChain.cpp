@@ -0,0 +1,190 @@
+#include <sharpen/BufferChain.hpp>
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include <sharpen/ByteBuffer.hpp>
+
+sharpen::BufferChain::BufferChain()
+    :segments_()
+    ,size_(0)
+{}
+
+sharpen::BufferChain::BufferChain(Self &&other)
+    :segments_(std::move(other.segments_))
+    ,size_(other.size_)
+{
+    other.size_ = 0;
+}
+
+sharpen::BufferChain &sharpen::BufferChain::operator=(Self &&other) noexcept
+{
+    if (this != std::addressof(other))
+    {
+        this->segments_ = std::move(other.segments_);
+        this->size_ = other.size_;
+        other.segments_.clear();
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+void sharpen::BufferChain::Swap(Self &other) noexcept
+{
+    std::swap(this->segments_,other.segments_);
+    std::swap(this->size_,other.size_);
+}
+
+void sharpen::BufferChain::Append(sharpen::BufferSlice slice)
+{
+    if (slice.Empty())
+    {
+        return;
+    }
+    this->size_ += slice.GetSize();
+    this->segments_.emplace_back(std::move(slice));
+}
+
+void sharpen::BufferChain::Append(const sharpen::Char *data,sharpen::Size size)
+{
+    if (size)
+    {
+        this->Append(sharpen::BufferSlice{data,size});
+    }
+}
+
+void sharpen::BufferChain::Append(const sharpen::ByteBuffer &buf)
+{
+    this->Append(buf.Data(),buf.GetSize());
+}
+
+void sharpen::BufferChain::Append(Self other)
+{
+    if (this->segments_.empty())
+    {
+        this->Swap(other);
+        return;
+    }
+    for (auto begin = other.segments_.begin(),end = other.segments_.end(); begin != end; ++begin)
+    {
+        this->segments_.emplace_back(std::move(*begin));
+    }
+    this->size_ += other.size_;
+}
+
+void sharpen::BufferChain::Prepend(sharpen::BufferSlice slice)
+{
+    if (slice.Empty())
+    {
+        return;
+    }
+    this->size_ += slice.GetSize();
+    this->segments_.emplace_front(std::move(slice));
+}
+
+void sharpen::BufferChain::Prepend(const sharpen::Char *data,sharpen::Size size)
+{
+    if (size)
+    {
+        this->Prepend(sharpen::BufferSlice{data,size});
+    }
+}
+
+const sharpen::BufferSlice &sharpen::BufferChain::GetSegment(sharpen::Size index) const
+{
+    return this->segments_.at(index);
+}
+
+sharpen::Char sharpen::BufferChain::Get(sharpen::Size index) const
+{
+    if (index >= this->size_)
+    {
+        throw std::out_of_range("index out of range");
+    }
+    for (auto begin = this->segments_.begin(),end = this->segments_.end(); begin != end; ++begin)
+    {
+        if (index < begin->GetSize())
+        {
+            return (*begin)[index];
+        }
+        index -= begin->GetSize();
+    }
+    //unreachable
+    throw std::out_of_range("index out of range");
+}
+
+void sharpen::BufferChain::Consume(sharpen::Size size)
+{
+    if (size > this->size_)
+    {
+        throw std::out_of_range("consume out of range");
+    }
+    this->size_ -= size;
+    while (size)
+    {
+        sharpen::BufferSlice &front = this->segments_.front();
+        if (size < front.GetSize())
+        {
+            front = front.Slice(size);
+            return;
+        }
+        size -= front.GetSize();
+        this->segments_.pop_front();
+    }
+}
+
+sharpen::BufferChain sharpen::BufferChain::Split(sharpen::Size size)
+{
+    if (size > this->size_)
+    {
+        throw std::out_of_range("split out of range");
+    }
+    Self head;
+    while (size)
+    {
+        sharpen::BufferSlice &front = this->segments_.front();
+        if (size < front.GetSize())
+        {
+            head.Append(front.Slice(0,size));
+            front = front.Slice(size);
+            this->size_ -= size;
+            break;
+        }
+        size -= front.GetSize();
+        this->size_ -= front.GetSize();
+        head.Append(std::move(front));
+        this->segments_.pop_front();
+    }
+    return head;
+}
+
+sharpen::Size sharpen::BufferChain::CopyTo(sharpen::Char *buf,sharpen::Size size) const
+{
+    sharpen::Size copied{0};
+    for (auto begin = this->segments_.begin(),end = this->segments_.end(); begin != end && copied != size; ++begin)
+    {
+        sharpen::Size sz{begin->GetSize()};
+        if (sz > size - copied)
+        {
+            sz = size - copied;
+        }
+        std::memcpy(buf + copied,begin->Data(),sz);
+        copied += sz;
+    }
+    return copied;
+}
+
+sharpen::ByteBuffer sharpen::BufferChain::Flatten() const
+{
+    sharpen::ByteBuffer buf;
+    buf.ExtendUninitialized(this->size_);
+    this->CopyTo(buf.Data(),this->size_);
+    return buf;
+}
+
+void sharpen::BufferChain::Clear() noexcept
+{
+    this->segments_.clear();
+    this->size_ = 0;
+}
@@ -0,0 +1,207 @@
+#include <sharpen/BufferSlice.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+#include <sharpen/ByteBuffer.hpp>
+#include <sharpen/SizeClassAllocator.hpp>
+
+namespace
+{
+    //keep the data aligned to 16 bytes
+    constexpr sharpen::Size blockHeaderSize{32};
+}
+
+sharpen::BufferSlice::Block *sharpen::BufferSlice::AllocBlock(sharpen::Size size)
+{
+    static_assert(sizeof(Block) <= blockHeaderSize,"block header is too large");
+    void *mem = sharpen::SizeClassAllocator::Allocate(blockHeaderSize + size);
+    Block *block = new (mem) Block();
+    block->ref_.store(1,std::memory_order_relaxed);
+    block->capacity_ = size;
+    return block;
+}
+
+sharpen::Char *sharpen::BufferSlice::GetBlockData(Block *block) noexcept
+{
+    return reinterpret_cast<sharpen::Char*>(block) + blockHeaderSize;
+}
+
+void sharpen::BufferSlice::Release() noexcept
+{
+    if (!this->block_)
+    {
+        return;
+    }
+    if (this->block_->ref_.fetch_sub(1,std::memory_order_acq_rel) == 1)
+    {
+        sharpen::Size capacity{this->block_->capacity_};
+        this->block_->~Block();
+        sharpen::SizeClassAllocator::Deallocate(this->block_,blockHeaderSize + capacity);
+    }
+    this->block_ = nullptr;
+    this->offset_ = 0;
+    this->size_ = 0;
+}
+
+sharpen::BufferSlice::BufferSlice() noexcept
+    :block_(nullptr)
+    ,offset_(0)
+    ,size_(0)
+{}
+
+sharpen::BufferSlice::BufferSlice(sharpen::Size size)
+    :block_(nullptr)
+    ,offset_(0)
+    ,size_(size)
+{
+    if (size)
+    {
+        this->block_ = Self::AllocBlock(size);
+    }
+}
+
+sharpen::BufferSlice::BufferSlice(const sharpen::Char *p,sharpen::Size size)
+    :BufferSlice(size)
+{
+    if (size)
+    {
+        std::memcpy(this->Data(),p,size);
+    }
+}
+
+sharpen::BufferSlice::BufferSlice(const sharpen::ByteBuffer &buf)
+    :BufferSlice(buf.Data(),buf.GetSize())
+{}
+
+sharpen::BufferSlice::BufferSlice(const Self &other) noexcept
+    :block_(other.block_)
+    ,offset_(other.offset_)
+    ,size_(other.size_)
+{
+    if (this->block_)
+    {
+        this->block_->ref_.fetch_add(1,std::memory_order_relaxed);
+    }
+}
+
+sharpen::BufferSlice::BufferSlice(Self &&other) noexcept
+    :block_(other.block_)
+    ,offset_(other.offset_)
+    ,size_(other.size_)
+{
+    other.block_ = nullptr;
+    other.offset_ = 0;
+    other.size_ = 0;
+}
+
+sharpen::BufferSlice &sharpen::BufferSlice::operator=(const Self &other) noexcept
+{
+    if (this != std::addressof(other))
+    {
+        Self tmp{other};
+        this->Swap(tmp);
+    }
+    return *this;
+}
+
+sharpen::BufferSlice &sharpen::BufferSlice::operator=(Self &&other) noexcept
+{
+    if (this != std::addressof(other))
+    {
+        this->Release();
+        this->Swap(other);
+    }
+    return *this;
+}
+
+sharpen::BufferSlice::~BufferSlice() noexcept
+{
+    this->Release();
+}
+
+void sharpen::BufferSlice::Swap(Self &other) noexcept
+{
+    std::swap(this->block_,other.block_);
+    std::swap(this->offset_,other.offset_);
+    std::swap(this->size_,other.size_);
+}
+
+const sharpen::Char *sharpen::BufferSlice::Data() const noexcept
+{
+    if (!this->block_)
+    {
+        return nullptr;
+    }
+    return Self::GetBlockData(this->block_) + this->offset_;
+}
+
+sharpen::Char *sharpen::BufferSlice::Data() noexcept
+{
+    if (!this->block_)
+    {
+        return nullptr;
+    }
+    return Self::GetBlockData(this->block_) + this->offset_;
+}
+
+sharpen::Char sharpen::BufferSlice::Get(sharpen::Size index) const
+{
+    if (index >= this->size_)
+    {
+        throw std::out_of_range("index out of range");
+    }
+    return this->Data()[index];
+}
+
+sharpen::Char &sharpen::BufferSlice::Get(sharpen::Size index)
+{
+    if (index >= this->size_)
+    {
+        throw std::out_of_range("index out of range");
+    }
+    return this->Data()[index];
+}
+
+sharpen::BufferSlice sharpen::BufferSlice::Slice(sharpen::Size offset,sharpen::Size size) const
+{
+    if (offset > this->size_ || size > this->size_ - offset)
+    {
+        throw std::out_of_range("slice out of range");
+    }
+    Self slice;
+    if (size)
+    {
+        slice = *this;
+        slice.offset_ += offset;
+        slice.size_ = size;
+    }
+    return slice;
+}
+
+bool sharpen::BufferSlice::IsUnique() const noexcept
+{
+    return this->GetRefCount() <= 1;
+}
+
+sharpen::Size sharpen::BufferSlice::GetRefCount() const noexcept
+{
+    if (!this->block_)
+    {
+        return 0;
+    }
+    return this->block_->ref_.load(std::memory_order_acquire);
+}
+
+sharpen::ByteBuffer sharpen::BufferSlice::ToByteBuffer() const
+{
+    return sharpen::ByteBuffer{this->Data(),this->size_};
+}
+
+void sharpen::BufferSlice::Clear() noexcept
+{
+    this->Release();
+}
@@ -0,0 +1,240 @@
+#include <sharpen/BufferedStreamReader.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+sharpen::BufferedStreamReader::BufferedStreamReader(sharpen::NetStreamChannelPtr channel)
+    :BufferedStreamReader(std::move(channel),SHARPEN_STREAM_READER_WINDOW_SIZE,SHARPEN_STREAM_READER_MAX_WINDOW_SIZE)
+{}
+
+sharpen::BufferedStreamReader::BufferedStreamReader(sharpen::NetStreamChannelPtr channel,sharpen::Size windowSize,sharpen::Size maxWindowSize)
+    :channel_(std::move(channel))
+    ,window_()
+    ,begin_(0)
+    ,end_(0)
+    ,maxWindowSize_(maxWindowSize)
+    ,eof_(false)
+{
+    assert(windowSize != 0 && windowSize <= maxWindowSize);
+    this->window_.ExtendToUninitialized(windowSize);
+}
+
+void sharpen::BufferedStreamReader::Reserve()
+{
+    if (this->end_ != this->window_.GetSize())
+    {
+        return;
+    }
+    if (this->begin_ == this->end_)
+    {
+        this->begin_ = 0;
+        this->end_ = 0;
+        return;
+    }
+    //compact if at least half of the window is free
+    if (this->begin_ >= this->window_.GetSize()/2)
+    {
+        std::memmove(this->window_.Data(),this->window_.Data() + this->begin_,this->end_ - this->begin_);
+        this->end_ -= this->begin_;
+        this->begin_ = 0;
+        return;
+    }
+    sharpen::Size size{this->window_.GetSize()*2};
+    if (size > this->maxWindowSize_)
+    {
+        size = this->maxWindowSize_;
+    }
+    if (size == this->window_.GetSize())
+    {
+        if (this->begin_ == 0)
+        {
+            throw std::length_error("receive window is full");
+        }
+        std::memmove(this->window_.Data(),this->window_.Data() + this->begin_,this->end_ - this->begin_);
+        this->end_ -= this->begin_;
+        this->begin_ = 0;
+        return;
+    }
+    this->window_.ExtendToUninitialized(size);
+}
+
+sharpen::Size sharpen::BufferedStreamReader::FillAsync()
+{
+    if (this->eof_)
+    {
+        return 0;
+    }
+    this->Reserve();
+    sharpen::Size size{this->channel_->ReadAsync(this->window_.Data() + this->end_,this->window_.GetSize() - this->end_)};
+    if (size == 0)
+    {
+        this->eof_ = true;
+    }
+    this->end_ += size;
+    return size;
+}
+
+sharpen::Size sharpen::BufferedStreamReader::LocateAsync(const sharpen::Char *delim,sharpen::Size delimSize)
+{
+    assert(delimSize != 0);
+    //bytes before this offset were scanned already
+    sharpen::Size scanned{0};
+    while (true)
+    {
+        const sharpen::Char *begin = this->BufferBegin() + scanned;
+        const sharpen::Char *r = sharpen::ScanPattern(begin,this->BufferEnd(),delim,delimSize);
+        if (r != this->BufferEnd())
+        {
+            return static_cast<sharpen::Size>(r - this->BufferBegin()) + delimSize;
+        }
+        //a delimiter may cross the end of the window
+        sharpen::Size size{this->GetBufferedSize()};
+        scanned = size >= delimSize ? size - delimSize + 1:0;
+        if (this->FillAsync() == 0)
+        {
+            return 0;
+        }
+    }
+}
+
+sharpen::Size sharpen::BufferedStreamReader::ReadUntilAsync(sharpen::ByteBuffer &buf,const sharpen::Char *delim,sharpen::Size delimSize)
+{
+    sharpen::Size size{this->LocateAsync(delim,delimSize)};
+    if (size == 0)
+    {
+        size = this->GetBufferedSize();
+    }
+    buf.Append(this->BufferBegin(),size);
+    this->Consume(size);
+    return size;
+}
+
+sharpen::Size sharpen::BufferedStreamReader::ReadUntilAsync(sharpen::ByteBuffer &buf,sharpen::Char delim)
+{
+    return this->ReadUntilAsync(buf,&delim,1);
+}
+
+bool sharpen::BufferedStreamReader::ReadLineAsync(sharpen::ByteBuffer &line)
+{
+    sharpen::Size size{this->LocateAsync("\n",1)};
+    sharpen::Size consumed{size};
+    if (size == 0)
+    {
+        size = this->GetBufferedSize();
+        consumed = size;
+        if (size == 0)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        size -= 1;
+        if (size != 0 && this->BufferBegin()[size - 1] == '\r')
+        {
+            size -= 1;
+        }
+    }
+    line.Append(this->BufferBegin(),size);
+    this->Consume(consumed);
+    return true;
+}
+
+sharpen::Size sharpen::BufferedStreamReader::ReadAsync(sharpen::Char *buf,sharpen::Size size)
+{
+    if (size == 0)
+    {
+        return 0;
+    }
+    if (this->begin_ == this->end_)
+    {
+        if (this->eof_)
+        {
+            return 0;
+        }
+        //read directly into a large buffer
+        if (size >= this->window_.GetSize())
+        {
+            sharpen::Size sz{this->channel_->ReadAsync(buf,size)};
+            if (sz == 0)
+            {
+                this->eof_ = true;
+            }
+            return sz;
+        }
+        if (this->FillAsync() == 0)
+        {
+            return 0;
+        }
+    }
+    sharpen::Size sz{this->GetBufferedSize()};
+    if (sz > size)
+    {
+        sz = size;
+    }
+    std::memcpy(buf,this->BufferBegin(),sz);
+    this->Consume(sz);
+    return sz;
+}
+
+sharpen::Size sharpen::BufferedStreamReader::ReadExactAsync(sharpen::Char *buf,sharpen::Size size)
+{
+    sharpen::Size count{0};
+    while (count != size)
+    {
+        sharpen::Size sz{this->ReadAsync(buf + count,size - count)};
+        if (sz == 0)
+        {
+            break;
+        }
+        count += sz;
+    }
+    return count;
+}
+
+sharpen::Size sharpen::BufferedStreamReader::ReadExactAsync(sharpen::ByteBuffer &buf,sharpen::Size size)
+{
+    sharpen::Size oldSize{buf.GetSize()};
+    buf.ExtendUninitialized(size);
+    sharpen::Size count{this->ReadExactAsync(buf.Data() + oldSize,size)};
+    buf.ExtendToUninitialized(oldSize + count);
+    return count;
+}
+
+sharpen::ByteSpan sharpen::BufferedStreamReader::PeekAsync(sharpen::Size size)
+{
+    if (size > this->maxWindowSize_)
+    {
+        throw std::length_error("peek size is greater than the max window size");
+    }
+    while (this->GetBufferedSize() < size)
+    {
+        //move the buffered bytes to the front if size does not fit
+        if (this->window_.GetSize() - this->begin_ < size && this->begin_ != 0)
+        {
+            std::memmove(this->window_.Data(),this->window_.Data() + this->begin_,this->end_ - this->begin_);
+            this->end_ -= this->begin_;
+            this->begin_ = 0;
+        }
+        if (this->FillAsync() == 0)
+        {
+            break;
+        }
+    }
+    return sharpen::ByteSpan{this->BufferBegin(),this->GetBufferedSize()};
+}
+
+void sharpen::BufferedStreamReader::Consume(sharpen::Size size)
+{
+    if (size > this->GetBufferedSize())
+    {
+        throw std::out_of_range("consume more than buffered bytes");
+    }
+    this->begin_ += size;
+    if (this->begin_ == this->end_)
+    {
+        this->begin_ = 0;
+        this->end_ = 0;
+    }
+}
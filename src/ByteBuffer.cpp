@@ -1,56 +1,118 @@
 #include <sharpen/ByteBuffer.hpp>
 
+#include <cassert>
+#include <cstdlib>
 #include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include <sharpen/ByteScan.hpp>
 
 void sharpen::ByteBuffer::swap(sharpen::ByteBuffer &other) noexcept
 {
-    vector_.swap(other.vector_);
-    mark_ = other.mark_;
+    if (this != std::addressof(other))
+    {
+        sharpen::ByteBuffer tmp{std::move(other)};
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
 }
 
 sharpen::ByteBuffer::ByteBuffer()
-    :vector_()
+    :data_(inline_)
+    ,size_(0)
+    ,capacity_(SHARPEN_BYTEBUFFER_INLINE_SIZE)
     ,mark_(0)
 {}
 
 sharpen::ByteBuffer::ByteBuffer(sharpen::Size size)
-    :vector_(size)
-    ,mark_(0)
-{}
+    :ByteBuffer()
+{
+    this->ExtendTo(size);
+}
 
-sharpen::ByteBuffer::ByteBuffer(Vector &&vector) noexcept
-    :vector_(std::move(vector))
-    ,mark_(0)
-{}
+sharpen::ByteBuffer::ByteBuffer(Vector &&vector)
+    :ByteBuffer(vector.data(),vector.size())
+{
+    vector.clear();
+}
 
 sharpen::ByteBuffer::ByteBuffer(const sharpen::Char *p,sharpen::Size size)
-    :vector_()
-    ,mark_(0)
+    :ByteBuffer()
 {
-    for (size_t i = 0; i < size; i++)
-    {
-        this->vector_.push_back(p[i]);
-    }
+    this->Append(p,size);
 }
 
 sharpen::ByteBuffer::ByteBuffer(const sharpen::ByteBuffer &other)
-    :vector_(other.vector_)
-    ,mark_(other.mark_)
-{}
+    :ByteBuffer(other.Data(),other.GetSize())
+{
+    this->mark_ = other.mark_;
+}
 
 sharpen::ByteBuffer::ByteBuffer(sharpen::ByteBuffer &&other) noexcept
-    :vector_(std::move(other.vector_))
-    ,mark_(other.mark_)
+    :ByteBuffer()
+{
+    *this = std::move(other);
+}
+
+sharpen::ByteBuffer::~ByteBuffer() noexcept
+{
+    this->FreeHeap();
+}
+
+void sharpen::ByteBuffer::FreeHeap() noexcept
 {
-    other.mark_ = 0;
+    if (!this->IsInline())
+    {
+        std::free(this->data_);
+        this->data_ = this->inline_;
+        this->capacity_ = SHARPEN_BYTEBUFFER_INLINE_SIZE;
+    }
+}
+
+void sharpen::ByteBuffer::Grow(sharpen::Size size)
+{
+    if (size <= this->capacity_)
+    {
+        return;
+    }
+    sharpen::Size capacity{this->capacity_*2};
+    if (capacity < size)
+    {
+        capacity = size;
+    }
+    sharpen::Char *data;
+    if (this->IsInline())
+    {
+        data = reinterpret_cast<sharpen::Char*>(std::malloc(capacity));
+        if (data && this->size_)
+        {
+            std::memcpy(data,this->inline_,this->size_);
+        }
+    }
+    else
+    {
+        data = reinterpret_cast<sharpen::Char*>(std::realloc(this->data_,capacity));
+    }
+    if (!data)
+    {
+        throw std::bad_alloc();
+    }
+    this->data_ = data;
+    this->capacity_ = capacity;
 }
 
 sharpen::ByteBuffer &sharpen::ByteBuffer::operator=(const sharpen::ByteBuffer &other)
 {
     if(this != std::addressof(other))
     {
-        sharpen::ByteBuffer tmp{other};
-        std::swap(tmp,*this);
+        this->Grow(other.size_);
+        if (other.size_)
+        {
+            std::memcpy(this->data_,other.data_,other.size_);
+        }
+        this->size_ = other.size_;
+        this->mark_ = other.mark_;
     }
     return *this;
 }
@@ -59,8 +121,22 @@ sharpen::ByteBuffer &sharpen::ByteBuffer::operator=(sharpen::ByteBuffer &&other)
 {
     if(this != std::addressof(other))
     {
-        this->vector_ = std::move(other.vector_);
+        this->FreeHeap();
+        if (other.IsInline())
+        {
+            std::memcpy(this->inline_,other.inline_,other.size_);
+        }
+        else
+        {
+            //steal the heap block
+            this->data_ = other.data_;
+            this->capacity_ = other.capacity_;
+            other.data_ = other.inline_;
+            other.capacity_ = SHARPEN_BYTEBUFFER_INLINE_SIZE;
+        }
+        this->size_ = other.size_;
         this->mark_ = other.mark_;
+        other.size_ = 0;
         other.mark_ = 0;
     }
     return *this;
@@ -68,76 +144,95 @@ sharpen::ByteBuffer &sharpen::ByteBuffer::operator=(sharpen::ByteBuffer &&other)
 
 void sharpen::ByteBuffer::PushBack(sharpen::Char val)
 {
-    this->vector_.push_back(val);
+    if (this->size_ == this->capacity_)
+    {
+        this->Grow(this->size_ + 1);
+    }
+    this->data_[this->size_++] = val;
 }
 
 sharpen::Size sharpen::ByteBuffer::GetSize() const
 {
-    return this->vector_.size();
+    return this->size_;
 }
 
 void sharpen::ByteBuffer::CheckAndMoveMark()
 {
-    if (this->mark_ > this->vector_.size())
+    if (this->mark_ > this->size_)
     {
-        this->mark_ = this->vector_.size();
+        this->mark_ = this->size_;
     }
 }
 
 void sharpen::ByteBuffer::PopBack()
 {
-    this->vector_.pop_back();
+    assert(this->size_ != 0);
+    this->size_ -= 1;
     this->CheckAndMoveMark();
 }
 
 sharpen::Char sharpen::ByteBuffer::Back() const
 {
-    return this->vector_.back();
+    assert(this->size_ != 0);
+    return this->data_[this->size_ - 1];
 }
 
 sharpen::Char &sharpen::ByteBuffer::Back()
 {
-    return this->vector_.back();
+    assert(this->size_ != 0);
+    return this->data_[this->size_ - 1];
 }
 
 sharpen::Char sharpen::ByteBuffer::Front() const
 {
-    return this->vector_.front();
+    assert(this->size_ != 0);
+    return this->data_[0];
 }
 
 sharpen::Char &sharpen::ByteBuffer::Front()
 {
-    return this->vector_.front();
+    assert(this->size_ != 0);
+    return this->data_[0];
 }
 
 sharpen::Char sharpen::ByteBuffer::Get(sharpen::Size index) const
 {
-    return this->vector_.at(index);
+    if (index >= this->size_)
+    {
+        throw std::out_of_range("index out of range");
+    }
+    return this->data_[index];
 }
 
 sharpen::Char &sharpen::ByteBuffer::Get(sharpen::Size index)
 {
-    return this->vector_.at(index);
+    if (index >= this->size_)
+    {
+        throw std::out_of_range("index out of range");
+    }
+    return this->data_[index];
 }
 
 const sharpen::Char *sharpen::ByteBuffer::Data() const
 {
-    return this->vector_.data();
+    return this->data_;
 }
 
 sharpen::Char *sharpen::ByteBuffer::Data()
 {
-    return reinterpret_cast<sharpen::Char*>(this->vector_.data());
+    return this->data_;
 }
 
 void sharpen::ByteBuffer::Reserve(sharpen::Size size)
 {
-    this->vector_.reserve(size);
+    this->Grow(size);
 }
 
 void sharpen::ByteBuffer::Extend(sharpen::Size size,sharpen::Char defaultValue)
 {
-    this->vector_.resize(this->GetSize() + size,defaultValue);
+    sharpen::Size oldSize{this->size_};
+    this->ExtendUninitialized(size);
+    std::memset(this->data_ + oldSize,defaultValue,size);
 }
 
 void sharpen::ByteBuffer::Extend(sharpen::Size size)
@@ -147,7 +242,14 @@ void sharpen::ByteBuffer::Extend(sharpen::Size size)
 
 void sharpen::ByteBuffer::ExtendTo(sharpen::Size size,sharpen::Char defaultValue)
 {
-    this->vector_.resize(size,defaultValue);
+    if (size <= this->size_)
+    {
+        //same as std::vector::resize
+        this->size_ = size;
+        this->CheckAndMoveMark();
+        return;
+    }
+    this->Extend(size - this->size_,defaultValue);
 }
 
 void sharpen::ByteBuffer::ExtendTo(sharpen::Size size)
@@ -155,15 +257,58 @@ void sharpen::ByteBuffer::ExtendTo(sharpen::Size size)
     this->ExtendTo(size,0);
 }
 
+void sharpen::ByteBuffer::ExtendUninitialized(sharpen::Size size)
+{
+    if (size > this->capacity_ - this->size_)
+    {
+        this->Grow(this->size_ + size);
+    }
+    this->size_ += size;
+}
+
+void sharpen::ByteBuffer::ExtendToUninitialized(sharpen::Size size)
+{
+    if (size <= this->size_)
+    {
+        this->size_ = size;
+        this->CheckAndMoveMark();
+        return;
+    }
+    this->ExtendUninitialized(size - this->size_);
+}
+
 void sharpen::ByteBuffer::Reset()
 {
-    std::memset(this->vector_.data(),0,this->vector_.size());
+    if (this->size_)
+    {
+        std::memset(this->data_,0,this->size_);
+    }
 }
 
 void sharpen::ByteBuffer::Shrink()
 {
-    this->vector_.shrink_to_fit();
-    this->CheckAndMoveMark();
+    if (this->IsInline() || this->size_ == this->capacity_)
+    {
+        return;
+    }
+    if (this->size_ <= SHARPEN_BYTEBUFFER_INLINE_SIZE)
+    {
+        sharpen::Char *data = this->data_;
+        if (this->size_)
+        {
+            std::memcpy(this->inline_,data,this->size_);
+        }
+        std::free(data);
+        this->data_ = this->inline_;
+        this->capacity_ = SHARPEN_BYTEBUFFER_INLINE_SIZE;
+        return;
+    }
+    sharpen::Char *data = reinterpret_cast<sharpen::Char*>(std::realloc(this->data_,this->size_));
+    if (data)
+    {
+        this->data_ = data;
+        this->capacity_ = this->size_;
+    }
 }
 
 void sharpen::ByteBuffer::Append(const sharpen::Char *p,sharpen::Size size)
@@ -172,10 +317,9 @@ void sharpen::ByteBuffer::Append(const sharpen::Char *p,sharpen::Size size)
     {
         return;
     }
-    for (size_t i = 0; i < size; i++)
-    {
-        this->PushBack(p[i]);
-    }
+    sharpen::Size oldSize{this->size_};
+    this->ExtendUninitialized(size);
+    std::memcpy(this->data_ + oldSize,p,size);
 }
 
 void sharpen::ByteBuffer::Append(const sharpen::ByteBuffer &other)
@@ -185,14 +329,14 @@ void sharpen::ByteBuffer::Append(const sharpen::ByteBuffer &other)
 
 void sharpen::ByteBuffer::Erase(sharpen::Size pos)
 {
-    this->vector_.erase(this->vector_.begin() + pos);
-    this->CheckAndMoveMark();
+    this->Erase(pos,pos + 1);
 }
 
 void sharpen::ByteBuffer::Erase(sharpen::Size begin,sharpen::Size end)
 {
-    auto ite = this->vector_.begin();
-    this->vector_.erase(ite + begin,ite + end);
+    assert(begin <= end && end <= this->size_);
+    std::memmove(this->data_ + begin,this->data_ + end,this->size_ - end);
+    this->size_ -= end - begin;
     this->CheckAndMoveMark();
 }
 
@@ -214,58 +358,63 @@ sharpen::Size sharpen::ByteBuffer::GetMark() const
 
 sharpen::ByteBuffer::Iterator sharpen::ByteBuffer::Find(char e)
 {
-    for (auto begin = this->Begin(); begin != this->End(); begin++)
-    {
-        if (*begin == e)
-        {
-            return begin;
-        }
-    }
-    return this->End();
+    return const_cast<Iterator>(sharpen::ScanByte(this->Begin(),this->End(),e));
 }
 
 sharpen::ByteBuffer::ConstIterator sharpen::ByteBuffer::Find(char e) const
 {
-    for (auto begin = this->Begin(); begin != this->End(); begin++)
-    {
-        if (*begin == e)
-        {
-            return begin;
-        }
-    }
-    return this->End();
+    return sharpen::ScanByte(this->Begin(),this->End(),e);
 }
 
 sharpen::ByteBuffer::ReverseIterator sharpen::ByteBuffer::ReverseFind(char e)
 {
-    for (auto begin = this->ReverseBegin(); begin != this->ReverseEnd(); begin++)
+    Iterator ite = const_cast<Iterator>(sharpen::ReverseScanByte(this->Begin(),this->End(),e));
+    if (ite == this->End())
     {
-        if (*begin == e)
-        {
-            return begin;
-        }
+        return this->ReverseEnd();
     }
-    return this->ReverseEnd();
+    return ReverseIterator(ite + 1);
 }
 
 sharpen::ByteBuffer::ConstReverseIterator sharpen::ByteBuffer::ReverseFind(char e) const
 {
-    for (auto begin = this->ReverseBegin(); begin != this->ReverseEnd(); begin++)
+    ConstIterator ite = sharpen::ReverseScanByte(this->Begin(),this->End(),e);
+    if (ite == this->End())
     {
-        if (*begin == e)
-        {
-            return begin;
-        }
+        return this->ReverseEnd();
     }
-    return this->ReverseEnd();
+    return ConstReverseIterator(ite + 1);
+}
+
+sharpen::ByteBuffer::Iterator sharpen::ByteBuffer::FindAnyOf(const sharpen::Char *set,sharpen::Size setSize)
+{
+    return const_cast<Iterator>(sharpen::ScanAnyOf(this->Begin(),this->End(),set,setSize));
+}
+
+sharpen::ByteBuffer::ConstIterator sharpen::ByteBuffer::FindAnyOf(const sharpen::Char *set,sharpen::Size setSize) const
+{
+    return sharpen::ScanAnyOf(this->Begin(),this->End(),set,setSize);
+}
+
+sharpen::ByteBuffer::Iterator sharpen::ByteBuffer::Search(const sharpen::Char *pattern,sharpen::Size patternSize)
+{
+    return const_cast<Iterator>(sharpen::ScanPattern(this->Begin(),this->End(),pattern,patternSize));
+}
+
+sharpen::ByteBuffer::ConstIterator sharpen::ByteBuffer::Search(const sharpen::Char *pattern,sharpen::Size patternSize) const
+{
+    return sharpen::ScanPattern(this->Begin(),this->End(),pattern,patternSize);
 }
 
 void sharpen::ByteBuffer::Erase(ConstIterator where)
 {
-    this->vector_.erase(where);
+    sharpen::Size pos{static_cast<sharpen::Size>(where - this->Begin())};
+    this->Erase(pos);
 }
 
 void sharpen::ByteBuffer::Erase(ConstIterator begin,ConstIterator end)
 {
-    this->vector_.erase(begin,end);
-}
\ No newline at end of file
+    sharpen::Size first{static_cast<sharpen::Size>(begin - this->Begin())};
+    sharpen::Size last{static_cast<sharpen::Size>(end - this->Begin())};
+    this->Erase(first,last);
+}
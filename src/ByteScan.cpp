@@ -0,0 +1,316 @@
+#include <sharpen/ByteScan.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#include <sharpen/CompilerInfo.hpp>
+
+#if (defined (__x86_64__)) || (defined (_M_X64)) || ((defined (__i386__)) && (defined (__SSE2__)))
+#define SHARPEN_BYTESCAN_SSE2
+#include <emmintrin.h>
+//gcc and clang compile avx2 functions with the target attribute
+//they are used only if the cpu supports avx2
+#if (defined (SHARPEN_COMPILER_GCC)) || (defined (SHARPEN_COMPILER_CLANG))
+#define SHARPEN_BYTESCAN_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#ifdef SHARPEN_COMPILER_MSVC
+#include <intrin.h>
+#endif
+
+namespace
+{
+    using ScanByteFn = const sharpen::Char *(*)(const sharpen::Char *,const sharpen::Char *,sharpen::Char);
+    using ScanAnyOfFn = const sharpen::Char *(*)(const sharpen::Char *,const sharpen::Char *,const sharpen::Char *,sharpen::Size);
+    using ScanPatternFn = const sharpen::Char *(*)(const sharpen::Char *,const sharpen::Char *,const sharpen::Char *,sharpen::Size);
+
+    struct ScanTable
+    {
+        ScanByteFn reverseScanByte_;
+        ScanAnyOfFn scanAnyOf_;
+        ScanPatternFn scanPattern_;
+        const char *name_;
+    };
+
+    //largest set searched with vector compares
+    constexpr sharpen::Size maxVectorSetSize{16};
+
+    const sharpen::Char *ScalarReverseScanByte(const sharpen::Char *begin,const sharpen::Char *end,sharpen::Char c)
+    {
+        const sharpen::Char *ite = end;
+        while (ite != begin)
+        {
+            --ite;
+            if (*ite == c)
+            {
+                return ite;
+            }
+        }
+        return end;
+    }
+
+    const sharpen::Char *ScalarScanAnyOf(const sharpen::Char *begin,const sharpen::Char *end,const sharpen::Char *set,sharpen::Size setSize)
+    {
+        bool table[256] = {};
+        for (sharpen::Size i = 0; i != setSize; ++i)
+        {
+            table[static_cast<unsigned char>(set[i])] = true;
+        }
+        for (; begin != end; ++begin)
+        {
+            if (table[static_cast<unsigned char>(*begin)])
+            {
+                return begin;
+            }
+        }
+        return end;
+    }
+
+    const sharpen::Char *ScalarScanPattern(const sharpen::Char *begin,const sharpen::Char *end,const sharpen::Char *pattern,sharpen::Size patternSize)
+    {
+        return std::search(begin,end,pattern,pattern + patternSize);
+    }
+
+#ifdef SHARPEN_BYTESCAN_SSE2
+    inline unsigned CountTrailingZeros(unsigned mask) noexcept
+    {
+#ifdef SHARPEN_COMPILER_MSVC
+        unsigned long index;
+        _BitScanForward(&index,mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    inline unsigned HighestBit(unsigned mask) noexcept
+    {
+#ifdef SHARPEN_COMPILER_MSVC
+        unsigned long index;
+        _BitScanReverse(&index,mask);
+        return static_cast<unsigned>(index);
+#else
+        return 31u - static_cast<unsigned>(__builtin_clz(mask));
+#endif
+    }
+
+    const sharpen::Char *Sse2ReverseScanByte(const sharpen::Char *begin,const sharpen::Char *end,sharpen::Char c)
+    {
+        const __m128i needle = _mm_set1_epi8(c);
+        const sharpen::Char *ite = end;
+        while (ite - begin >= 16)
+        {
+            ite -= 16;
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ite));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block,needle)));
+            if (mask)
+            {
+                return ite + HighestBit(mask);
+            }
+        }
+        const sharpen::Char *r = ScalarReverseScanByte(begin,ite,c);
+        return r != ite ? r:end;
+    }
+
+    const sharpen::Char *Sse2ScanAnyOf(const sharpen::Char *begin,const sharpen::Char *end,const sharpen::Char *set,sharpen::Size setSize)
+    {
+        if (setSize == 0)
+        {
+            return end;
+        }
+        if (setSize > maxVectorSetSize)
+        {
+            return ScalarScanAnyOf(begin,end,set,setSize);
+        }
+        __m128i needles[maxVectorSetSize];
+        for (sharpen::Size i = 0; i != setSize; ++i)
+        {
+            needles[i] = _mm_set1_epi8(set[i]);
+        }
+        for (; end - begin >= 16; begin += 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            __m128i acc = _mm_cmpeq_epi8(block,needles[0]);
+            for (sharpen::Size i = 1; i != setSize; ++i)
+            {
+                acc = _mm_or_si128(acc,_mm_cmpeq_epi8(block,needles[i]));
+            }
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(acc));
+            if (mask)
+            {
+                return begin + CountTrailingZeros(mask);
+            }
+        }
+        return ScalarScanAnyOf(begin,end,set,setSize);
+    }
+
+    //compare the first and the last byte of the pattern at 16 positions at once
+    //then verify the candidates with memcmp
+    const sharpen::Char *Sse2ScanPattern(const sharpen::Char *begin,const sharpen::Char *end,const sharpen::Char *pattern,sharpen::Size patternSize)
+    {
+        const __m128i first = _mm_set1_epi8(pattern[0]);
+        const __m128i last = _mm_set1_epi8(pattern[patternSize - 1]);
+        for (; static_cast<sharpen::Size>(end - begin) >= patternSize + 15; begin += 16)
+        {
+            __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin + patternSize - 1));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst,first),_mm_cmpeq_epi8(blockLast,last))));
+            while (mask)
+            {
+                unsigned bit{CountTrailingZeros(mask)};
+                if (std::memcmp(begin + bit + 1,pattern + 1,patternSize - 2) == 0)
+                {
+                    return begin + bit;
+                }
+                mask &= mask - 1;
+            }
+        }
+        return ScalarScanPattern(begin,end,pattern,patternSize);
+    }
+#endif
+
+#ifdef SHARPEN_BYTESCAN_AVX2
+    __attribute__((target("avx2"))) const sharpen::Char *Avx2ReverseScanByte(const sharpen::Char *begin,const sharpen::Char *end,sharpen::Char c)
+    {
+        const __m256i needle = _mm256_set1_epi8(c);
+        const sharpen::Char *ite = end;
+        while (ite - begin >= 32)
+        {
+            ite -= 32;
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ite));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block,needle)));
+            if (mask)
+            {
+                return ite + HighestBit(mask);
+            }
+        }
+        const sharpen::Char *r = Sse2ReverseScanByte(begin,ite,c);
+        return r != ite ? r:end;
+    }
+
+    __attribute__((target("avx2"))) const sharpen::Char *Avx2ScanAnyOf(const sharpen::Char *begin,const sharpen::Char *end,const sharpen::Char *set,sharpen::Size setSize)
+    {
+        if (setSize == 0)
+        {
+            return end;
+        }
+        if (setSize > maxVectorSetSize)
+        {
+            return ScalarScanAnyOf(begin,end,set,setSize);
+        }
+        __m256i needles[maxVectorSetSize];
+        for (sharpen::Size i = 0; i != setSize; ++i)
+        {
+            needles[i] = _mm256_set1_epi8(set[i]);
+        }
+        for (; end - begin >= 32; begin += 32)
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            __m256i acc = _mm256_cmpeq_epi8(block,needles[0]);
+            for (sharpen::Size i = 1; i != setSize; ++i)
+            {
+                acc = _mm256_or_si256(acc,_mm256_cmpeq_epi8(block,needles[i]));
+            }
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(acc));
+            if (mask)
+            {
+                return begin + CountTrailingZeros(mask);
+            }
+        }
+        return Sse2ScanAnyOf(begin,end,set,setSize);
+    }
+
+    __attribute__((target("avx2"))) const sharpen::Char *Avx2ScanPattern(const sharpen::Char *begin,const sharpen::Char *end,const sharpen::Char *pattern,sharpen::Size patternSize)
+    {
+        const __m256i first = _mm256_set1_epi8(pattern[0]);
+        const __m256i last = _mm256_set1_epi8(pattern[patternSize - 1]);
+        for (; static_cast<sharpen::Size>(end - begin) >= patternSize + 31; begin += 32)
+        {
+            __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin + patternSize - 1));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst,first),_mm256_cmpeq_epi8(blockLast,last))));
+            while (mask)
+            {
+                unsigned bit{CountTrailingZeros(mask)};
+                if (std::memcmp(begin + bit + 1,pattern + 1,patternSize - 2) == 0)
+                {
+                    return begin + bit;
+                }
+                mask &= mask - 1;
+            }
+        }
+        return Sse2ScanPattern(begin,end,pattern,patternSize);
+    }
+#endif
+
+    ScanTable SelectScanTable() noexcept
+    {
+#ifdef SHARPEN_BYTESCAN_AVX2
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return ScanTable{&Avx2ReverseScanByte,&Avx2ScanAnyOf,&Avx2ScanPattern,"avx2"};
+        }
+#endif
+#ifdef SHARPEN_BYTESCAN_SSE2
+        return ScanTable{&Sse2ReverseScanByte,&Sse2ScanAnyOf,&Sse2ScanPattern,"sse2"};
+#else
+        return ScanTable{&ScalarReverseScanByte,&ScalarScanAnyOf,&ScalarScanPattern,"scalar"};
+#endif
+    }
+
+    const ScanTable &GetScanTable() noexcept
+    {
+        static const ScanTable table{SelectScanTable()};
+        return table;
+    }
+}
+
+const sharpen::Char *sharpen::ScanByte(const sharpen::Char *begin,const sharpen::Char *end,sharpen::Char c) noexcept
+{
+    //memchr of the c library is already vectorized
+    if (begin == end)
+    {
+        return end;
+    }
+    const void *r = std::memchr(begin,static_cast<unsigned char>(c),static_cast<sharpen::Size>(end - begin));
+    return r ? reinterpret_cast<const sharpen::Char*>(r):end;
+}
+
+const sharpen::Char *sharpen::ReverseScanByte(const sharpen::Char *begin,const sharpen::Char *end,sharpen::Char c) noexcept
+{
+    return GetScanTable().reverseScanByte_(begin,end,c);
+}
+
+const sharpen::Char *sharpen::ScanAnyOf(const sharpen::Char *begin,const sharpen::Char *end,const sharpen::Char *set,sharpen::Size setSize) noexcept
+{
+    if (setSize == 1)
+    {
+        return sharpen::ScanByte(begin,end,set[0]);
+    }
+    return GetScanTable().scanAnyOf_(begin,end,set,setSize);
+}
+
+const sharpen::Char *sharpen::ScanPattern(const sharpen::Char *begin,const sharpen::Char *end,const sharpen::Char *pattern,sharpen::Size patternSize) noexcept
+{
+    if (patternSize == 0)
+    {
+        return begin;
+    }
+    if (static_cast<sharpen::Size>(end - begin) < patternSize)
+    {
+        return end;
+    }
+    if (patternSize == 1)
+    {
+        return sharpen::ScanByte(begin,end,pattern[0]);
+    }
+    return GetScanTable().scanPattern_(begin,end,pattern,patternSize);
+}
+
+const char *sharpen::GetByteScanImplementation() noexcept
+{
+    return GetScanTable().name_;
+}
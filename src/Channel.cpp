@@ -0,0 +1,75 @@
+#include <sharpen/Channel.hpp>
+
+#include <algorithm>
+#include <functional>
+
+static void LockAll(sharpen::SpinLock **locks,sharpen::Size count)
+{
+    for (sharpen::Size i = 0; i != count; ++i)
+    {
+        locks[i]->lock();
+    }
+}
+
+static void UnlockAll(sharpen::SpinLock **locks,sharpen::Size count) noexcept
+{
+    for (sharpen::Size i = count; i != 0; --i)
+    {
+        locks[i - 1]->unlock();
+    }
+}
+
+sharpen::Size sharpen::InternalSelect(sharpen::IChannelCase **cases,sharpen::SpinLock **locks,sharpen::Size count,bool block)
+{
+    assert(count != 0);
+    //cases may share a channel
+    //lock every channel once in address order to avoid deadlock
+    for (sharpen::Size i = 0; i != count; ++i)
+    {
+        locks[i] = &cases[i]->GetLock();
+    }
+    //raw < on unrelated pointers is unspecified
+    std::sort(locks,locks + count,std::less<sharpen::SpinLock*>());
+    sharpen::Size lockCount = std::unique(locks,locks + count) - locks;
+    ::LockAll(locks,lockCount);
+    sharpen::InternalChannelWakeup wakeup{nullptr,0};
+    for (sharpen::Size i = 0; i != count; ++i)
+    {
+        bool executed;
+        try
+        {
+            executed = cases[i]->TryExecuteWithoutLock(wakeup);
+        }
+        catch(...)
+        {
+            ::UnlockAll(locks,lockCount);
+            throw;
+        }
+        if (executed)
+        {
+            ::UnlockAll(locks,lockCount);
+            wakeup.Notify();
+            return i;
+        }
+    }
+    if (!block)
+    {
+        ::UnlockAll(locks,lockCount);
+        return count;
+    }
+    //the first channel which claims select resumes us
+    sharpen::InternalChannelSelect select;
+    for (sharpen::Size i = 0; i != count; ++i)
+    {
+        cases[i]->EnqueueWithoutLock(&select,i);
+    }
+    ::UnlockAll(locks,lockCount);
+    sharpen::Size index = select.Await();
+    ::LockAll(locks,lockCount);
+    for (sharpen::Size i = 0; i != count; ++i)
+    {
+        cases[i]->DequeueWithoutLock();
+    }
+    ::UnlockAll(locks,lockCount);
+    return index;
+}
@@ -0,0 +1,98 @@
+#include <sharpen/ComputePool.hpp>
+
+#include <cassert>
+
+#include <sharpen/EventEngine.hpp>
+#include <sharpen/EventLoop.hpp>
+
+sharpen::ComputePool::ComputePool()
+    :ComputePool(std::thread::hardware_concurrency())
+{}
+
+sharpen::ComputePool::ComputePool(sharpen::Size workerCount)
+    :workers_()
+    ,tasks_()
+    ,lock_()
+    ,cond_()
+    ,running_(true)
+{
+    if (workerCount == 0)
+    {
+        workerCount = 1;
+    }
+    this->workers_.reserve(workerCount);
+    for (sharpen::Size i = 0; i != workerCount; ++i)
+    {
+        this->workers_.emplace_back(std::bind(&sharpen::ComputePool::Run,this));
+    }
+}
+
+sharpen::ComputePool::~ComputePool() noexcept
+{
+    {
+        std::unique_lock<std::mutex> lock(this->lock_);
+        this->running_ = false;
+    }
+    this->cond_.notify_all();
+    for (auto begin = this->workers_.begin(),end = this->workers_.end(); begin != end; ++begin)
+    {
+        begin->join();
+    }
+}
+
+void sharpen::ComputePool::Run()
+{
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(this->lock_);
+            while (this->tasks_.empty() && this->running_)
+            {
+                this->cond_.wait(lock);
+            }
+            if (this->tasks_.empty())
+            {
+                return;
+            }
+            task = std::move(this->tasks_.front());
+            this->tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+void sharpen::ComputePool::Submit(Task task)
+{
+    assert(task);
+    {
+        std::unique_lock<std::mutex> lock(this->lock_);
+        assert(this->running_);
+        this->tasks_.push_back(std::move(task));
+    }
+    this->cond_.notify_one();
+}
+
+sharpen::Size sharpen::ParallelExecutor::GetParallelNumber() const noexcept
+{
+    if (this->pool_)
+    {
+        return this->pool_->GetWorkerNumber();
+    }
+    return sharpen::EventEngine::GetEngine().LoopNumber();
+}
+
+void sharpen::ParallelExecutor::Launch(Task task) const
+{
+    if (this->pool_)
+    {
+        this->pool_->Submit(std::move(task));
+        return;
+    }
+    sharpen::EventEngine::GetEngine().Launch(std::move(task));
+}
+
+bool sharpen::ParallelExecutor::CallerShouldHelp() const noexcept
+{
+    return !this->pool_ || !sharpen::EventLoop::IsInLoop();
+}
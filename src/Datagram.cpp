@@ -0,0 +1,75 @@
+#include <sharpen/Datagram.hpp>
+
+#include <cstring>
+#include <stdexcept>
+
+sharpen::Datagram::Datagram() noexcept
+    :Datagram(nullptr,0)
+{}
+
+sharpen::Datagram::Datagram(sharpen::Char *buf,sharpen::Size capacity) noexcept
+    :buf_(buf)
+    ,capacity_(capacity)
+    ,size_(capacity)
+    ,remote_()
+    ,remoteLen_(0)
+    ,local_()
+    ,localLen_(0)
+    ,segmentSize_(0)
+    ,truncated_(false)
+{}
+
+void sharpen::Datagram::SetBuffer(sharpen::Char *buf,sharpen::Size capacity) noexcept
+{
+    this->buf_ = buf;
+    this->capacity_ = capacity;
+    this->size_ = capacity;
+    this->truncated_ = false;
+}
+
+void sharpen::Datagram::SetSize(sharpen::Size size)
+{
+    if (size > this->capacity_)
+    {
+        throw std::length_error("size is larger than capacity");
+    }
+    this->size_ = size;
+}
+
+void sharpen::Datagram::GetRemoteEndPoint(sharpen::IEndPoint &endPoint) const
+{
+    if (this->remoteLen_ > endPoint.GetAddrLen())
+    {
+        throw std::length_error("endpoint is too small");
+    }
+    std::memcpy(endPoint.GetAddrPtr(),&this->remote_,this->remoteLen_);
+}
+
+void sharpen::Datagram::SetRemoteEndPoint(const sharpen::IEndPoint &endPoint)
+{
+    if (endPoint.GetAddrLen() > sizeof(this->remote_))
+    {
+        throw std::length_error("endpoint is too large");
+    }
+    std::memcpy(&this->remote_,endPoint.GetAddrPtr(),endPoint.GetAddrLen());
+    this->remoteLen_ = endPoint.GetAddrLen();
+}
+
+void sharpen::Datagram::GetLocalEndPoint(sharpen::IEndPoint &endPoint) const
+{
+    if (this->localLen_ > endPoint.GetAddrLen())
+    {
+        throw std::length_error("endpoint is too small");
+    }
+    std::memcpy(endPoint.GetAddrPtr(),&this->local_,this->localLen_);
+}
+
+void sharpen::Datagram::SetLocalEndPoint(const sharpen::IEndPoint &endPoint)
+{
+    if (endPoint.GetAddrLen() > sizeof(this->local_))
+    {
+        throw std::length_error("endpoint is too large");
+    }
+    std::memcpy(&this->local_,endPoint.GetAddrPtr(),endPoint.GetAddrLen());
+    this->localLen_ = endPoint.GetAddrLen();
+}
@@ -0,0 +1,189 @@
+#include <sharpen/EpochReclaimer.hpp>
+
+#include <cassert>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+std::atomic<sharpen::Uint64> sharpen::EpochReclaimer::epoch_(1);
+
+std::atomic<sharpen::InternalEpochRecord*> sharpen::EpochReclaimer::records_(nullptr);
+
+sharpen::SpinLock sharpen::EpochReclaimer::retiredLock_;
+
+sharpen::EpochReclaimer::Retired *sharpen::EpochReclaimer::retired_(nullptr);
+
+//must be defined after records_ and retired_
+//so it is destroyed before them
+sharpen::EpochReclaimer::Cleaner sharpen::EpochReclaimer::cleaner_;
+
+namespace
+{
+    //give the record back when the thread exits
+    struct LocalEpochRecord
+    {
+        sharpen::InternalEpochRecord *record_;
+
+        ~LocalEpochRecord() noexcept
+        {
+            if (this->record_)
+            {
+                assert(this->record_->nesting_ == 0);
+                this->record_->epoch_.store(0,std::memory_order_relaxed);
+                this->record_->inUse_.store(false,std::memory_order_release);
+            }
+        }
+    };
+
+    thread_local LocalEpochRecord localRecord{nullptr};
+}
+
+sharpen::EpochReclaimer::Record *sharpen::EpochReclaimer::AcquireRecord()
+{
+    //records are freed at exit
+    //reuse one of an exited thread first
+    for (Record *record = Self::records_.load(std::memory_order_acquire); record; record = record->next_)
+    {
+        bool inUse{false};
+        if (!record->inUse_.load(std::memory_order_relaxed) && record->inUse_.compare_exchange_strong(inUse,true,std::memory_order_acquire))
+        {
+            return record;
+        }
+    }
+    Record *record = new Record;
+    record->epoch_.store(0,std::memory_order_relaxed);
+    record->inUse_.store(true,std::memory_order_relaxed);
+    record->nesting_ = 0;
+    record->next_ = Self::records_.load(std::memory_order_relaxed);
+    while (!Self::records_.compare_exchange_weak(record->next_,record,std::memory_order_release,std::memory_order_relaxed))
+    {}
+    return record;
+}
+
+sharpen::EpochReclaimer::Record *sharpen::EpochReclaimer::GetLocalRecord()
+{
+    if (!localRecord.record_)
+    {
+        localRecord.record_ = Self::AcquireRecord();
+    }
+    return localRecord.record_;
+}
+
+void sharpen::EpochReclaimer::Enter()
+{
+    Record *record = Self::GetLocalRecord();
+    if (record->nesting_++ != 0)
+    {
+        return;
+    }
+    record->epoch_.store(Self::epoch_.load(std::memory_order_relaxed),std::memory_order_relaxed);
+    //the epoch must be visible before we load any protected pointer
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void sharpen::EpochReclaimer::Leave() noexcept
+{
+    Record *record = localRecord.record_;
+    assert(record && record->nesting_ != 0);
+    if (--record->nesting_ == 0)
+    {
+        record->epoch_.store(0,std::memory_order_release);
+    }
+}
+
+sharpen::Uint64 sharpen::EpochReclaimer::GetMinActiveEpoch() noexcept
+{
+    sharpen::Uint64 min{(std::numeric_limits<sharpen::Uint64>::max)()};
+    for (Record *record = Self::records_.load(std::memory_order_acquire); record; record = record->next_)
+    {
+        sharpen::Uint64 epoch = record->epoch_.load(std::memory_order_seq_cst);
+        if (epoch != 0 && epoch < min)
+        {
+            min = epoch;
+        }
+    }
+    return min;
+}
+
+void sharpen::EpochReclaimer::Retire(void *obj,Deleter deleter)
+{
+    assert(obj);
+    Retired *retired = new Retired;
+    retired->obj_ = obj;
+    retired->deleter_ = deleter;
+    //readers which entered before this point may still see obj
+    retired->epoch_ = Self::epoch_.fetch_add(1,std::memory_order_seq_cst);
+    {
+        std::unique_lock<sharpen::SpinLock> lock(Self::retiredLock_);
+        retired->next_ = Self::retired_;
+        Self::retired_ = retired;
+    }
+    Self::Reclaim();
+}
+
+sharpen::Size sharpen::EpochReclaimer::Reclaim()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    sharpen::Uint64 min = Self::GetMinActiveEpoch();
+    Retired *chain{nullptr};
+    {
+        std::unique_lock<sharpen::SpinLock> lock(Self::retiredLock_);
+        Retired **ite = &Self::retired_;
+        while (*ite)
+        {
+            Retired *retired = *ite;
+            if (retired->epoch_ < min)
+            {
+                *ite = retired->next_;
+                retired->next_ = chain;
+                chain = retired;
+            }
+            else
+            {
+                ite = &retired->next_;
+            }
+        }
+    }
+    sharpen::Size count{0};
+    while (chain)
+    {
+        Retired *next = chain->next_;
+        chain->deleter_(chain->obj_);
+        delete chain;
+        chain = next;
+        ++count;
+    }
+    return count;
+}
+
+void sharpen::EpochReclaimer::Synchronize()
+{
+    assert(!localRecord.record_ || localRecord.record_->nesting_ == 0);
+    sharpen::Uint64 epoch = Self::epoch_.fetch_add(1,std::memory_order_seq_cst);
+    while (Self::GetMinActiveEpoch() <= epoch)
+    {
+        std::this_thread::yield();
+    }
+    Self::Reclaim();
+}
+
+sharpen::EpochReclaimer::Cleaner::~Cleaner() noexcept
+{
+    //a thread which still owns a record may use the list
+    for (Record *record = Self::records_.load(std::memory_order_acquire); record; record = record->next_)
+    {
+        if (record->inUse_.load(std::memory_order_acquire))
+        {
+            return;
+        }
+    }
+    //no reader is left
+    Self::Reclaim();
+    Record *record = Self::records_.exchange(nullptr,std::memory_order_acq_rel);
+    while (record)
+    {
+        Record *next = record->next_;
+        delete record;
+        record = next;
+    }
+}
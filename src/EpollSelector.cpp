@@ -11,6 +11,7 @@ sharpen::EpollSelector::EpollSelector()
     ,eventfd_(0,O_CLOEXEC | O_NONBLOCK)
     ,map_()
     ,eventBuf_(8)
+    ,lock_()
 {
     //register event fd
     Event &event = (this->map_[this->eventfd_.GetHandle()] = std::move(Event()));
@@ -77,6 +78,7 @@ void sharpen::EpollSelector::Resister(WeakChannelPtr channel)
     {
         return;
     }
+    std::unique_lock<sharpen::SpinLock> lock(this->lock_);
     Event &event = (this->map_[ch->GetHandle()] = std::move(Event()));
     event.ioEvent_.SetChannel(ch);
     event.epollEvent_.data.ptr = &event;
@@ -85,4 +87,11 @@ void sharpen::EpollSelector::Resister(WeakChannelPtr channel)
     this->epoll_.Add(ch->GetHandle(),&(event.epollEvent_));
 }
 
+void sharpen::EpollSelector::Deregister(sharpen::FileHandle handle)
+{
+    std::unique_lock<sharpen::SpinLock> lock(this->lock_);
+    this->epoll_.Remove(handle);
+    this->map_.erase(handle);
+}
+
 #endif
\ No newline at end of file
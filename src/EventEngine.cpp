@@ -1,7 +1,9 @@
 #include <sharpen/EventEngine.hpp>
 #include <sharpen/ISelector.hpp>
 #include <sharpen/SystemMacro.hpp>
+#include <sharpen/LoopPlacementPolicy.hpp>
 #include <cassert>
+#include <stdexcept>
 
 sharpen::EventEngine::SelfPtr sharpen::EventEngine::engine_;
 
@@ -17,6 +19,8 @@ sharpen::EventEngine::EventEngine(sharpen::Size workerCount)
     :workers_()
     ,pos_(0)
     ,mainLoop_(nullptr)
+    ,loops_()
+    ,policy_(new sharpen::LeastLoadedPlacementPolicy())
 {
     assert(workerCount != 0);
     this->mainLoop_.reset(new sharpen::EventLoop(sharpen::MakeDefaultSelector()));
@@ -41,6 +45,20 @@ sharpen::EventLoop *sharpen::EventEngine::RoundRobinLoop() noexcept
     return this->loops_[pos % this->loops_.size()];
 }
 
+sharpen::EventLoop *sharpen::EventEngine::SelectLoop() noexcept
+{
+    return this->policy_->SelectLoop(this->loops_);
+}
+
+void sharpen::EventEngine::SetPlacementPolicy(sharpen::LoopPlacementPolicyPtr policy)
+{
+    if (!policy)
+    {
+        throw std::invalid_argument("policy could not be null");
+    }
+    this->policy_ = std::move(policy);
+}
+
 void sharpen::EventEngine::Stop() noexcept
 {
     for (auto begin = this->workers_.begin(),end = this->workers_.end();begin != end;++begin)
@@ -1,6 +1,7 @@
 #include <sharpen/EventLoop.hpp>
 
 #include <cassert>
+#include <chrono>
 #include <thread>
 
 thread_local sharpen::EventLoop *sharpen::EventLoop::localLoop_(nullptr);
@@ -15,6 +16,9 @@ sharpen::EventLoop::EventLoop(SelectorPtr selector)
     ,lock_()
     ,running_(false)
     ,waiting_(false)
+    ,channelLock_()
+    ,channels_()
+    ,busyRatio_(0)
 {
     assert(selector != nullptr);
     this->pendingTasks_.reserve(32);
@@ -28,7 +32,40 @@ sharpen::EventLoop::~EventLoop() noexcept
 
 void sharpen::EventLoop::Bind(WeakChannelPtr channel)
 {
+    sharpen::ChannelPtr ch = channel.lock();
+    //closed channels are not counted
+#ifdef SHARPEN_IS_WIN
+    if (!ch || ch->GetHandle() == INVALID_HANDLE_VALUE)
+#else
+    if (!ch || ch->GetHandle() == -1)
+#endif
+    {
+        return;
+    }
     this->selector_->Resister(channel);
+    std::unique_lock<Lock> lock(this->channelLock_);
+    this->channels_.insert(ch->GetHandle());
+}
+
+void sharpen::EventLoop::Unbind(sharpen::FileHandle handle) noexcept
+{
+    std::unique_lock<Lock> lock(this->channelLock_);
+    this->channels_.erase(handle);
+}
+
+bool sharpen::EventLoop::Detach(sharpen::FileHandle handle)
+{
+    {
+        std::unique_lock<Lock> lock(this->channelLock_);
+        if (!this->channels_.count(handle))
+        {
+            return false;
+        }
+    }
+    this->selector_->Deregister(handle);
+    std::unique_lock<Lock> lock(this->channelLock_);
+    this->channels_.erase(handle);
+    return true;
 }
 
 void sharpen::EventLoop::RunInLoop(Task task)
@@ -102,12 +139,14 @@ void sharpen::EventLoop::Run()
     EventVector events;
     events.reserve(128);
     this->running_ = true;
+    auto idleBegin = std::chrono::steady_clock::now();
     while (this->running_)
     {
         //select events
         this->waiting_ = true;
         this->selector_->Select(events);
         this->waiting_ = false;
+        auto busyBegin = std::chrono::steady_clock::now();
         for (auto begin = events.begin(),end = events.end();begin != end;++begin)
         {
             sharpen::ChannelPtr channel = (*begin)->GetChannel();
@@ -119,6 +158,7 @@ void sharpen::EventLoop::Run()
         events.clear();
         //execute tasks
         this->ExecuteTask();
+        idleBegin = this->UpdateBusyRatio(idleBegin,busyBegin);
     }
     sharpen::EventLoop::localLoop_ = nullptr;
     sharpen::EventLoop::localFiber_.reset();
@@ -151,4 +191,34 @@ bool sharpen::EventLoop::IsInLoop() noexcept
 bool sharpen::EventLoop::IsWaiting() const noexcept
 {
     return this->waiting_;
+}
+
+std::chrono::steady_clock::time_point sharpen::EventLoop::UpdateBusyRatio(std::chrono::steady_clock::time_point idleBegin,std::chrono::steady_clock::time_point busyBegin) noexcept
+{
+    auto end = std::chrono::steady_clock::now();
+    auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(end - idleBegin).count();
+    if (total > 0)
+    {
+        auto busy = std::chrono::duration_cast<std::chrono::nanoseconds>(end - busyBegin).count();
+        sharpen::Uint32 ratio = static_cast<sharpen::Uint32>(busy*1000/total);
+        //only the loop thread writes the ratio
+        sharpen::Uint32 old = this->busyRatio_.load(std::memory_order_relaxed);
+        this->busyRatio_.store((old*7 + ratio)/8,std::memory_order_relaxed);
+    }
+    return end;
+}
+
+sharpen::EventLoopLoad sharpen::EventLoop::GetLoad() noexcept
+{
+    sharpen::EventLoopLoad load;
+    {
+        std::unique_lock<Lock> lock(this->channelLock_);
+        load.channels_ = this->channels_.size();
+    }
+    {
+        std::unique_lock<Lock> lock(this->lock_);
+        load.pendingTasks_ = this->pendingTasks_.size();
+    }
+    load.busyRatio_ = this->busyRatio_.load(std::memory_order_relaxed);
+    return load;
 }
\ No newline at end of file
@@ -62,7 +62,7 @@ sharpen::FiberPtr sharpen::Fiber::GetCurrentFiber()
 {
     if (!sharpen::Fiber::currentFiber_)
     {
-        sharpen::FiberPtr fiber = std::make_shared<sharpen::Fiber>();
+        sharpen::FiberPtr fiber = sharpen::ObjectPool<sharpen::Fiber>::MakeShared();
         fiber->inited_ = true;
         sharpen::Fiber::currentFiber_ = fiber;
     }
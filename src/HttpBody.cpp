@@ -77,7 +77,7 @@ sharpen::Size sharpen::HttpBody::CopyTo(sharpen::ByteBuffer &buf,sharpen::Size o
     sharpen::Size left = buf.GetSize() - offset;
     if (this->GetSize() > left)
     {
-        buf.Extend(this->GetSize() - left);
+        buf.ExtendUninitialized(this->GetSize() - left);
     }
     this->CopyToMem(buf.Data(),offset);
     return buf.GetSize();
@@ -118,7 +118,7 @@ sharpen::Size sharpen::HttpHeader::CopyTo(sharpen::ByteBuffer &buf,sharpen::Size
     sharpen::Size left = buf.GetSize() - offset;
     if (left < needSize)
     {
-        buf.Extend(left - needSize);
+        buf.ExtendUninitialized(needSize - left);
     }
     this->CopyToMem(buf.Data(),offset);
     return needSize;
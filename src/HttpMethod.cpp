@@ -41,7 +41,7 @@ sharpen::Size sharpen::CopyHttpMethodNameTo(sharpen::HttpMethod method,sharpen::
     sharpen::Size left = buf.GetSize() - offset;
     if (len > left)
     {
-        buf.Extend(len - left);
+        buf.ExtendUninitialized(len - left);
     }
     sharpen::InternalCopyHttpMethodNameToMem(method,buf.Data(),offset);
     return len;
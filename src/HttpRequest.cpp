@@ -135,7 +135,7 @@ sharpen::Size sharpen::HttpRequest::CopyTo(sharpen::ByteBuffer &buf,sharpen::Siz
     sharpen::Size tmp = this->ComputeSize();
     if ((buf.GetSize() - offset) < tmp)
     {
-        buf.Extend(tmp - buf.GetSize() - offset);
+        buf.ExtendUninitialized(tmp - (buf.GetSize() - offset));
     }
     tmp = offset;
     //copy method
@@ -139,7 +139,7 @@ sharpen::Size sharpen::HttpResponse::CopyTo(sharpen::ByteBuffer &buf,sharpen::Si
     sharpen::Size left = buf.GetSize() - offset;
     if (size > left)
     {
-        buf.Extend(size - left);
+        buf.ExtendUninitialized(size - left);
     }
     //version
     offset += sharpen::CopyHttpVersionNameTo(this->version_,buf,offset);
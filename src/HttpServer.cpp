@@ -1,6 +1,10 @@
 #include <sharpen/HttpServer.hpp>
 
 #include <sharpen/HttpParser.hpp>
+#include <sharpen/BufferSlice.hpp>
+
+#include <new>
+#include <stdexcept>
 
 sharpen::HttpServer::HttpServer(sharpen::AddressFamily af,const sharpen::IEndPoint &endpoint,sharpen::EventEngine &engine,std::string name)
     :Mybase(af,endpoint,engine)
@@ -11,9 +15,27 @@ sharpen::HttpServer::HttpServer(sharpen::AddressFamily af,const sharpen::IEndPoi
     :HttpServer(af,endpoint,engine,"")
 {}
 
+void sharpen::HttpServer::OnNewMessage(sharpen::NetStreamChannelPtr channel,const sharpen::HttpRequest &req,sharpen::HttpResponse &res)
+{
+    (void)channel;
+    (void)req;
+    (void)res;
+    throw std::logic_error("OnNewMessage is not overridden");
+}
+
+void sharpen::HttpServer::OnNewMessage(sharpen::NetStreamChannelPtr channel,const sharpen::HttpRequest &req,sharpen::HttpResponse &res,sharpen::Arena &arena)
+{
+    (void)arena;
+    this->OnNewMessage(std::move(channel),req,res);
+}
+
 void sharpen::HttpServer::OnNewChannel(sharpen::NetStreamChannelPtr channel)
 {
-    sharpen::ByteBuffer buf(4096);
+    //the parser copies what it keeps
+    //so one pooled block is reused by every read
+    sharpen::BufferSlice buf{4096};
+    //only this fiber allocates from the arena
+    sharpen::Arena arena{4096,sharpen::ArenaMode::Exclusive};
     sharpen::HttpRequest req;
     sharpen::HttpResponse res;
     sharpen::HttpParser parser(sharpen::HttpParser::ParserModel::Request);
@@ -24,7 +46,7 @@ void sharpen::HttpServer::OnNewChannel(sharpen::NetStreamChannelPtr channel)
         //parse request
         while (!parser.IsCompleted())
         {
-            sharpen::Size n = channel->ReadAsync(buf);
+            sharpen::Size n = channel->ReadAsync(buf.Data(),buf.GetSize());
             if (n == 0)
             {
                 return;
@@ -54,11 +76,18 @@ void sharpen::HttpServer::OnNewChannel(sharpen::NetStreamChannelPtr channel)
         }
         keep = parser.ShouldKeepalive();
         //handle
-        this->OnNewMessage(channel,req,res);
+        this->OnNewMessage(channel,req,res,arena);
         //send res
-        sharpen::Size n = res.CopyTo(buf);
-        channel->WriteAsync(buf.Data(),n);
+        sharpen::Size size = res.ComputeSize();
+        char *data = static_cast<char*>(arena.Alloc(size,1));
+        if (!data)
+        {
+            throw std::bad_alloc();
+        }
+        sharpen::Size n = res.CopyTo(data,size);
+        channel->WriteAsync(data,n);
         //reset
+        arena.Reset();
         res.Clear();
         req.Clear();
     }
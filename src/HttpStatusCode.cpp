@@ -100,7 +100,7 @@ sharpen::Size sharpen::CopyHttpStatusCodeNameTo(sharpen::HttpStatusCode code,sha
     sharpen::Size left = buf.GetSize() - offset;
     if (len > left)
     {
-        buf.Extend(len - left);
+        buf.ExtendUninitialized(len - left);
     }
     sharpen::InternalCopyHttpStatusCodeNameToMem(code,buf.Data(),offset);
     return len;
@@ -72,7 +72,7 @@ sharpen::Size sharpen::CopyHttpVersionNameTo(sharpen::HttpVersion version,sharpe
     sharpen::Size left = buf.GetSize() - offset;
     if (left < len)
     {
-        buf.Extend(len - left);
+        buf.ExtendUninitialized(len - left);
     }
     sharpen::InternalCopyHttpVersionNameToMem(version,buf.Data(),offset);
     return len;
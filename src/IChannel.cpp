@@ -1,5 +1,9 @@
 #include <sharpen/IChannel.hpp>
 #include <sharpen/EventEngine.hpp>
+#include <sharpen/AwaitableFuture.hpp>
+
+#include <cassert>
+#include <stdexcept>
 
 #include <sharpen/SystemMacro.hpp>
 
@@ -14,21 +18,112 @@ sharpen::IChannel::~IChannel() noexcept
 
 void sharpen::IChannel::Register(sharpen::EventLoop *loop)
 {
-    loop->Bind(this->shared_from_this());
+    //events may be dispatched as soon as the handle is bound
+    sharpen::EventLoop *prev{this->loop_};
     this->loop_ = loop;
+    try
+    {
+        loop->Bind(this->shared_from_this());
+    }
+    catch(const std::exception&)
+    {
+        this->loop_ = prev;
+        throw;
+    }
 }
 
 void sharpen::IChannel::Register(sharpen::EventEngine &engine)
 {
-    sharpen::EventLoop *loop = engine.RoundRobinLoop();
+    sharpen::EventLoop *loop = engine.SelectLoop();
     this->Register(loop);
 }
 
+void sharpen::IChannel::MigrateAsync(sharpen::EventLoop *loop,sharpen::Future<void> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    if (!loop)
+    {
+        throw std::invalid_argument("loop could not be null");
+    }
+    if (loop == this->loop_)
+    {
+        future.Complete();
+        return;
+    }
+    //the events of this iteration must be dispatched first
+    this->loop_->RunInLoopSoon(std::bind(&Self::DoMigrate,this->shared_from_this(),loop,&future));
+}
+
+void sharpen::IChannel::MigrateAsync(sharpen::EventLoop *loop)
+{
+    sharpen::AwaitableFuture<void> future;
+    this->MigrateAsync(loop,future);
+    future.Await();
+}
+
+void sharpen::IChannel::DoMigrate(std::shared_ptr<Self> channel,sharpen::EventLoop *loop,sharpen::Future<void> *future) noexcept
+{
+    assert(channel->loop_ == sharpen::EventLoop::GetLocalLoop());
+    sharpen::EventLoop *source = channel->loop_;
+    try
+    {
+        //closed or never bound
+        if (!source->Detach(channel->handle_))
+        {
+            throw std::logic_error("channel is not bound to the loop");
+        }
+    }
+    catch(const std::exception&)
+    {
+        future->Fail(std::current_exception());
+        return;
+    }
+    //tasks queued by the events of this iteration still run in the source loop
+    source->RunInLoopSoon(std::bind(&Self::PostMigrate,std::move(channel),loop,future));
+}
+
+void sharpen::IChannel::PostMigrate(std::shared_ptr<Self> channel,sharpen::EventLoop *loop,sharpen::Future<void> *future) noexcept
+{
+    try
+    {
+        loop->RunInLoop(std::bind(&Self::CompleteMigrate,channel,loop,future));
+    }
+    catch(const std::exception&)
+    {
+        channel->loop_ = nullptr;
+        future->Fail(std::current_exception());
+    }
+}
+
+void sharpen::IChannel::CompleteMigrate(std::shared_ptr<Self> channel,sharpen::EventLoop *loop,sharpen::Future<void> *future) noexcept
+{
+    assert(loop == sharpen::EventLoop::GetLocalLoop());
+    try
+    {
+        //a ready handle reports its events to the new selector
+        channel->Register(loop);
+    }
+    catch(const std::exception&)
+    {
+        channel->loop_ = nullptr;
+        future->Fail(std::current_exception());
+        return;
+    }
+    future->Complete();
+}
+
 void sharpen::IChannel::Close() noexcept
 {
 #ifdef SHARPEN_IS_WIN
     if (this->handle_ != INVALID_HANDLE_VALUE)
     {
+        if (this->loop_)
+        {
+            this->loop_->Unbind(this->handle_);
+        }
         if (this->closer_)
         {
             this->closer_(this->handle_);
@@ -43,6 +138,10 @@ void sharpen::IChannel::Close() noexcept
 #else
     if (this->handle_ != -1)
     {
+        if (this->loop_)
+        {
+            this->loop_->Unbind(this->handle_);
+        }
         if (this->closer_)
         {
             this->closer_(this->handle_);
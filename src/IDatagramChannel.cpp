@@ -0,0 +1,87 @@
+#include <sharpen/IDatagramChannel.hpp>
+
+#include <stdexcept>
+
+#include <sharpen/PosixDatagramChannel.hpp>
+#include <sharpen/AwaitableFuture.hpp>
+#include <sharpen/SystemError.hpp>
+#include <sharpen/ObjectPool.hpp>
+
+#ifdef SHARPEN_IS_NIX
+#include <netinet/in.h>
+#endif
+
+sharpen::DatagramChannelPtr sharpen::MakeUdpChannel(sharpen::AddressFamily af)
+{
+#ifdef SHARPEN_HAS_POSIXDATAGRAM
+    if (af == sharpen::AddressFamily::Unix)
+    {
+        throw std::invalid_argument("unix datagram channel is not supported");
+    }
+    int afValue = af == sharpen::AddressFamily::Ip ? AF_INET:AF_INET6;
+    sharpen::FileHandle s = ::socket(afValue,SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK,IPPROTO_UDP);
+    if (s == -1)
+    {
+        sharpen::ThrowLastError();
+    }
+    sharpen::DatagramChannelPtr channel = sharpen::ObjectPool<sharpen::PosixDatagramChannel>::MakeShared(s,afValue);
+    return channel;
+#else
+    (void)af;
+    throw std::logic_error("datagram channel is not supported");
+#endif
+}
+
+sharpen::Size sharpen::IDatagramChannel::ReceiveManyAsync(sharpen::Datagram *datagrams,sharpen::Size count)
+{
+    sharpen::AwaitableFuture<sharpen::Size> future;
+    this->ReceiveManyAsync(datagrams,count,future);
+    return future.Await();
+}
+
+sharpen::Size sharpen::IDatagramChannel::SendManyAsync(const sharpen::Datagram *datagrams,sharpen::Size count)
+{
+    sharpen::AwaitableFuture<sharpen::Size> future;
+    this->SendManyAsync(datagrams,count,future);
+    return future.Await();
+}
+
+void sharpen::IDatagramChannel::Bind(const sharpen::IEndPoint &endpoint)
+{
+#ifdef SHARPEN_IS_WIN
+    int r = ::bind(reinterpret_cast<SOCKET>(this->handle_),endpoint.GetAddrPtr(),endpoint.GetAddrLen());
+#else
+    int r = ::bind(this->handle_,endpoint.GetAddrPtr(),endpoint.GetAddrLen());
+#endif
+    if (r != 0)
+    {
+        sharpen::ThrowLastError();
+    }
+}
+
+void sharpen::IDatagramChannel::GetLocalEndPoint(sharpen::IEndPoint &endPoint) const
+{
+#ifdef SHARPEN_IS_WIN
+    int len = endPoint.GetAddrLen();
+    int r = ::getsockname(reinterpret_cast<SOCKET>(this->handle_),endPoint.GetAddrPtr(),&len);
+#else
+    socklen_t len = endPoint.GetAddrLen();
+    int r = ::getsockname(this->handle_,endPoint.GetAddrPtr(),&len);
+#endif
+    if (r != 0)
+    {
+        sharpen::ThrowLastError();
+    }
+    endPoint.SetAddrLen(static_cast<sharpen::Uint32>(len));
+}
+
+void sharpen::IDatagramChannel::SetReuseAddress(bool val)
+{
+#ifdef SHARPEN_IS_WIN
+    BOOL opt = val ? TRUE:FALSE;
+    ::setsockopt(reinterpret_cast<SOCKET>(this->handle_),SOL_SOCKET,SO_REUSEADDR,reinterpret_cast<char*>(&opt),sizeof(opt));
+#else
+    int opt = val ? 1:0;
+    ::setsockopt(this->handle_,SOL_SOCKET,SO_REUSEADDR,&opt,sizeof(opt));
+#endif
+}
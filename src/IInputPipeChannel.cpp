@@ -2,6 +2,8 @@
 #include <sharpen/WinInputPipeChannel.hpp>
 #include <sharpen/PosixInputPipeChannel.hpp>
 
+#include <stdexcept>
+
 int sharpen::IInputPipeChannel::GetcharAsync()
 {
     char buf;
@@ -63,4 +65,29 @@ sharpen::InputPipeChannelPtr sharpen::MakeStdinPipe()
 #else
     return std::make_shared<sharpen::PosixInputPipeChannel>(0);
 #endif
-}
\ No newline at end of file
+}
+sharpen::Size sharpen::IInputPipeChannel::SetPipeSize(sharpen::Size size)
+{
+    (void)size;
+    throw std::logic_error("pipe size is not supported");
+}
+
+sharpen::Size sharpen::IInputPipeChannel::GetPipeSize() const noexcept
+{
+    return 0;
+}
+
+void sharpen::IInputPipeChannel::TeeAsync(sharpen::IOutputPipeChannel &to,sharpen::Size size,sharpen::Future<sharpen::Size> &future)
+{
+    (void)to;
+    (void)size;
+    (void)future;
+    throw std::logic_error("tee is not supported");
+}
+
+sharpen::Size sharpen::IInputPipeChannel::TeeAsync(sharpen::IOutputPipeChannel &to,sharpen::Size size)
+{
+    sharpen::AwaitableFuture<sharpen::Size> future;
+    this->TeeAsync(to,size,future);
+    return future.Await();
+}
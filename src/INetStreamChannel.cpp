@@ -4,6 +4,7 @@
 #include <sharpen/PosixNetStreamChannel.hpp>
 #include <sharpen/AwaitableFuture.hpp>
 #include <sharpen/SystemError.hpp>
+#include <sharpen/ObjectPool.hpp>
 
 #ifdef SHARPEN_IS_NIX
 #include <netinet/tcp.h>
@@ -19,6 +20,10 @@
 
 sharpen::NetStreamChannelPtr sharpen::MakeTcpStreamChannel(sharpen::AddressFamily af)
 {
+    if (af == sharpen::AddressFamily::Unix)
+    {
+        return sharpen::MakeUnixStreamChannel();
+    }
     sharpen::NetStreamChannelPtr channel;
     int afValue;
     if (af == sharpen::AddressFamily::Ip)
@@ -43,11 +48,26 @@ sharpen::NetStreamChannelPtr sharpen::MakeTcpStreamChannel(sharpen::AddressFamil
     {
         sharpen::ThrowLastError();
     }
-    channel = std::make_shared<sharpen::PosixNetStreamChannel>(s);
+    channel = sharpen::ObjectPool<sharpen::PosixNetStreamChannel>::MakeShared(s);
     return channel;
 #endif
 }
 
+sharpen::NetStreamChannelPtr sharpen::MakeUnixStreamChannel()
+{
+#ifdef SHARPEN_HAS_POSIXSOCKET
+    sharpen::FileHandle s = ::socket(AF_UNIX,SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK,0);
+    if (s == -1)
+    {
+        sharpen::ThrowLastError();
+    }
+    sharpen::NetStreamChannelPtr channel = sharpen::ObjectPool<sharpen::PosixNetStreamChannel>::MakeShared(s);
+    return channel;
+#else
+    throw std::logic_error("unix domain socket is not supported");
+#endif
+}
+
 void sharpen::StartupNetSupport()
 {
 #ifdef SHARPEN_HAS_WINSOCKET
@@ -90,6 +110,51 @@ sharpen::NetStreamChannelPtr sharpen::INetStreamChannel::AcceptAsync()
     return future.Await();
 }
 
+void sharpen::INetStreamChannel::WriteAsync(const sharpen::BufferChain &chain,sharpen::Future<sharpen::Size> &future)
+{
+    if (chain.GetSegmentCount() < 2)
+    {
+        const sharpen::Char *data = chain.Empty() ? nullptr:chain.GetSegment(0).Data();
+        this->WriteAsync(data,chain.GetSize(),future);
+        return;
+    }
+    //the flat copy and the inner future live in the callback of the inner future
+    //the callback is released after it runs
+    std::shared_ptr<sharpen::ByteBuffer> buf = std::make_shared<sharpen::ByteBuffer>(chain.Flatten());
+    sharpen::FuturePtr<sharpen::Size> inner = sharpen::MakeFuturePtr<sharpen::Size>();
+    std::shared_ptr<sharpen::FuturePtr<sharpen::Size>> keeper = std::make_shared<sharpen::FuturePtr<sharpen::Size>>(inner);
+    sharpen::Future<sharpen::Size> *outer = &future;
+    inner->SetCallback([buf,keeper,outer](sharpen::Future<sharpen::Size> &f)
+    {
+        try
+        {
+            outer->Complete(f.Get());
+        }
+        catch(const std::exception&)
+        {
+            outer->Fail(std::current_exception());
+        }
+    });
+    try
+    {
+        this->WriteAsync(*buf,0,*inner);
+    }
+    catch(const std::exception&)
+    {
+        //the callback never runs
+        //break the cycle so the inner future is freed
+        keeper->reset();
+        throw;
+    }
+}
+
+sharpen::Size sharpen::INetStreamChannel::WriteAsync(const sharpen::BufferChain &chain)
+{
+    sharpen::AwaitableFuture<sharpen::Size> future;
+    this->WriteAsync(chain,future);
+    return future.Await();
+}
+
 void sharpen::INetStreamChannel::SendFileAsync(sharpen::FileChannelPtr file,sharpen::Uint64 size,sharpen::Uint64 offset)
 {
     sharpen::AwaitableFuture<void> future;
@@ -143,7 +208,7 @@ void sharpen::INetStreamChannel::GetLocalEndPoint(sharpen::IEndPoint &endPoint)
     {
         sharpen::ThrowLastError();
     }
-    
+    endPoint.SetAddrLen(static_cast<sharpen::Uint32>(len));
 }
 
 void sharpen::INetStreamChannel::GetRemoteEndPoint(sharpen::IEndPoint &endPoint) const
@@ -159,6 +224,7 @@ void sharpen::INetStreamChannel::GetRemoteEndPoint(sharpen::IEndPoint &endPoint)
     {
         sharpen::ThrowLastError();
     }
+    endPoint.SetAddrLen(static_cast<sharpen::Uint32>(len));
 }
 
 void sharpen::INetStreamChannel::SetKeepAlive(bool val)
@@ -217,4 +283,94 @@ void sharpen::INetStreamChannel::PollWriteAsync()
     sharpen::AwaitableFuture<void> future;
     this->PollWriteAsync(future);
     future.Await();
+}
+
+void sharpen::INetStreamChannel::SetWriteCoalescing(bool coalesce) noexcept
+{
+    (void)coalesce;
+}
+
+void sharpen::INetStreamChannel::SetWriteHighWaterMark(sharpen::Size mark) noexcept
+{
+    (void)mark;
+}
+
+sharpen::Size sharpen::INetStreamChannel::GetPendingWriteSize() const noexcept
+{
+    return 0;
+}
+
+sharpen::Size sharpen::INetStreamChannel::GetWriteCallCount() const noexcept
+{
+    return 0;
+}
+
+void sharpen::INetStreamChannel::SetZeroCopyThreshold(sharpen::Size threshold) noexcept
+{
+    (void)threshold;
+}
+
+sharpen::Size sharpen::INetStreamChannel::GetZeroCopyThreshold() const noexcept
+{
+    return 0;
+}
+
+void sharpen::INetStreamChannel::SendHandlesAsync(const sharpen::FileHandle *handles,sharpen::Size count,sharpen::Future<void> &future)
+{
+    (void)handles;
+    (void)count;
+    (void)future;
+    throw std::logic_error("handle passing is not supported");
+}
+
+void sharpen::INetStreamChannel::SendHandlesAsync(const sharpen::FileHandle *handles,sharpen::Size count)
+{
+    sharpen::AwaitableFuture<void> future;
+    this->SendHandlesAsync(handles,count,future);
+    future.Await();
+}
+
+void sharpen::INetStreamChannel::ReceiveHandlesAsync(sharpen::FileHandle *handles,sharpen::Size count,sharpen::Future<sharpen::Size> &future)
+{
+    (void)handles;
+    (void)count;
+    (void)future;
+    throw std::logic_error("handle passing is not supported");
+}
+
+sharpen::Size sharpen::INetStreamChannel::ReceiveHandlesAsync(sharpen::FileHandle *handles,sharpen::Size count)
+{
+    sharpen::AwaitableFuture<sharpen::Size> future;
+    this->ReceiveHandlesAsync(handles,count,future);
+    return future.Await();
+}
+
+void sharpen::INetStreamChannel::SpliceToPipeAsync(sharpen::FileHandle pipe,sharpen::Size size,sharpen::Future<sharpen::Size> &future)
+{
+    (void)pipe;
+    (void)size;
+    (void)future;
+    throw std::logic_error("splice is not supported");
+}
+
+sharpen::Size sharpen::INetStreamChannel::SpliceToPipeAsync(sharpen::FileHandle pipe,sharpen::Size size)
+{
+    sharpen::AwaitableFuture<sharpen::Size> future;
+    this->SpliceToPipeAsync(pipe,size,future);
+    return future.Await();
+}
+
+void sharpen::INetStreamChannel::SpliceFromPipeAsync(sharpen::FileHandle pipe,sharpen::Size size,sharpen::Future<sharpen::Size> &future)
+{
+    (void)pipe;
+    (void)size;
+    (void)future;
+    throw std::logic_error("splice is not supported");
+}
+
+sharpen::Size sharpen::INetStreamChannel::SpliceFromPipeAsync(sharpen::FileHandle pipe,sharpen::Size size)
+{
+    sharpen::AwaitableFuture<sharpen::Size> future;
+    this->SpliceFromPipeAsync(pipe,size,future);
+    return future.Await();
 }
\ No newline at end of file
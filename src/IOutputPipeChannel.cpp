@@ -0,0 +1,42 @@
+#include <sharpen/IOutputPipeChannel.hpp>
+
+#include <stdexcept>
+
+sharpen::Size sharpen::IOutputPipeChannel::SetPipeSize(sharpen::Size size)
+{
+    (void)size;
+    throw std::logic_error("pipe size is not supported");
+}
+
+sharpen::Size sharpen::IOutputPipeChannel::GetPipeSize() const noexcept
+{
+    return 0;
+}
+
+void sharpen::IOutputPipeChannel::VmspliceAsync(const sharpen::Char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> &future)
+{
+    (void)buf;
+    (void)bufSize;
+    (void)future;
+    throw std::logic_error("vmsplice is not supported");
+}
+
+sharpen::Size sharpen::IOutputPipeChannel::VmspliceAsync(const sharpen::Char *buf,sharpen::Size bufSize)
+{
+    sharpen::AwaitableFuture<sharpen::Size> future;
+    this->VmspliceAsync(buf,bufSize,future);
+    return future.Await();
+}
+
+void sharpen::IOutputPipeChannel::PollWriteAsync(sharpen::Future<void> &future)
+{
+    (void)future;
+    throw std::logic_error("poll is not supported");
+}
+
+void sharpen::IOutputPipeChannel::PollWriteAsync()
+{
+    sharpen::AwaitableFuture<void> future;
+    this->PollWriteAsync(future);
+    future.Await();
+}
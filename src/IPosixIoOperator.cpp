@@ -118,6 +118,11 @@ void sharpen::IPosixIoOperator::Execute(sharpen::FileHandle handle,bool &execute
     this->DoExecute(handle,executed,blocking);
 }
 
+bool sharpen::IPosixIoOperator::Empty() const
+{
+    return this->GetRemainingSize() == 0 && this->pendingBufs_.empty();
+}
+
 bool sharpen::IPosixIoOperator::IsBlockingError(sharpen::ErrorCode err)
 {
 #ifdef EAGAIN
@@ -4,6 +4,12 @@
 #include <stdexcept>
 #include <memory>
 
+void sharpen::ISelector::Deregister(sharpen::FileHandle handle)
+{
+    (void)handle;
+    throw std::logic_error("deregister is not supported");
+}
+
 sharpen::SelectorPtr sharpen::MakeDefaultSelector()
 {
 #ifdef SHARPEN_HAS_IOCP
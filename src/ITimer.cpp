@@ -18,5 +18,5 @@ sharpen::TimerPtr sharpen::MakeTimer(sharpen::EventLoop &loop)
 
 sharpen::TimerPtr sharpen::MakeTimer(sharpen::EventEngine &engine)
 {
-    return sharpen::MakeTimer(*engine.RoundRobinLoop());
+    return sharpen::MakeTimer(*engine.SelectLoop());
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include <sharpen/LoopPlacementPolicy.hpp>
+
+#include <cassert>
+
+sharpen::RoundRobinPlacementPolicy::RoundRobinPlacementPolicy() noexcept
+    :pos_(0)
+{}
+
+sharpen::EventLoop *sharpen::RoundRobinPlacementPolicy::SelectLoop(const std::vector<sharpen::EventLoop*> &loops) noexcept
+{
+    assert(!loops.empty());
+    sharpen::Size pos = this->pos_.fetch_add(1,std::memory_order_relaxed);
+    return loops[pos % loops.size()];
+}
+
+sharpen::LeastLoadedPlacementPolicy::LeastLoadedPlacementPolicy() noexcept
+    :LeastLoadedPlacementPolicy(64,1,1)
+{}
+
+sharpen::LeastLoadedPlacementPolicy::LeastLoadedPlacementPolicy(sharpen::Size channelWeight,sharpen::Size taskWeight,sharpen::Size busyWeight) noexcept
+    :pos_(0)
+    ,channelWeight_(channelWeight)
+    ,taskWeight_(taskWeight)
+    ,busyWeight_(busyWeight)
+{}
+
+sharpen::Size sharpen::LeastLoadedPlacementPolicy::Score(const sharpen::EventLoopLoad &load) const noexcept
+{
+    return load.channels_*this->channelWeight_ + load.pendingTasks_*this->taskWeight_ + load.busyRatio_*this->busyWeight_;
+}
+
+sharpen::EventLoop *sharpen::LeastLoadedPlacementPolicy::SelectLoop(const std::vector<sharpen::EventLoop*> &loops) noexcept
+{
+    assert(!loops.empty());
+    //start from a different loop every time
+    //so ties are spread over all loops
+    sharpen::Size begin = this->pos_.fetch_add(1,std::memory_order_relaxed) % loops.size();
+    sharpen::EventLoop *loop = loops[begin];
+    sharpen::Size score = this->Score(loop->GetLoad());
+    for (sharpen::Size i = 1,count = loops.size(); i != count && score != 0; ++i)
+    {
+        sharpen::EventLoop *candidate = loops[(begin + i) % count];
+        sharpen::Size candidateScore = this->Score(candidate->GetLoad());
+        if (candidateScore < score)
+        {
+            loop = candidate;
+            score = candidateScore;
+        }
+    }
+    return loop;
+}
@@ -68,7 +68,6 @@ const char *sharpen::MicroRpcDecoder::RunStateMachine(const char *begin,const ch
         switch (this->step_)
         {
         case Step::WaitMetadata:
-        WaitMetadataLab:
             this->stack_->Push();
             this->stack_->Top().RawData().Reserve(16);
             this->stack_->Top().RawData().PushBack(*begin);
@@ -89,7 +88,7 @@ const char *sharpen::MicroRpcDecoder::RunStateMachine(const char *begin,const ch
             {
                 this->step_ = Step::WaitData;
                 this->ite_ = 1;
-                goto WaitDataLab;
+                continue;
             }
             this->ite_ = this->ite_ == 7 ? 8: this->ite_;
             if(this->ite_ > sizeof(sharpen::Size))
@@ -97,12 +96,12 @@ const char *sharpen::MicroRpcDecoder::RunStateMachine(const char *begin,const ch
                 throw sharpen::MicroRpcParseException("message too large");
             }
             this->step_ = Step::WaitSize;
+            continue;
         case Step::WaitSize:
-            if (this->ite_)
+            this->stack_->Top().RawData().PushBack(*begin);
+            ++begin;
+            if (--this->ite_)
             {
-                this->stack_->Top().RawData().PushBack(*begin);
-                ++begin;
-                --this->ite_;
                 continue;
             }
             this->step_ = Step::WaitData;
@@ -110,9 +109,14 @@ const char *sharpen::MicroRpcDecoder::RunStateMachine(const char *begin,const ch
 #ifdef SHARPEN_IS_BIG_ENDIAN
             sharpen::ConvertEndian(this->stack_.Top().RawData().Data() + 1, this->ite_);
 #endif
+            if (!this->ite_)
+            {
+                this->step_ = Step::Completed;
+                goto CompletedLab;
+            }
             this->stack_->Top().RawData().Reserve(this->ite_ * this->typeSize_);
+            continue;
         case Step::WaitData:
-        WaitDataLab:
             this->stack_->Top().RawData().PushBack(*begin);
             ++begin;
             if(this->typeSize_ == 1 || (++this->record_ == this->typeSize_ && (this->record_ = 0,true)))
@@ -136,7 +140,8 @@ const char *sharpen::MicroRpcDecoder::RunStateMachine(const char *begin,const ch
                 this->completed_ = true;
                 return begin;
             }
-            goto WaitMetadataLab;
+            //begin may be end
+            continue;
         }
     }
     return begin;
@@ -157,4 +162,78 @@ sharpen::Size sharpen::MicroRpcDecoder::Decode(const char *data, sharpen::Size s
     const char *end = data + size;
     begin = this->RunStateMachine(begin,end);
     return begin - data;
+}
+
+sharpen::Size sharpen::MicroRpcDecoder::ComputeFieldSize(const char *data,sharpen::Size size)
+{
+    assert(size);
+    const sharpen::MicroRpcFieldHeader &header = *reinterpret_cast<const sharpen::MicroRpcFieldHeader*>(data);
+    if (header.type_ > 10)
+    {
+        throw sharpen::MicroRpcParseException("unknown type");
+    }
+    if (header.type_ == static_cast<unsigned char>(sharpen::MicroRpcVariableType::Void))
+    {
+        return 1;
+    }
+    sharpen::Size typeSize{sharpen::GetMicroRpcTypeSize(static_cast<sharpen::MicroRpcVariableType>(header.type_))};
+    sharpen::Size sizeSpace{header.sizeSpace_};
+    if (sizeSpace == 0)
+    {
+        return size > typeSize ? typeSize + 1:0;
+    }
+    sizeSpace = sizeSpace == 7 ? 8:sizeSpace;
+    if (sizeSpace > sizeof(sharpen::Size))
+    {
+        throw sharpen::MicroRpcParseException("message too large");
+    }
+    if (size <= sizeSpace)
+    {
+        return 0;
+    }
+    sharpen::Size count{0};
+    std::memcpy(&count,data + 1,sizeSpace);
+    if (count > (static_cast<sharpen::Size>(-1) - sizeSpace - 1)/typeSize)
+    {
+        throw sharpen::MicroRpcParseException("message too large");
+    }
+    sharpen::Size fieldSize{count*typeSize + sizeSpace + 1};
+    return size >= fieldSize ? fieldSize:0;
+}
+
+sharpen::Size sharpen::MicroRpcDecoder::Decode(const sharpen::BufferSlice &buf)
+{
+    assert(this->stack_);
+#ifdef SHARPEN_IS_BIG_ENDIAN
+    //elements must be converted
+    return this->Decode(buf.Data(),buf.GetSize());
+#else
+    const char *data = buf.Data();
+    sharpen::Size size{buf.GetSize()};
+    sharpen::Size offset{0};
+    while (offset != size && !this->completed_)
+    {
+        if (this->step_ == Step::WaitMetadata)
+        {
+            sharpen::Size fieldSize{this->ComputeFieldSize(data + offset,size - offset)};
+            if (fieldSize)
+            {
+                bool last{reinterpret_cast<const sharpen::MicroRpcFieldHeader*>(data + offset)->end_ != 0};
+                this->stack_->Push(buf.Slice(offset,fieldSize));
+                offset += fieldSize;
+                if (last)
+                {
+                    this->stack_->Reverse();
+                    this->completed_ = true;
+                }
+                continue;
+            }
+        }
+        //copy a partial field
+        //until it is completed
+        this->RunStateMachine(data + offset,data + offset + 1);
+        ++offset;
+    }
+    return offset;
+#endif
 }
\ No newline at end of file
@@ -1,5 +1,32 @@
 #include <sharpen/MicroRpcField.hpp>
 
+char *sharpen::MicroRpcField::RawBegin() noexcept
+{
+    if (this->IsSliced())
+    {
+        return this->slice_.Data();
+    }
+    return this->data_.Data();
+}
+
+const char *sharpen::MicroRpcField::RawBegin() const noexcept
+{
+    if (this->IsSliced())
+    {
+        return this->slice_.Data();
+    }
+    return this->data_.Data();
+}
+
+void sharpen::MicroRpcField::Unshare()
+{
+    if (this->IsSliced())
+    {
+        this->data_ = this->slice_.ToByteBuffer();
+        this->slice_.Clear();
+    }
+}
+
 void sharpen::MicroRpcField::InitHeader(sharpen::MicroRpcVariableType type)
 {
     this->data_.Reset();
@@ -18,7 +45,7 @@ char *sharpen::MicroRpcField::ComputeDataBody() noexcept
     {
         size += 1;
     }
-    return this->data_.Data() + size + 1;
+    return this->RawBegin() + size + 1;
 }
 
 const char *sharpen::MicroRpcField::ComputeDataBody() const noexcept
@@ -28,7 +55,7 @@ const char *sharpen::MicroRpcField::ComputeDataBody() const noexcept
     {
         size += 1;
     }
-    return this->data_.Data() + size + 1;
+    return this->RawBegin() + size + 1;
 }
 
 sharpen::Uint64 sharpen::MicroRpcField::GetSize() const
@@ -51,7 +78,7 @@ sharpen::Uint64 sharpen::MicroRpcField::GetSize() const
         throw std::length_error("element count overflow");
     }
     sharpen::Size count{0};
-    std::memcpy(&count, this->data_.Data() + 1, size);
+    std::memcpy(&count, this->RawBegin() + 1, size);
 #ifdef SHARPEN_IS_BIG_ENDIAN
     sharpen::ConvertEndian(&count, size);
 #endif
@@ -64,7 +91,7 @@ void sharpen::MicroRpcField::CopyTo(bool last, char *buf, sharpen::Size size) co
     {
         throw std::length_error("buf too small");
     }
-    std::memcpy(buf, this->RawData().Data(), this->GetRawSize());
+    std::memcpy(buf, this->RawBegin(), this->GetRawSize());
     if (last)
     {
         sharpen::MicroRpcFieldHeader *header = reinterpret_cast<sharpen::MicroRpcFieldHeader *>(buf);
@@ -28,7 +28,7 @@ sharpen::Size sharpen::MicroRpcStack::CopyTo(sharpen::ByteBuffer &buf, sharpen::
     sharpen::Size size{this->ComputeSize() + offset};
     if (buf.GetSize() < size)
     {
-        buf.ExtendTo(size);
+        buf.ExtendToUninitialized(size);
     }
     this->UnsafeCopyTo(buf.Data() + offset);
     return size;
@@ -7,6 +7,7 @@
 #ifdef SHARPEN_IS_WIN
 #include <Windows.h>
 #else
+#include <fcntl.h>
 #include <unistd.h>
 #endif
 
@@ -22,7 +23,12 @@ void sharpen::MakePipeChannel(sharpen::InputPipeChannelPtr &in,sharpen::OutputPi
     }
 #else
     int fd[2];
+#ifdef SHARPEN_IS_LINUX
+    //a blocking pipe stalls the loop when it is full
+    int r = ::pipe2(fd,O_NONBLOCK | O_CLOEXEC);
+#else
     int r = ::pipe(fd);
+#endif
     if(r == -1)
     {
         sharpen::ThrowLastError();
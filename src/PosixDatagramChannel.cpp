@@ -0,0 +1,392 @@
+#include <sharpen/PosixDatagramChannel.hpp>
+
+#ifdef SHARPEN_HAS_POSIXDATAGRAM
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+
+#include <sharpen/SystemError.hpp>
+#include <sharpen/EventLoop.hpp>
+#include <sharpen/IoEvent.hpp>
+
+namespace
+{
+    //room for one pktinfo and one segment size
+    constexpr sharpen::Size controlSize{CMSG_SPACE(sizeof(in6_pktinfo)) + CMSG_SPACE(sizeof(int))};
+}
+
+sharpen::PosixDatagramChannel::PosixDatagramChannel(sharpen::FileHandle handle,int af)
+    :Mybase()
+    ,af_(af)
+    ,readable_(false)
+    ,writeable_(false)
+    ,receiveTasks_()
+    ,sendTasks_()
+    ,msgs_()
+    ,iovs_()
+    ,controls_()
+    ,localPort_(0)
+{
+    assert(handle != -1);
+    this->handle_ = handle;
+    //report the destination address of received datagrams
+    int opt{1};
+    if (af == AF_INET)
+    {
+        ::setsockopt(handle,IPPROTO_IP,IP_PKTINFO,&opt,sizeof(opt));
+    }
+    else
+    {
+        ::setsockopt(handle,IPPROTO_IPV6,IPV6_RECVPKTINFO,&opt,sizeof(opt));
+    }
+}
+
+sharpen::PosixDatagramChannel::~PosixDatagramChannel() noexcept
+{
+    this->DoCancel(ECONNABORTED);
+}
+
+void sharpen::PosixDatagramChannel::PrepareBatch(sharpen::Size count)
+{
+    if (this->msgs_.size() < count)
+    {
+        this->msgs_.resize(count);
+        this->iovs_.resize(count);
+        this->controls_.resize(count*controlSize);
+    }
+    std::memset(this->msgs_.data(),0,count*sizeof(mmsghdr));
+}
+
+void sharpen::PosixDatagramChannel::ParseControl(msghdr &msg,sharpen::Datagram &datagram)
+{
+    for (cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm != nullptr; cm = CMSG_NXTHDR(&msg,cm))
+    {
+        if (cm->cmsg_level == IPPROTO_IP && cm->cmsg_type == IP_PKTINFO)
+        {
+            in_pktinfo info;
+            std::memcpy(&info,CMSG_DATA(cm),sizeof(info));
+            sockaddr_in addr;
+            std::memset(&addr,0,sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_addr = info.ipi_addr;
+            addr.sin_port = this->localPort_;
+            std::memcpy(&datagram.local_,&addr,sizeof(addr));
+            datagram.localLen_ = sizeof(addr);
+        }
+        else if (cm->cmsg_level == IPPROTO_IPV6 && cm->cmsg_type == IPV6_PKTINFO)
+        {
+            in6_pktinfo info;
+            std::memcpy(&info,CMSG_DATA(cm),sizeof(info));
+            sockaddr_in6 addr;
+            std::memset(&addr,0,sizeof(addr));
+            addr.sin6_family = AF_INET6;
+            addr.sin6_addr = info.ipi6_addr;
+            addr.sin6_port = this->localPort_;
+            std::memcpy(&datagram.local_,&addr,sizeof(addr));
+            datagram.localLen_ = sizeof(addr);
+        }
+#ifdef UDP_GRO
+        else if (cm->cmsg_level == IPPROTO_UDP && cm->cmsg_type == UDP_GRO)
+        {
+            int segmentSize;
+            std::memcpy(&segmentSize,CMSG_DATA(cm),sizeof(segmentSize));
+            datagram.segmentSize_ = static_cast<sharpen::Uint16>(segmentSize);
+        }
+#endif
+    }
+}
+
+sharpen::Size sharpen::PosixDatagramChannel::BuildControl(const sharpen::Datagram &datagram,char *control) const noexcept
+{
+    sharpen::Size used{0};
+    if (datagram.localLen_ != 0)
+    {
+        cmsghdr *cm = reinterpret_cast<cmsghdr*>(control);
+        if (this->af_ == AF_INET)
+        {
+            in_pktinfo info;
+            std::memset(&info,0,sizeof(info));
+            info.ipi_spec_dst = reinterpret_cast<const sockaddr_in*>(&datagram.local_)->sin_addr;
+            cm->cmsg_level = IPPROTO_IP;
+            cm->cmsg_type = IP_PKTINFO;
+            cm->cmsg_len = CMSG_LEN(sizeof(info));
+            std::memcpy(CMSG_DATA(cm),&info,sizeof(info));
+            used += CMSG_SPACE(sizeof(info));
+        }
+        else
+        {
+            in6_pktinfo info;
+            std::memset(&info,0,sizeof(info));
+            info.ipi6_addr = reinterpret_cast<const sockaddr_in6*>(&datagram.local_)->sin6_addr;
+            cm->cmsg_level = IPPROTO_IPV6;
+            cm->cmsg_type = IPV6_PKTINFO;
+            cm->cmsg_len = CMSG_LEN(sizeof(info));
+            std::memcpy(CMSG_DATA(cm),&info,sizeof(info));
+            used += CMSG_SPACE(sizeof(info));
+        }
+    }
+#ifdef UDP_SEGMENT
+    if (datagram.segmentSize_ != 0)
+    {
+        cmsghdr *cm = reinterpret_cast<cmsghdr*>(control + used);
+        sharpen::Uint16 segmentSize{datagram.segmentSize_};
+        cm->cmsg_level = IPPROTO_UDP;
+        cm->cmsg_type = UDP_SEGMENT;
+        cm->cmsg_len = CMSG_LEN(sizeof(segmentSize));
+        std::memcpy(CMSG_DATA(cm),&segmentSize,sizeof(segmentSize));
+        used += CMSG_SPACE(sizeof(segmentSize));
+    }
+#endif
+    return used;
+}
+
+void sharpen::PosixDatagramChannel::DoReceive()
+{
+    if (!this->receiveTasks_.empty() && this->localPort_ == 0)
+    {
+        sockaddr_storage addr;
+        socklen_t len{sizeof(addr)};
+        if (::getsockname(this->handle_,reinterpret_cast<sockaddr*>(&addr),&len) == 0)
+        {
+            //the port field has the same offset in both families
+            this->localPort_ = reinterpret_cast<sockaddr_in*>(&addr)->sin_port;
+        }
+    }
+    while (!this->receiveTasks_.empty())
+    {
+        ReceiveTask &task = this->receiveTasks_.front();
+        sharpen::Size count{(std::min)(task.count_,static_cast<sharpen::Size>(SHARPEN_DATAGRAM_BATCH_SIZE))};
+        this->PrepareBatch(count);
+        for (sharpen::Size i = 0; i != count; ++i)
+        {
+            sharpen::Datagram &datagram = task.datagrams_[i];
+            this->iovs_[i].iov_base = datagram.buf_;
+            this->iovs_[i].iov_len = datagram.capacity_;
+            msghdr &hdr = this->msgs_[i].msg_hdr;
+            hdr.msg_name = &datagram.remote_;
+            hdr.msg_namelen = sizeof(datagram.remote_);
+            hdr.msg_iov = &this->iovs_[i];
+            hdr.msg_iovlen = 1;
+            hdr.msg_control = this->controls_.data() + i*controlSize;
+            hdr.msg_controllen = controlSize;
+        }
+        int r = ::recvmmsg(this->handle_,this->msgs_.data(),static_cast<unsigned int>(count),0,nullptr);
+        if (r == -1)
+        {
+            sharpen::ErrorCode err = sharpen::GetLastError();
+            if (err == EAGAIN || err == EWOULDBLOCK)
+            {
+                this->readable_ = false;
+                return;
+            }
+            Callback cb{std::move(task.cb_)};
+            this->receiveTasks_.pop_front();
+            errno = err;
+            cb(-1);
+            continue;
+        }
+        for (int i = 0; i != r; ++i)
+        {
+            sharpen::Datagram &datagram = task.datagrams_[i];
+            msghdr &hdr = this->msgs_[i].msg_hdr;
+            datagram.size_ = (std::min)(static_cast<sharpen::Size>(this->msgs_[i].msg_len),datagram.capacity_);
+            datagram.truncated_ = hdr.msg_flags & MSG_TRUNC;
+            datagram.remoteLen_ = hdr.msg_namelen;
+            datagram.localLen_ = 0;
+            datagram.segmentSize_ = 0;
+            this->ParseControl(hdr,datagram);
+        }
+        Callback cb{std::move(task.cb_)};
+        this->receiveTasks_.pop_front();
+        cb(r);
+    }
+}
+
+void sharpen::PosixDatagramChannel::DoSend()
+{
+    while (!this->sendTasks_.empty())
+    {
+        SendTask &task = this->sendTasks_.front();
+        sharpen::Size count{(std::min)(task.count_ - task.sent_,static_cast<sharpen::Size>(SHARPEN_DATAGRAM_BATCH_SIZE))};
+        this->PrepareBatch(count);
+        for (sharpen::Size i = 0; i != count; ++i)
+        {
+            const sharpen::Datagram &datagram = task.datagrams_[task.sent_ + i];
+            this->iovs_[i].iov_base = datagram.buf_;
+            this->iovs_[i].iov_len = datagram.size_;
+            msghdr &hdr = this->msgs_[i].msg_hdr;
+            if (datagram.remoteLen_ != 0)
+            {
+                hdr.msg_name = const_cast<sockaddr_storage*>(&datagram.remote_);
+                hdr.msg_namelen = datagram.remoteLen_;
+            }
+            hdr.msg_iov = &this->iovs_[i];
+            hdr.msg_iovlen = 1;
+            char *control = this->controls_.data() + i*controlSize;
+            sharpen::Size used{this->BuildControl(datagram,control)};
+            if (used != 0)
+            {
+                hdr.msg_control = control;
+                hdr.msg_controllen = used;
+            }
+        }
+        int r = ::sendmmsg(this->handle_,this->msgs_.data(),static_cast<unsigned int>(count),0);
+        if (r == -1)
+        {
+            sharpen::ErrorCode err = sharpen::GetLastError();
+            if (err == EAGAIN || err == EWOULDBLOCK)
+            {
+                this->writeable_ = false;
+                return;
+            }
+            //report the datagrams sent before the error
+            Callback cb{std::move(task.cb_)};
+            sharpen::Size sent{task.sent_};
+            this->sendTasks_.pop_front();
+            errno = err;
+            cb(sent != 0 ? static_cast<ssize_t>(sent):-1);
+            continue;
+        }
+        task.sent_ += static_cast<sharpen::Size>(r);
+        if (task.sent_ == task.count_)
+        {
+            Callback cb{std::move(task.cb_)};
+            sharpen::Size sent{task.sent_};
+            this->sendTasks_.pop_front();
+            cb(static_cast<ssize_t>(sent));
+        }
+    }
+}
+
+void sharpen::PosixDatagramChannel::TryReceive(sharpen::Datagram *datagrams,sharpen::Size count,Callback cb)
+{
+    ReceiveTask task;
+    task.datagrams_ = datagrams;
+    task.count_ = count;
+    task.cb_ = std::move(cb);
+    this->receiveTasks_.push_back(std::move(task));
+    if (this->readable_)
+    {
+        this->DoReceive();
+    }
+}
+
+void sharpen::PosixDatagramChannel::TrySend(const sharpen::Datagram *datagrams,sharpen::Size count,Callback cb)
+{
+    SendTask task;
+    task.datagrams_ = datagrams;
+    task.count_ = count;
+    task.sent_ = 0;
+    task.cb_ = std::move(cb);
+    this->sendTasks_.push_back(std::move(task));
+    if (this->writeable_)
+    {
+        this->DoSend();
+    }
+}
+
+void sharpen::PosixDatagramChannel::RequestReceive(sharpen::Datagram *datagrams,sharpen::Size count,sharpen::Future<sharpen::Size> *future)
+{
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<sharpen::Size> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixDatagramChannel::CompleteIoCallback),this,future,std::placeholders::_1);
+    this->loop_->RunInLoop(std::bind(&sharpen::PosixDatagramChannel::TryReceive,this,datagrams,count,std::move(cb)));
+}
+
+void sharpen::PosixDatagramChannel::RequestSend(const sharpen::Datagram *datagrams,sharpen::Size count,sharpen::Future<sharpen::Size> *future)
+{
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<sharpen::Size> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixDatagramChannel::CompleteIoCallback),this,future,std::placeholders::_1);
+    this->loop_->RunInLoop(std::bind(&sharpen::PosixDatagramChannel::TrySend,this,datagrams,count,std::move(cb)));
+}
+
+void sharpen::PosixDatagramChannel::CompleteIoCallback(sharpen::IChannel *channel,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept
+{
+    sharpen::EventLoop *loop{channel->GetLoop()};
+    if (size == -1)
+    {
+        loop->RunInLoopSoon(std::bind(&sharpen::Future<sharpen::Size>::Fail,future,sharpen::MakeLastErrorPtr()));
+        return;
+    }
+    loop->RunInLoopSoon(std::bind(&sharpen::Future<sharpen::Size>::CompleteForBind,future,static_cast<sharpen::Size>(size)));
+}
+
+void sharpen::PosixDatagramChannel::ReceiveManyAsync(sharpen::Datagram *datagrams,sharpen::Size count,sharpen::Future<sharpen::Size> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    if (count == 0)
+    {
+        throw std::invalid_argument("count could not be 0");
+    }
+    this->RequestReceive(datagrams,count,&future);
+}
+
+void sharpen::PosixDatagramChannel::SendManyAsync(const sharpen::Datagram *datagrams,sharpen::Size count,sharpen::Future<sharpen::Size> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    if (count == 0)
+    {
+        throw std::invalid_argument("count could not be 0");
+    }
+    this->RequestSend(datagrams,count,&future);
+}
+
+bool sharpen::PosixDatagramChannel::SetReceiveOffload(bool val) noexcept
+{
+#ifdef UDP_GRO
+    int opt = val ? 1:0;
+    return ::setsockopt(this->handle_,IPPROTO_UDP,UDP_GRO,&opt,sizeof(opt)) == 0;
+#else
+    (void)val;
+    return false;
+#endif
+}
+
+void sharpen::PosixDatagramChannel::OnEvent(sharpen::IoEvent *event)
+{
+    if (event->IsReadEvent() || event->IsErrorEvent())
+    {
+        this->readable_ = true;
+        this->DoReceive();
+    }
+    if (event->IsWriteEvent() || event->IsErrorEvent())
+    {
+        this->writeable_ = true;
+        this->DoSend();
+    }
+}
+
+void sharpen::PosixDatagramChannel::DoCancel(sharpen::ErrorCode err) noexcept
+{
+    while (!this->receiveTasks_.empty())
+    {
+        Callback cb{std::move(this->receiveTasks_.front().cb_)};
+        this->receiveTasks_.pop_front();
+        errno = err;
+        cb(-1);
+    }
+    while (!this->sendTasks_.empty())
+    {
+        Callback cb{std::move(this->sendTasks_.front().cb_)};
+        this->sendTasks_.pop_front();
+        errno = err;
+        cb(-1);
+    }
+}
+
+void sharpen::PosixDatagramChannel::Cancel() noexcept
+{
+    this->loop_->RunInLoopSoon(std::bind(&sharpen::PosixDatagramChannel::DoCancel,this,ECANCELED));
+}
+
+#endif
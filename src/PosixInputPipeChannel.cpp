@@ -2,12 +2,23 @@
 #ifdef SHARPEN_HAS_POSIXINPUTPIPE
 
 #include <cassert>
+#include <climits>
 #include <stdexcept>
+#include <system_error>
+
+#ifdef SHARPEN_HAS_PIPESPLICE
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#endif
+
+#include <sharpen/IOutputPipeChannel.hpp>
 
 sharpen::PosixInputPipeChannel::PosixInputPipeChannel(sharpen::FileHandle handle)
     :Mybase()
     ,reader_()
     ,readable_(false)
+    ,orderedReads_()
+    ,teeWaiting_(false)
 {
     assert(handle != -1);
     this->handle_ = handle;
@@ -16,6 +27,13 @@ sharpen::PosixInputPipeChannel::PosixInputPipeChannel(sharpen::FileHandle handle
 sharpen::PosixInputPipeChannel::~PosixInputPipeChannel() noexcept
 {
     this->reader_.CancelAllIo(ECANCELED);
+    while (!this->orderedReads_.empty())
+    {
+        Callback cb{std::move(this->orderedReads_.front().cb_)};
+        this->orderedReads_.pop_front();
+        errno = ECANCELED;
+        cb(-1);
+    }
 }
 
 void sharpen::PosixInputPipeChannel::HandleRead()
@@ -27,13 +45,157 @@ void sharpen::PosixInputPipeChannel::DoRead()
 {
     bool executed;
     bool blocking;
-    this->reader_.Execute(this->handle_,executed,blocking);
-    this->readable_ = !executed || !blocking;
+    while (true)
+    {
+        this->reader_.Execute(this->handle_,executed,blocking);
+        this->readable_ = !executed || !blocking;
+        if (!this->readable_ || this->orderedReads_.empty() || !this->reader_.Empty())
+        {
+            return;
+        }
+        this->DoOrderedRead();
+        //reads behind a tee go to the reader
+        if (!this->readable_ || this->reader_.Empty())
+        {
+            return;
+        }
+    }
+}
+
+void sharpen::PosixInputPipeChannel::DoOrderedRead()
+{
+    while (!this->orderedReads_.empty())
+    {
+        OrderedRead &read = this->orderedReads_.front();
+        if (!read.to_)
+        {
+            this->reader_.AddPendingTask(read.buf_,read.size_,std::move(read.cb_));
+            this->orderedReads_.pop_front();
+            continue;
+        }
+        if (!this->reader_.Empty() || !this->DoTee(read))
+        {
+            return;
+        }
+    }
+}
+
+bool sharpen::PosixInputPipeChannel::DoTee(OrderedRead &read)
+{
+    if (this->teeWaiting_)
+    {
+        return false;
+    }
+#ifdef SHARPEN_HAS_PIPESPLICE
+    ssize_t size = ::tee(this->handle_,read.to_->GetHandle(),read.size_,SPLICE_F_NONBLOCK);
+    if (size == -1 && sharpen::IPosixIoOperator::IsBlockingError(sharpen::GetLastError()))
+    {
+        //EAGAIN comes from either pipe
+        int available{0};
+        if (::ioctl(this->handle_,FIONREAD,&available) == 0 && available == 0)
+        {
+            this->readable_ = false;
+            return false;
+        }
+        //the destination is full
+        this->WaitTee(*read.to_);
+        return false;
+    }
+#else
+    ssize_t size{-1};
+    errno = ENOTSUP;
+#endif
+    Callback cb{std::move(read.cb_)};
+    this->orderedReads_.pop_front();
+    cb(size);
+    return true;
+}
+
+void sharpen::PosixInputPipeChannel::WaitTee(sharpen::IOutputPipeChannel &to)
+{
+    this->teeWaiting_ = true;
+    sharpen::FuturePtr<void> future{sharpen::MakeFuturePtr<void>()};
+    std::weak_ptr<sharpen::IChannel> self{this->shared_from_this()};
+    //the future keeps itself alive until to completes it
+    future->SetCallback([self,future](sharpen::Future<void> &wait)
+    {
+        std::exception_ptr err{wait.Error()};
+        sharpen::ChannelPtr channel{self.lock()};
+        if (!channel || !channel->IsRegistered())
+        {
+            return;
+        }
+        sharpen::EventLoop *loop{channel->GetLoop()};
+        loop->RunInLoopSoon(std::bind(&sharpen::PosixInputPipeChannel::HandleTeeWait,std::static_pointer_cast<sharpen::PosixInputPipeChannel>(channel),err));
+    });
+    try
+    {
+        to.PollWriteAsync(*future);
+    }
+    catch(const std::exception&)
+    {
+        future->Fail(std::current_exception());
+    }
+}
+
+void sharpen::PosixInputPipeChannel::HandleTeeWait(std::exception_ptr err)
+{
+    this->teeWaiting_ = false;
+    if (err)
+    {
+        assert(!this->orderedReads_.empty() && this->orderedReads_.front().to_);
+        Callback cb{std::move(this->orderedReads_.front().cb_)};
+        this->orderedReads_.pop_front();
+        try
+        {
+            std::rethrow_exception(err);
+        }
+        catch(const std::system_error &e)
+        {
+            errno = e.code().value();
+        }
+        catch(const std::exception&)
+        {
+            errno = ENOTSUP;
+        }
+        cb(-1);
+    }
+    if (this->readable_)
+    {
+        this->DoRead();
+    }
 }
 
 void sharpen::PosixInputPipeChannel::TryRead(char *buf,sharpen::Size bufSize,Callback cb)
 {
-    this->reader_.AddPendingTask(buf,bufSize,std::move(cb));
+    if (this->orderedReads_.empty())
+    {
+        this->reader_.AddPendingTask(buf,bufSize,std::move(cb));
+    }
+    else
+    {
+        //keep the order behind tees
+        OrderedRead read;
+        read.buf_ = buf;
+        read.size_ = bufSize;
+        read.cb_ = std::move(cb);
+        read.to_ = nullptr;
+        this->orderedReads_.push_back(std::move(read));
+    }
+    if(this->readable_)
+    {
+        this->DoRead();
+    }
+}
+
+void sharpen::PosixInputPipeChannel::TryTee(sharpen::IOutputPipeChannel *to,sharpen::Size size,Callback cb)
+{
+    OrderedRead read;
+    read.buf_ = nullptr;
+    read.size_ = size;
+    read.cb_ = std::move(cb);
+    read.to_ = to;
+    this->orderedReads_.push_back(std::move(read));
     if(this->readable_)
     {
         this->DoRead();
@@ -42,8 +204,8 @@ void sharpen::PosixInputPipeChannel::TryRead(char *buf,sharpen::Size bufSize,Cal
 
 void sharpen::PosixInputPipeChannel::RequestRead(char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> *future)
 {
-    using FnPtr = void(*)(sharpen::EventLoop *,sharpen::Future<sharpen::Size> *,ssize_t);
-    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixInputPipeChannel::CompleteReadCallback),this->loop_,future,std::placeholders::_1);
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<sharpen::Size> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixInputPipeChannel::CompleteReadCallback),this,future,std::placeholders::_1);
     this->loop_->RunInLoop(std::bind(&sharpen::PosixInputPipeChannel::TryRead,this,buf,bufSize,std::move(cb)));
 }
 
@@ -73,8 +235,9 @@ void sharpen::PosixInputPipeChannel::OnEvent(sharpen::IoEvent *event)
     }
 }
 
-void sharpen::PosixInputPipeChannel::CompleteReadCallback(sharpen::EventLoop *loop,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept
+void sharpen::PosixInputPipeChannel::CompleteReadCallback(sharpen::IChannel *channel,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept
 {
+    sharpen::EventLoop *loop{channel->GetLoop()};
     if(size == -1)
     {
         loop->RunInLoopSoon(std::bind(&sharpen::Future<sharpen::Size>::Fail,future,sharpen::MakeLastErrorPtr()));
@@ -82,4 +245,45 @@ void sharpen::PosixInputPipeChannel::CompleteReadCallback(sharpen::EventLoop *lo
     }
     loop->RunInLoopSoon(std::bind(&sharpen::Future<sharpen::Size>::CompleteForBind,future,static_cast<sharpen::Size>(size)));
 }
+
+#ifdef SHARPEN_HAS_PIPESPLICE
+sharpen::Size sharpen::PosixInputPipeChannel::SetPipeSize(sharpen::Size size)
+{
+    if (size > INT_MAX)
+    {
+        throw std::invalid_argument("pipe size is too large");
+    }
+    int r = ::fcntl(this->handle_,F_SETPIPE_SZ,static_cast<int>(size));
+    if (r == -1)
+    {
+        sharpen::ThrowLastError();
+    }
+    return static_cast<sharpen::Size>(r);
+}
+
+sharpen::Size sharpen::PosixInputPipeChannel::GetPipeSize() const noexcept
+{
+    int r = ::fcntl(this->handle_,F_GETPIPE_SZ);
+    if (r == -1)
+    {
+        return 0;
+    }
+    return static_cast<sharpen::Size>(r);
+}
+
+void sharpen::PosixInputPipeChannel::TeeAsync(sharpen::IOutputPipeChannel &to,sharpen::Size size,sharpen::Future<sharpen::Size> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    if (size == 0)
+    {
+        throw std::invalid_argument("size could not be 0");
+    }
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<sharpen::Size> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixInputPipeChannel::CompleteReadCallback),this,&future,std::placeholders::_1);
+    this->loop_->RunInLoop(std::bind(&sharpen::PosixInputPipeChannel::TryTee,this,&to,size,std::move(cb)));
+}
+#endif
 #endif
\ No newline at end of file
@@ -2,72 +2,84 @@
 
 #ifdef SHARPEN_IS_NIX
 
+#include <climits>
+
 void sharpen::PosixIoWriter::DoExecute(sharpen::FileHandle handle,bool &executed,bool &blocking)
 {
-    sharpen::Size size = this->GetRemainingSize();
-    if (size == 0)
-    {
-        blocking = false;
-        executed = false;
-        return;
-    }
-    executed = true;
+    executed = false;
     blocking = false;
-    IoBuffer *bufs = this->GetFirstBuffer();
-    Callback *cbs = this->GetFirstCallback();
-    ssize_t bytes = ::writev(handle,bufs,size);
-    if (bytes == -1)
+    sharpen::Size size = this->GetRemainingSize();
+    while (size != 0)
     {
-        sharpen::ErrorCode err = sharpen::GetLastError();
-        if (sharpen::IPosixIoOperator::IsBlockingError(err))
+        executed = true;
+        //writev fails with EINVAL if it gets more than IOV_MAX buffers
+        if (size > IOV_MAX)
         {
-            blocking = true;
-            return;
+            size = IOV_MAX;
         }
-        for (size_t i = 0; i < size; i++)
+        IoBuffer *bufs = this->GetFirstBuffer();
+        Callback *cbs = this->GetFirstCallback();
+        ssize_t bytes = ::writev(handle,bufs,size);
+        this->calls_ += 1;
+        if (bytes == -1)
         {
-            cbs[i](-1);
+            sharpen::ErrorCode err = sharpen::GetLastError();
+            if (sharpen::IPosixIoOperator::IsBlockingError(err))
+            {
+                blocking = true;
+                return;
+            }
+            for (size_t i = 0; i < size; i++)
+            {
+                errno = err;
+                cbs[i](-1);
+            }
+            size += this->GetMark();
+            this->MoveMark(size);
+            size = this->GetRemainingSize();
+            continue;
         }
-        size += this->GetMark();
-        this->MoveMark(size);
-        return;
-    }
-    else if(bytes == 0)
-    {
-        for (size_t i = 0; i < size; i++)
+        else if(bytes == 0)
         {
-            cbs[i](0);
+            for (size_t i = 0; i < size; i++)
+            {
+                cbs[i](0);
+            }
+            size += this->GetMark();
+            this->MoveMark(size);
+            size = this->GetRemainingSize();
+            continue;
         }
-        size += this->GetMark();
-        this->MoveMark(size);
-        return;
-    }
-    sharpen::Size completed;
-    sharpen::Size lastSize;
-    this->ConvertByteToBufferNumber(bytes,completed,lastSize);
-    for (size_t i = 0; i < completed; i++)
-    {
-        cbs[i](bufs[i].iov_len);
-    }
-    sharpen::Size lastBufSize = bufs[completed].iov_len;
-    if (lastBufSize != lastSize)
-    {
-        sharpen::Uintptr p = reinterpret_cast<sharpen::Uintptr>(bufs[completed].iov_len);
-        p += lastSize;
-        bufs[completed].iov_base = reinterpret_cast<void*>(p);
-        bufs[completed].iov_len -= lastSize;
-    }
-    else
-    {
-        cbs[completed](lastSize);
-        completed += 1;
-    }
-    completed += this->GetMark();
-    this->MoveMark(completed);
-    size = this->GetRemainingSize();
-    if (size != 0)
-    {
-        blocking = true;
+        sharpen::Size completed;
+        sharpen::Size lastSize;
+        this->ConvertByteToBufferNumber(bytes,completed,lastSize);
+        for (size_t i = 0; i < completed; i++)
+        {
+            cbs[i](bufs[i].iov_len);
+        }
+        sharpen::Size lastBufSize = bufs[completed].iov_len;
+        if (lastBufSize != lastSize)
+        {
+            sharpen::Uintptr p = reinterpret_cast<sharpen::Uintptr>(bufs[completed].iov_base);
+            p += lastSize;
+            bufs[completed].iov_base = reinterpret_cast<void*>(p);
+            bufs[completed].iov_len -= lastSize;
+        }
+        else
+        {
+            cbs[completed](lastSize);
+            completed += 1;
+        }
+        //the socket buffer is full
+        bool partial{completed != size};
+        completed += this->GetMark();
+        this->MoveMark(completed);
+        if (partial)
+        {
+            blocking = true;
+            return;
+        }
+        size = this->GetRemainingSize();
     }
 }
 
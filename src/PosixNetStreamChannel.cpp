@@ -4,11 +4,24 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 
 #include <sys/mman.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
 #include <unistd.h>
 
+#ifdef SHARPEN_IS_LINUX
+#include <linux/errqueue.h>
+#include <fcntl.h>
+#endif
+
+#if (defined (SO_ZEROCOPY)) && (defined (MSG_ZEROCOPY)) && (defined (SO_EE_ORIGIN_ZEROCOPY))
+#define SHARPEN_HAS_ZEROCOPY
+#endif
+
 #include <sharpen/SystemError.hpp>
+#include <sharpen/ObjectPool.hpp>
 #include <sharpen/EventLoop.hpp>
 
 sharpen::PosixNetStreamChannel::PosixNetStreamChannel(sharpen::FileHandle handle)
@@ -22,6 +35,16 @@ sharpen::PosixNetStreamChannel::PosixNetStreamChannel(sharpen::FileHandle handle
     ,connectCb_()
     ,pollReadCbs_()
     ,pollWriteCbs_()
+    ,coalesceWrites_(false)
+    ,flushScheduled_(false)
+    ,highWaterMark_(0)
+    ,pendingWriteBytes_(0)
+    ,parkedWrites_()
+    ,zeroCopyThreshold_(0)
+    ,zeroCopyNextId_(0)
+    ,orderedWrites_()
+    ,zeroCopyInflight_()
+    ,orderedReads_()
 {
     this->handle_ = handle;
 }
@@ -29,6 +52,15 @@ sharpen::PosixNetStreamChannel::PosixNetStreamChannel(sharpen::FileHandle handle
 sharpen::PosixNetStreamChannel::~PosixNetStreamChannel() noexcept
 {
     this->DoCancel(ECONNABORTED);
+    //no notification arrives after this
+    //the kernel may still send their pages
+    while (!this->zeroCopyInflight_.empty())
+    {
+        Callback cb{std::move(this->zeroCopyInflight_.front().cb_)};
+        this->zeroCopyInflight_.pop_front();
+        errno = ECONNABORTED;
+        cb(-1);
+    }
 }
 
 bool sharpen::PosixNetStreamChannel::IsAcceptBlock(sharpen::ErrorCode err) noexcept
@@ -53,14 +85,381 @@ void sharpen::PosixNetStreamChannel::DoRead()
     bool executed;
     this->reader_.Execute(this->handle_,executed,blocking);
     this->readable_ = !executed || !blocking;
+    //ordered reads wait for the bytes read before them
+    if (this->readable_ && !this->orderedReads_.empty() && this->reader_.Empty())
+    {
+        this->DoOrderedRead();
+    }
 }
 
 void sharpen::PosixNetStreamChannel::DoWrite()
 {
     bool blocking;
     bool executed;
-    this->writer_.Execute(this->handle_,executed,blocking);
-    this->writeable_ = !executed || !blocking;
+    while (true)
+    {
+        this->writer_.Execute(this->handle_,executed,blocking);
+        this->writeable_ = !executed || !blocking;
+        //parked writes admitted while blocking go out with the next writev
+        bool admitted{this->AdmitParkedWrites()};
+        if (!this->writeable_)
+        {
+            return;
+        }
+        if (this->orderedWrites_.empty())
+        {
+            if (!admitted)
+            {
+                return;
+            }
+            continue;
+        }
+        //zero copy writes wait for the bytes queued before them
+        if (this->writer_.Empty())
+        {
+            this->DoOrderedWrite();
+            if (!this->writeable_ || this->writer_.Empty())
+            {
+                return;
+            }
+        }
+    }
+}
+
+void sharpen::PosixNetStreamChannel::DoOrderedWrite()
+{
+    while (!this->orderedWrites_.empty())
+    {
+        OrderedWrite &write = this->orderedWrites_.front();
+        if (write.kind_ == sharpen::PosixNetStreamChannel::WriteKind::Copy)
+        {
+            this->QueueWrite(write.buf_,write.size_,std::move(write.cb_));
+            this->orderedWrites_.pop_front();
+            continue;
+        }
+        if (!this->writer_.Empty())
+        {
+            return;
+        }
+        if (write.kind_ == sharpen::PosixNetStreamChannel::WriteKind::Handles)
+        {
+            if (!this->DoSendHandles(write))
+            {
+                return;
+            }
+            continue;
+        }
+        if (write.kind_ == sharpen::PosixNetStreamChannel::WriteKind::Splice)
+        {
+            if (!this->DoSpliceFromPipe(write))
+            {
+                return;
+            }
+            continue;
+        }
+#ifdef SHARPEN_HAS_ZEROCOPY
+        bool zeroCopy{true};
+        ssize_t size = ::send(this->handle_,write.buf_ + write.sent_,write.size_ - write.sent_,MSG_ZEROCOPY | MSG_NOSIGNAL);
+        if (size == -1 && sharpen::GetLastError() == ENOBUFS)
+        {
+            //out of option memory
+            //copy this part instead
+            zeroCopy = false;
+            size = ::send(this->handle_,write.buf_ + write.sent_,write.size_ - write.sent_,MSG_NOSIGNAL);
+        }
+#else
+        bool zeroCopy{false};
+        ssize_t size = ::send(this->handle_,write.buf_ + write.sent_,write.size_ - write.sent_,MSG_NOSIGNAL);
+#endif
+        if (size == -1)
+        {
+            sharpen::ErrorCode err = sharpen::GetLastError();
+            if (sharpen::IPosixIoOperator::IsBlockingError(err))
+            {
+                this->writeable_ = false;
+                return;
+            }
+            Callback cb{std::move(write.cb_)};
+            this->orderedWrites_.pop_front();
+            errno = err;
+            cb(-1);
+            continue;
+        }
+        //copied sends consume no notification id
+        if (zeroCopy)
+        {
+            if (write.calls_ == 0)
+            {
+                write.firstId_ = this->zeroCopyNextId_;
+            }
+            this->zeroCopyNextId_ += 1;
+            write.calls_ += 1;
+        }
+        write.sent_ += static_cast<sharpen::Size>(size);
+        if (write.sent_ != write.size_)
+        {
+            continue;
+        }
+        if (write.released_ == write.calls_)
+        {
+            Callback cb{std::move(write.cb_)};
+            sharpen::Size bufSize{write.size_};
+            this->orderedWrites_.pop_front();
+            cb(bufSize);
+            continue;
+        }
+        this->zeroCopyInflight_.push_back(std::move(write));
+        this->orderedWrites_.pop_front();
+    }
+}
+
+bool sharpen::PosixNetStreamChannel::DoSendHandles(OrderedWrite &write)
+{
+    iovec io;
+    io.iov_base = write.buf_;
+    io.iov_len = write.size_;
+    std::vector<char> control(CMSG_SPACE(write.handles_.size()*sizeof(sharpen::FileHandle)),0);
+    msghdr msg;
+    std::memset(&msg,0,sizeof(msg));
+    msg.msg_iov = &io;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+    cmsghdr *cm = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level = SOL_SOCKET;
+    cm->cmsg_type = SCM_RIGHTS;
+    cm->cmsg_len = CMSG_LEN(write.handles_.size()*sizeof(sharpen::FileHandle));
+    std::memcpy(CMSG_DATA(cm),write.handles_.data(),write.handles_.size()*sizeof(sharpen::FileHandle));
+    ssize_t size = ::sendmsg(this->handle_,&msg,MSG_NOSIGNAL);
+    if (size == -1)
+    {
+        sharpen::ErrorCode err = sharpen::GetLastError();
+        if (sharpen::IPosixIoOperator::IsBlockingError(err))
+        {
+            this->writeable_ = false;
+            return false;
+        }
+        errno = err;
+    }
+    //the handles are sent with the first byte
+    Callback cb{std::move(write.cb_)};
+    this->orderedWrites_.pop_front();
+    cb(size);
+    return true;
+}
+
+void sharpen::PosixNetStreamChannel::DoOrderedRead()
+{
+    while (!this->orderedReads_.empty())
+    {
+        OrderedRead &read = this->orderedReads_.front();
+        bool completed{read.kind_ == sharpen::PosixNetStreamChannel::ReadKind::Handles ? this->DoReceiveHandles(read):this->DoSpliceToPipe(read)};
+        if (!completed)
+        {
+            return;
+        }
+    }
+}
+
+bool sharpen::PosixNetStreamChannel::DoReceiveHandles(OrderedRead &read)
+{
+    char marker;
+    iovec io;
+    io.iov_base = &marker;
+    io.iov_len = sizeof(marker);
+    std::vector<char> control(CMSG_SPACE(read.count_*sizeof(sharpen::FileHandle)),0);
+    msghdr msg;
+    std::memset(&msg,0,sizeof(msg));
+    msg.msg_iov = &io;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+    ssize_t size = ::recvmsg(this->handle_,&msg,MSG_CMSG_CLOEXEC);
+    if (size == -1)
+    {
+        sharpen::ErrorCode err = sharpen::GetLastError();
+        if (sharpen::IPosixIoOperator::IsBlockingError(err))
+        {
+            this->readable_ = false;
+            return false;
+        }
+        Callback cb{std::move(read.cb_)};
+        this->orderedReads_.pop_front();
+        errno = err;
+        cb(-1);
+        return true;
+    }
+    //handles that do not fit are closed by the kernel
+    sharpen::Size count{0};
+    for (cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm != nullptr; cm = CMSG_NXTHDR(&msg,cm))
+    {
+        if (cm->cmsg_level != SOL_SOCKET || cm->cmsg_type != SCM_RIGHTS)
+        {
+            continue;
+        }
+        sharpen::Size number{(cm->cmsg_len - CMSG_LEN(0))/sizeof(sharpen::FileHandle)};
+        for (sharpen::Size i = 0; i != number; ++i)
+        {
+            sharpen::FileHandle handle;
+            std::memcpy(&handle,CMSG_DATA(cm) + i*sizeof(handle),sizeof(handle));
+            if (count != read.count_)
+            {
+                read.handles_[count++] = handle;
+                continue;
+            }
+            ::close(handle);
+        }
+    }
+    Callback cb{std::move(read.cb_)};
+    this->orderedReads_.pop_front();
+    cb(static_cast<ssize_t>(count));
+    return true;
+}
+
+bool sharpen::PosixNetStreamChannel::DoSpliceToPipe(OrderedRead &read)
+{
+#ifdef SHARPEN_HAS_SPLICE
+    //the pipe has room so EAGAIN comes from the socket
+    ssize_t size = ::splice(this->handle_,nullptr,read.pipe_,nullptr,read.count_,SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (size == -1)
+    {
+        sharpen::ErrorCode err = sharpen::GetLastError();
+        if (sharpen::IPosixIoOperator::IsBlockingError(err))
+        {
+            this->readable_ = false;
+            return false;
+        }
+        errno = err;
+    }
+#else
+    ssize_t size{-1};
+    errno = ENOTSUP;
+#endif
+    Callback cb{std::move(read.cb_)};
+    this->orderedReads_.pop_front();
+    cb(size);
+    return true;
+}
+
+bool sharpen::PosixNetStreamChannel::DoSpliceFromPipe(OrderedWrite &write)
+{
+#ifdef SHARPEN_HAS_SPLICE
+    while (write.sent_ != write.size_)
+    {
+        //the pipe holds the bytes so EAGAIN comes from the socket
+        ssize_t size = ::splice(write.pipe_,nullptr,this->handle_,nullptr,write.size_ - write.sent_,SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (size == -1)
+        {
+            sharpen::ErrorCode err = sharpen::GetLastError();
+            if (sharpen::IPosixIoOperator::IsBlockingError(err))
+            {
+                this->writeable_ = false;
+                return false;
+            }
+            Callback cb{std::move(write.cb_)};
+            this->orderedWrites_.pop_front();
+            errno = err;
+            cb(-1);
+            return true;
+        }
+        if (size == 0)
+        {
+            //the pipe is empty and has no writer
+            break;
+        }
+        write.sent_ += static_cast<sharpen::Size>(size);
+    }
+    ssize_t size{static_cast<ssize_t>(write.sent_)};
+#else
+    ssize_t size{-1};
+    errno = ENOTSUP;
+#endif
+    Callback cb{std::move(write.cb_)};
+    this->orderedWrites_.pop_front();
+    cb(size);
+    return true;
+}
+
+void sharpen::PosixNetStreamChannel::ReleaseZeroCopyIds(OrderedWrite &write,sharpen::Uint32 first,sharpen::Uint32 last) noexcept
+{
+    //ids wrap around
+    for (sharpen::Uint32 i = 0; i != write.calls_; ++i)
+    {
+        sharpen::Uint32 id{write.firstId_ + i};
+        if (static_cast<sharpen::Uint32>(id - first) <= static_cast<sharpen::Uint32>(last - first))
+        {
+            write.released_ += 1;
+        }
+    }
+}
+
+void sharpen::PosixNetStreamChannel::ReleaseZeroCopyIds(sharpen::Uint32 first,sharpen::Uint32 last) noexcept
+{
+    //the write being sent may own released ids too
+    if (!this->orderedWrites_.empty())
+    {
+        sharpen::PosixNetStreamChannel::ReleaseZeroCopyIds(this->orderedWrites_.front(),first,last);
+    }
+    for (auto begin = this->zeroCopyInflight_.begin(),end = this->zeroCopyInflight_.end(); begin != end; ++begin)
+    {
+        sharpen::PosixNetStreamChannel::ReleaseZeroCopyIds(*begin,first,last);
+    }
+}
+
+void sharpen::PosixNetStreamChannel::HandleErrorQueue()
+{
+#ifdef SHARPEN_HAS_ZEROCOPY
+    if (this->zeroCopyInflight_.empty() && this->orderedWrites_.empty())
+    {
+        return;
+    }
+    char control[128];
+    while (true)
+    {
+        msghdr msg;
+        std::memset(&msg,0,sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (::recvmsg(this->handle_,&msg,MSG_ERRQUEUE) == -1)
+        {
+            break;
+        }
+        for (cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm != nullptr; cm = CMSG_NXTHDR(&msg,cm))
+        {
+            bool recvErr{(cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) || (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR)};
+            if (!recvErr)
+            {
+                continue;
+            }
+            const sock_extended_err *err = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cm));
+            if (err->ee_errno == 0 && err->ee_origin == SO_EE_ORIGIN_ZEROCOPY)
+            {
+                //[ee_info,ee_data] is the range of released ids
+                this->ReleaseZeroCopyIds(err->ee_info,err->ee_data);
+            }
+        }
+    }
+    //complete the writes whose buffers are released
+    for (auto begin = this->zeroCopyInflight_.begin(); begin != this->zeroCopyInflight_.end();)
+    {
+        if (begin->released_ != begin->calls_)
+        {
+            ++begin;
+            continue;
+        }
+        Callback cb{std::move(begin->cb_)};
+        sharpen::Size size{begin->size_};
+        sharpen::ErrorCode err{begin->err_};
+        begin = this->zeroCopyInflight_.erase(begin);
+        if (err)
+        {
+            errno = err;
+            cb(-1);
+            continue;
+        }
+        cb(size);
+    }
+#endif
 }
 
 void sharpen::PosixNetStreamChannel::DoPollRead()
@@ -173,15 +572,198 @@ void sharpen::PosixNetStreamChannel::TryRead(char *buf,sharpen::Size bufSize,Cal
     }
 }
 
-void sharpen::PosixNetStreamChannel::TryWrite(const char *buf,sharpen::Size bufSize,Callback cb)
+void sharpen::PosixNetStreamChannel::QueueWrite(char *buf,sharpen::Size bufSize,Callback cb)
+{
+    if (!this->highWaterMark_)
+    {
+        this->writer_.AddPendingTask(buf,bufSize,std::move(cb));
+        return;
+    }
+    //keep the order of parked writes
+    if (!this->parkedWrites_.empty() || this->pendingWriteBytes_ >= this->highWaterMark_)
+    {
+        ParkedWrite write;
+        write.buf_ = buf;
+        write.size_ = bufSize;
+        write.cb_ = std::move(cb);
+        this->parkedWrites_.push_back(std::move(write));
+        return;
+    }
+    this->AdmitWrite(buf,bufSize,std::move(cb));
+}
+
+void sharpen::PosixNetStreamChannel::AdmitWrite(char *buf,sharpen::Size bufSize,Callback cb)
+{
+    this->pendingWriteBytes_ += bufSize;
+    Callback wrapper = std::bind(&sharpen::PosixNetStreamChannel::CompleteQueuedWrite,this,bufSize,std::move(cb),std::placeholders::_1);
+    this->writer_.AddPendingTask(buf,bufSize,std::move(wrapper));
+}
+
+bool sharpen::PosixNetStreamChannel::AdmitParkedWrites()
 {
-    this->writer_.AddPendingTask(const_cast<char*>(buf),bufSize,std::move(cb));
+    bool admitted{false};
+    //a mark of 0 admits all of them
+    while (!this->parkedWrites_.empty() && (!this->highWaterMark_ || this->pendingWriteBytes_ < this->highWaterMark_))
+    {
+        ParkedWrite &write = this->parkedWrites_.front();
+        this->AdmitWrite(write.buf_,write.size_,std::move(write.cb_));
+        this->parkedWrites_.pop_front();
+        admitted = true;
+    }
+    return admitted;
+}
+
+void sharpen::PosixNetStreamChannel::CompleteQueuedWrite(sharpen::Size bufSize,const Callback &cb,ssize_t size)
+{
+    assert(this->pendingWriteBytes_ >= bufSize);
+    this->pendingWriteBytes_ -= bufSize;
+    cb(size);
+}
+
+void sharpen::PosixNetStreamChannel::StartWrite()
+{
+    if (this->coalesceWrites_)
+    {
+        if (!this->flushScheduled_)
+        {
+            //flush once at the end of this iteration
+            //a migration hands the channel off after this task
+            this->flushScheduled_ = true;
+            std::weak_ptr<sharpen::IChannel> channel{this->shared_from_this()};
+            this->loop_->RunInLoopSoon([channel]()
+            {
+                sharpen::ChannelPtr self{channel.lock()};
+                if (self)
+                {
+                    assert(self->GetLoop() == sharpen::EventLoop::GetLocalLoop());
+                    static_cast<sharpen::PosixNetStreamChannel*>(self.get())->FlushWrites();
+                }
+            });
+        }
+        return;
+    }
     if(this->writeable_)
     {
         this->DoWrite();
     }
 }
 
+void sharpen::PosixNetStreamChannel::FlushWrites()
+{
+    this->flushScheduled_ = false;
+    if (this->writeable_)
+    {
+        this->DoWrite();
+    }
+}
+
+void sharpen::PosixNetStreamChannel::EnqueueWrite(char *buf,sharpen::Size bufSize,Callback cb)
+{
+    bool zeroCopy{this->zeroCopyThreshold_ != 0 && bufSize >= this->zeroCopyThreshold_};
+    if (!zeroCopy && this->orderedWrites_.empty())
+    {
+        this->QueueWrite(buf,bufSize,std::move(cb));
+        return;
+    }
+    //keep the order behind zero copy writes
+    OrderedWrite write;
+    write.buf_ = buf;
+    write.size_ = bufSize;
+    write.sent_ = 0;
+    write.firstId_ = 0;
+    write.calls_ = 0;
+    write.released_ = 0;
+    write.err_ = 0;
+    write.cb_ = std::move(cb);
+    write.kind_ = zeroCopy ? sharpen::PosixNetStreamChannel::WriteKind::ZeroCopy:sharpen::PosixNetStreamChannel::WriteKind::Copy;
+    write.pipe_ = -1;
+    this->orderedWrites_.push_back(std::move(write));
+}
+
+void sharpen::PosixNetStreamChannel::TryWrite(const char *buf,sharpen::Size bufSize,Callback cb)
+{
+    this->EnqueueWrite(const_cast<char*>(buf),bufSize,std::move(cb));
+    this->StartWrite();
+}
+
+void sharpen::PosixNetStreamChannel::TryWriteBuffers(IoBuffers bufs,Callbacks cbs)
+{
+    assert(bufs.size() == cbs.size());
+    //queue all segments together so other writes cannot interleave
+    for (sharpen::Size i = 0; i != bufs.size(); ++i)
+    {
+        this->EnqueueWrite(reinterpret_cast<char*>(bufs[i].iov_base),bufs[i].iov_len,std::move(cbs[i]));
+    }
+    this->StartWrite();
+}
+
+void sharpen::PosixNetStreamChannel::TrySendHandles(std::vector<sharpen::FileHandle> handles,Callback cb)
+{
+    //the marker byte is static so the caller need not keep a buffer
+    static char marker{0};
+    OrderedWrite write;
+    write.buf_ = &marker;
+    write.size_ = sizeof(marker);
+    write.sent_ = 0;
+    write.firstId_ = 0;
+    write.calls_ = 0;
+    write.released_ = 0;
+    write.err_ = 0;
+    write.cb_ = std::move(cb);
+    write.kind_ = sharpen::PosixNetStreamChannel::WriteKind::Handles;
+    write.handles_ = std::move(handles);
+    write.pipe_ = -1;
+    this->orderedWrites_.push_back(std::move(write));
+    this->StartWrite();
+}
+
+void sharpen::PosixNetStreamChannel::TryReceiveHandles(sharpen::FileHandle *handles,sharpen::Size count,Callback cb)
+{
+    OrderedRead read;
+    read.handles_ = handles;
+    read.count_ = count;
+    read.cb_ = std::move(cb);
+    read.kind_ = sharpen::PosixNetStreamChannel::ReadKind::Handles;
+    read.pipe_ = -1;
+    this->orderedReads_.push_back(std::move(read));
+    if (this->readable_ && this->reader_.Empty())
+    {
+        this->DoOrderedRead();
+    }
+}
+
+void sharpen::PosixNetStreamChannel::TrySpliceToPipe(sharpen::FileHandle pipe,sharpen::Size size,Callback cb)
+{
+    OrderedRead read;
+    read.handles_ = nullptr;
+    read.count_ = size;
+    read.cb_ = std::move(cb);
+    read.kind_ = sharpen::PosixNetStreamChannel::ReadKind::Splice;
+    read.pipe_ = pipe;
+    this->orderedReads_.push_back(std::move(read));
+    if (this->readable_ && this->reader_.Empty())
+    {
+        this->DoOrderedRead();
+    }
+}
+
+void sharpen::PosixNetStreamChannel::TrySpliceFromPipe(sharpen::FileHandle pipe,sharpen::Size size,Callback cb)
+{
+    OrderedWrite write;
+    write.buf_ = nullptr;
+    write.size_ = size;
+    write.sent_ = 0;
+    write.firstId_ = 0;
+    write.calls_ = 0;
+    write.released_ = 0;
+    write.err_ = 0;
+    write.cb_ = std::move(cb);
+    write.kind_ = sharpen::PosixNetStreamChannel::WriteKind::Splice;
+    write.pipe_ = pipe;
+    this->orderedWrites_.push_back(std::move(write));
+    this->StartWrite();
+}
+
 void sharpen::PosixNetStreamChannel::TryPollRead(Callback cb)
 {
     this->pollReadCbs_.push_back(std::move(cb));
@@ -240,24 +822,78 @@ void sharpen::PosixNetStreamChannel::TryConnect(const sharpen::IEndPoint &endPoi
         this->connectCb_ = std::move(cb);
         return;
     }
+    //unix domain sockets connect immediately
+    //clear the errno left by other operations
+    errno = 0;
     this->status_ = sharpen::PosixNetStreamChannel::IoStatus::Io;
     cb();
 }
 
 void sharpen::PosixNetStreamChannel::RequestRead(char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> *future)
 {
-    using FnPtr = void(*)(sharpen::EventLoop *,sharpen::Future<sharpen::Size> *,ssize_t);
-    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteIoCallback),this->loop_,future,std::placeholders::_1);
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<sharpen::Size> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteIoCallback),this,future,std::placeholders::_1);
     this->loop_->RunInLoop(std::bind(&sharpen::PosixNetStreamChannel::TryRead,this,buf,bufSize,std::move(cb)));
 }
 
 void sharpen::PosixNetStreamChannel::RequestWrite(const char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> *future)
 {
-    using FnPtr = void(*)(sharpen::EventLoop *,sharpen::Future<sharpen::Size> *,ssize_t);
-    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteIoCallback),this->loop_,future,std::placeholders::_1);
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<sharpen::Size> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteIoCallback),this,future,std::placeholders::_1);
     this->loop_->RunInLoop(std::bind(&sharpen::PosixNetStreamChannel::TryWrite,this,buf,bufSize,std::move(cb)));
 }
 
+void sharpen::PosixNetStreamChannel::RequestWriteChain(const sharpen::BufferChain &chain,sharpen::Future<sharpen::Size> *future)
+{
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<sharpen::Size> *,std::shared_ptr<GatherWriteState>,ssize_t);
+    std::shared_ptr<GatherWriteState> state = std::make_shared<GatherWriteState>();
+    state->pending_ = chain.GetSegmentCount();
+    state->size_ = chain.GetSize();
+    state->completed_ = false;
+    IoBuffers bufs;
+    Callbacks cbs;
+    bufs.reserve(chain.GetSegmentCount());
+    cbs.reserve(chain.GetSegmentCount());
+    for (auto begin = chain.Begin(),end = chain.End(); begin != end; ++begin)
+    {
+        iovec buf;
+        buf.iov_base = const_cast<sharpen::Char*>(begin->Data());
+        buf.iov_len = begin->GetSize();
+        bufs.push_back(buf);
+        cbs.emplace_back(std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteGatherWriteCallback),this,future,state,std::placeholders::_1));
+    }
+    this->loop_->RunInLoop(std::bind(&sharpen::PosixNetStreamChannel::TryWriteBuffers,this,std::move(bufs),std::move(cbs)));
+}
+
+void sharpen::PosixNetStreamChannel::RequestSendHandles(const sharpen::FileHandle *handles,sharpen::Size count,sharpen::Future<void> *future)
+{
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<void> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompletePollCallback),this,future,std::placeholders::_1);
+    std::vector<sharpen::FileHandle> copy{handles,handles + count};
+    this->loop_->RunInLoop(std::bind(&sharpen::PosixNetStreamChannel::TrySendHandles,this,std::move(copy),std::move(cb)));
+}
+
+void sharpen::PosixNetStreamChannel::RequestReceiveHandles(sharpen::FileHandle *handles,sharpen::Size count,sharpen::Future<sharpen::Size> *future)
+{
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<sharpen::Size> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteIoCallback),this,future,std::placeholders::_1);
+    this->loop_->RunInLoop(std::bind(&sharpen::PosixNetStreamChannel::TryReceiveHandles,this,handles,count,std::move(cb)));
+}
+
+void sharpen::PosixNetStreamChannel::RequestSpliceToPipe(sharpen::FileHandle pipe,sharpen::Size size,sharpen::Future<sharpen::Size> *future)
+{
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<sharpen::Size> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteIoCallback),this,future,std::placeholders::_1);
+    this->loop_->RunInLoop(std::bind(&sharpen::PosixNetStreamChannel::TrySpliceToPipe,this,pipe,size,std::move(cb)));
+}
+
+void sharpen::PosixNetStreamChannel::RequestSpliceFromPipe(sharpen::FileHandle pipe,sharpen::Size size,sharpen::Future<sharpen::Size> *future)
+{
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<sharpen::Size> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteIoCallback),this,future,std::placeholders::_1);
+    this->loop_->RunInLoop(std::bind(&sharpen::PosixNetStreamChannel::TrySpliceFromPipe,this,pipe,size,std::move(cb)));
+}
+
 void sharpen::PosixNetStreamChannel::RequestSendFile(sharpen::FileHandle handle,sharpen::Uint64 offset,sharpen::Size size,sharpen::Future<void> *future)
 {
     sharpen::Size memSize = size;
@@ -280,41 +916,42 @@ void sharpen::PosixNetStreamChannel::RequestSendFile(sharpen::FileHandle handle,
     }
     sharpen::Uintptr p = reinterpret_cast<sharpen::Uintptr>(mem);
     p += over;
-    using FnPtr = void (*)(sharpen::EventLoop *,sharpen::Future<void> *,void *,sharpen::Size,ssize_t);
-    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteSendFileCallback),this->loop_,future,mem,memSize,std::placeholders::_1);
+    using FnPtr = void (*)(sharpen::IChannel *,sharpen::Future<void> *,void *,sharpen::Size,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteSendFileCallback),this,future,mem,memSize,std::placeholders::_1);
     this->loop_->RunInLoop(std::bind(&sharpen::PosixNetStreamChannel::TryWrite,this,reinterpret_cast<const char*>(p),size,std::move(cb)));
 }
 
 void sharpen::PosixNetStreamChannel::RequestConnect(const sharpen::IEndPoint &endPoint,sharpen::Future<void> *future)
 {
-    using FnPtr = void (*)(sharpen::EventLoop *,sharpen::Future<void> *);
-    ConnectCallback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteConnectCallback),this->loop_,future);
+    using FnPtr = void (*)(sharpen::IChannel *,sharpen::Future<void> *);
+    ConnectCallback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteConnectCallback),this,future);
     this->loop_->RunInLoop(std::bind(&sharpen::PosixNetStreamChannel::TryConnect,this,std::cref(endPoint),std::move(cb)));
 }
 
 void sharpen::PosixNetStreamChannel::RequestAccept(sharpen::Future<sharpen::NetStreamChannelPtr> *future)
 {
-    using FnPtr = void (*)(sharpen::EventLoop *,sharpen::Future<sharpen::NetStreamChannelPtr> *,sharpen::FileHandle);
-    AcceptCallback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteAcceptCallback),this->loop_,future,std::placeholders::_1);
+    using FnPtr = void (*)(sharpen::IChannel *,sharpen::Future<sharpen::NetStreamChannelPtr> *,sharpen::FileHandle);
+    AcceptCallback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompleteAcceptCallback),this,future,std::placeholders::_1);
     this->loop_->RunInLoop(std::bind(&sharpen::PosixNetStreamChannel::TryAccept,this,std::move(cb)));
 }
 
 void sharpen::PosixNetStreamChannel::RequestPollRead(sharpen::Future<void> *future)
 {
-    using FnPtr = void(*)(sharpen::EventLoop *,sharpen::Future<void> *,ssize_t);
-    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompletePollCallback),this->loop_,future,std::placeholders::_1);
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<void> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompletePollCallback),this,future,std::placeholders::_1);
     this->loop_->RunInLoop(std::bind(&sharpen::PosixNetStreamChannel::TryPollRead,this,std::move(cb)));
 }
 
 void sharpen::PosixNetStreamChannel::RequestPollWrite(sharpen::Future<void> *future)
 {
-    using FnPtr = void(*)(sharpen::EventLoop *,sharpen::Future<void> *,ssize_t);
-    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompletePollCallback),this->loop_,future,std::placeholders::_1);
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<void> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixNetStreamChannel::CompletePollCallback),this,future,std::placeholders::_1);
     this->loop_->RunInLoop(std::bind(&sharpen::PosixNetStreamChannel::TryPollWrite,this,std::move(cb)));
 }
 
-void sharpen::PosixNetStreamChannel::CompleteConnectCallback(sharpen::EventLoop *loop,sharpen::Future<void> *future) noexcept
+void sharpen::PosixNetStreamChannel::CompleteConnectCallback(sharpen::IChannel *channel,sharpen::Future<void> *future) noexcept
 {
+    sharpen::EventLoop *loop{channel->GetLoop()};
     if (sharpen::GetLastError() != 0)
     {
         //connect error
@@ -324,8 +961,9 @@ void sharpen::PosixNetStreamChannel::CompleteConnectCallback(sharpen::EventLoop
     loop->RunInLoopSoon(std::bind(&sharpen::Future<void>::CompleteForBind,future));
 }
 
-void sharpen::PosixNetStreamChannel::CompleteIoCallback(sharpen::EventLoop *loop,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept
+void sharpen::PosixNetStreamChannel::CompleteIoCallback(sharpen::IChannel *channel,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept
 {
+    sharpen::EventLoop *loop{channel->GetLoop()};
     if (size == -1)
     {
         loop->RunInLoopSoon(std::bind(&sharpen::Future<sharpen::Size>::Fail,future,sharpen::MakeLastErrorPtr()));
@@ -334,8 +972,31 @@ void sharpen::PosixNetStreamChannel::CompleteIoCallback(sharpen::EventLoop *loop
     loop->RunInLoopSoon(std::bind(&sharpen::Future<sharpen::Size>::CompleteForBind,future,static_cast<sharpen::Size>(size)));
 }
 
-void sharpen::PosixNetStreamChannel::CompletePollCallback(sharpen::EventLoop *loop,sharpen::Future<void> *future,ssize_t size) noexcept
+void sharpen::PosixNetStreamChannel::CompleteGatherWriteCallback(sharpen::IChannel *channel,sharpen::Future<sharpen::Size> *future,std::shared_ptr<GatherWriteState> state,ssize_t size) noexcept
 {
+    sharpen::EventLoop *loop{channel->GetLoop()};
+    //callbacks run in the loop thread
+    if (state->completed_)
+    {
+        return;
+    }
+    if (size <= 0)
+    {
+        state->completed_ = true;
+        sharpen::PosixNetStreamChannel::CompleteIoCallback(channel,future,size);
+        return;
+    }
+    state->pending_ -= 1;
+    if (state->pending_ == 0)
+    {
+        state->completed_ = true;
+        loop->RunInLoopSoon(std::bind(&sharpen::Future<sharpen::Size>::CompleteForBind,future,state->size_));
+    }
+}
+
+void sharpen::PosixNetStreamChannel::CompletePollCallback(sharpen::IChannel *channel,sharpen::Future<void> *future,ssize_t size) noexcept
+{
+    sharpen::EventLoop *loop{channel->GetLoop()};
     if (size == -1)
     {
         loop->RunInLoopSoon(std::bind(&sharpen::Future<void>::Fail,future,sharpen::MakeLastErrorPtr()));
@@ -344,8 +1005,9 @@ void sharpen::PosixNetStreamChannel::CompletePollCallback(sharpen::EventLoop *lo
     loop->RunInLoopSoon(std::bind(&sharpen::Future<void>::CompleteForBind,future));
 }
 
-void sharpen::PosixNetStreamChannel::CompleteSendFileCallback(sharpen::EventLoop *loop,sharpen::Future<void> *future,void *mem,sharpen::Size memLen,ssize_t size) noexcept
+void sharpen::PosixNetStreamChannel::CompleteSendFileCallback(sharpen::IChannel *channel,sharpen::Future<void> *future,void *mem,sharpen::Size memLen,ssize_t size) noexcept
 {
+    sharpen::EventLoop *loop{channel->GetLoop()};
     ::munmap(mem,memLen);
     if (size == -1)
     {
@@ -355,14 +1017,15 @@ void sharpen::PosixNetStreamChannel::CompleteSendFileCallback(sharpen::EventLoop
     loop->RunInLoopSoon(std::bind(&sharpen::Future<void>::CompleteForBind,future));
 }
 
-void sharpen::PosixNetStreamChannel::CompleteAcceptCallback(sharpen::EventLoop *loop,sharpen::Future<sharpen::NetStreamChannelPtr> *future,sharpen::FileHandle accept) noexcept
+void sharpen::PosixNetStreamChannel::CompleteAcceptCallback(sharpen::IChannel *channel,sharpen::Future<sharpen::NetStreamChannelPtr> *future,sharpen::FileHandle accept) noexcept
 {
+    sharpen::EventLoop *loop{channel->GetLoop()};
     if (accept == -1)
     {
         loop->RunInLoopSoon(std::bind(&sharpen::Future<sharpen::NetStreamChannelPtr>::Fail,future,sharpen::MakeLastErrorPtr()));
         return;
     }
-    loop->RunInLoopSoon(std::bind(&sharpen::Future<sharpen::NetStreamChannelPtr>::CompleteForBind,future,std::make_shared<sharpen::PosixNetStreamChannel>(accept)));
+    loop->RunInLoopSoon(std::bind(&sharpen::Future<sharpen::NetStreamChannelPtr>::CompleteForBind,future,sharpen::ObjectPool<sharpen::PosixNetStreamChannel>::MakeShared(accept)));
 }
 
 
@@ -384,6 +1047,21 @@ void sharpen::PosixNetStreamChannel::WriteAsync(const sharpen::ByteBuffer &buf,s
     this->WriteAsync(buf.Data() + bufferOffset,buf.GetSize() - bufferOffset,future);
 }
 
+void sharpen::PosixNetStreamChannel::WriteAsync(const sharpen::BufferChain &chain,sharpen::Future<sharpen::Size> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    if (chain.GetSegmentCount() < 2)
+    {
+        const sharpen::Char *data = chain.Empty() ? nullptr:chain.GetSegment(0).Data();
+        this->RequestWrite(data,chain.GetSize(),&future);
+        return;
+    }
+    this->RequestWriteChain(chain,&future);
+}
+
 void sharpen::PosixNetStreamChannel::ReadAsync(sharpen::Char *buf, sharpen::Size bufSize, sharpen::Future<sharpen::Size> &future)
 {
     if (!this->IsRegistered())
@@ -404,6 +1082,10 @@ void sharpen::PosixNetStreamChannel::ReadAsync(sharpen::ByteBuffer &buf,sharpen:
 
 void sharpen::PosixNetStreamChannel::OnEvent(sharpen::IoEvent *event)
 {
+    if (event->IsErrorEvent())
+    {
+        this->HandleErrorQueue();
+    }
     if (event->IsReadEvent() || event->IsErrorEvent())
     {
         this->HandleRead();
@@ -486,6 +1168,36 @@ void sharpen::PosixNetStreamChannel::DoCancel(sharpen::ErrorCode err) noexcept
         (*begin)(-1);
     }
     this->pollWriteCbs_.clear();
+    while (!this->parkedWrites_.empty())
+    {
+        Callback cb{std::move(this->parkedWrites_.front().cb_)};
+        this->parkedWrites_.pop_front();
+        errno = err;
+        cb(-1);
+    }
+    //the kernel still holds the pages of a partially sent zero copy write
+    //it fails when they are released
+    if (!this->orderedWrites_.empty() && this->orderedWrites_.front().calls_ != this->orderedWrites_.front().released_)
+    {
+        this->orderedWrites_.front().err_ = err;
+        this->zeroCopyInflight_.push_back(std::move(this->orderedWrites_.front()));
+        this->orderedWrites_.pop_front();
+    }
+    while (!this->orderedWrites_.empty())
+    {
+        Callback cb{std::move(this->orderedWrites_.front().cb_)};
+        this->orderedWrites_.pop_front();
+        errno = err;
+        cb(-1);
+    }
+    //sent zero copy writes are completed by their notifications
+    while (!this->orderedReads_.empty())
+    {
+        Callback cb{std::move(this->orderedReads_.front().cb_)};
+        this->orderedReads_.pop_front();
+        errno = err;
+        cb(-1);
+    }
     AcceptCallback acb;
     std::swap(this->acceptCb_,acb);
     if(acb)
@@ -505,4 +1217,117 @@ void sharpen::PosixNetStreamChannel::Cancel() noexcept
     this->loop_->RunInLoopSoon(std::bind(&sharpen::PosixNetStreamChannel::DoCancel,this,ECANCELED));
 }
 
+void sharpen::PosixNetStreamChannel::SetWriteCoalescing(bool coalesce) noexcept
+{
+    this->coalesceWrites_ = coalesce;
+}
+
+void sharpen::PosixNetStreamChannel::SetWriteHighWaterMark(sharpen::Size mark) noexcept
+{
+    if (!this->loop_)
+    {
+        this->highWaterMark_ = mark;
+        return;
+    }
+    //parked writes belong to the loop thread
+    this->loop_->RunInLoop(std::bind(&sharpen::PosixNetStreamChannel::DoSetWriteHighWaterMark,this,mark));
+}
+
+void sharpen::PosixNetStreamChannel::DoSetWriteHighWaterMark(sharpen::Size mark)
+{
+    this->highWaterMark_ = mark;
+    //parked writes go out ahead of later writes
+    if (this->AdmitParkedWrites())
+    {
+        this->StartWrite();
+    }
+}
+
+sharpen::Size sharpen::PosixNetStreamChannel::GetWriteCallCount() const noexcept
+{
+    return this->writer_.GetCallCount();
+}
+
+sharpen::Size sharpen::PosixNetStreamChannel::GetPendingWriteSize() const noexcept
+{
+    return this->pendingWriteBytes_;
+}
+
+void sharpen::PosixNetStreamChannel::SetZeroCopyThreshold(sharpen::Size threshold) noexcept
+{
+#ifdef SHARPEN_HAS_ZEROCOPY
+    if (threshold != 0)
+    {
+        int val{1};
+        if (::setsockopt(this->handle_,SOL_SOCKET,SO_ZEROCOPY,&val,sizeof(val)) == -1)
+        {
+            //copy instead
+            threshold = 0;
+        }
+    }
+    this->zeroCopyThreshold_ = threshold;
+#else
+    (void)threshold;
+#endif
+}
+
+sharpen::Size sharpen::PosixNetStreamChannel::GetZeroCopyThreshold() const noexcept
+{
+    return this->zeroCopyThreshold_;
+}
+
+void sharpen::PosixNetStreamChannel::SendHandlesAsync(const sharpen::FileHandle *handles,sharpen::Size count,sharpen::Future<void> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    if (count == 0)
+    {
+        throw std::invalid_argument("count could not be 0");
+    }
+    this->RequestSendHandles(handles,count,&future);
+}
+
+void sharpen::PosixNetStreamChannel::ReceiveHandlesAsync(sharpen::FileHandle *handles,sharpen::Size count,sharpen::Future<sharpen::Size> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    if (count == 0)
+    {
+        throw std::invalid_argument("count could not be 0");
+    }
+    this->RequestReceiveHandles(handles,count,&future);
+}
+
+#ifdef SHARPEN_HAS_SPLICE
+void sharpen::PosixNetStreamChannel::SpliceToPipeAsync(sharpen::FileHandle pipe,sharpen::Size size,sharpen::Future<sharpen::Size> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    if (size == 0)
+    {
+        throw std::invalid_argument("size could not be 0");
+    }
+    this->RequestSpliceToPipe(pipe,size,&future);
+}
+
+void sharpen::PosixNetStreamChannel::SpliceFromPipeAsync(sharpen::FileHandle pipe,sharpen::Size size,sharpen::Future<sharpen::Size> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    if (size == 0)
+    {
+        throw std::invalid_argument("size could not be 0");
+    }
+    this->RequestSpliceFromPipe(pipe,size,&future);
+}
+#endif
+
 #endif
\ No newline at end of file
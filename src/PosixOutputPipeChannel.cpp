@@ -3,11 +3,21 @@
 
 #include <stdexcept>
 #include <cassert>
+#include <climits>
+
+#include <poll.h>
+
+#ifdef SHARPEN_HAS_PIPESPLICE
+#include <fcntl.h>
+#include <sys/uio.h>
+#endif
 
 sharpen::PosixOutputPipeChannel::PosixOutputPipeChannel(sharpen::FileHandle handle)
     :Mybase()
     ,writer_()
     ,writeable_(false)
+    ,orderedWrites_()
+    ,pollWriteCbs_()
 {
     assert(handle != -1);
     this->handle_ = handle;
@@ -16,34 +26,171 @@ sharpen::PosixOutputPipeChannel::PosixOutputPipeChannel(sharpen::FileHandle hand
 sharpen::PosixOutputPipeChannel::~PosixOutputPipeChannel() noexcept
 {
     this->writer_.CancelAllIo(ECANCELED);
+    while (!this->orderedWrites_.empty())
+    {
+        Callback cb{std::move(this->orderedWrites_.front().cb_)};
+        this->orderedWrites_.pop_front();
+        errno = ECANCELED;
+        cb(-1);
+    }
+    for (auto begin = this->pollWriteCbs_.begin(),end = this->pollWriteCbs_.end(); begin != end; ++begin)
+    {
+        errno = ECANCELED;
+        (*begin)(-1);
+    }
 }
 
 void sharpen::PosixOutputPipeChannel::DoWrite()
 {
     bool executed;
     bool blocking;
-    this->writer_.Execute(this->handle_,executed,blocking);
-    this->writeable_ = !executed || !blocking;
+    while (true)
+    {
+        this->writer_.Execute(this->handle_,executed,blocking);
+        this->writeable_ = !executed || !blocking;
+        if (!this->writeable_ || this->orderedWrites_.empty() || !this->writer_.Empty())
+        {
+            return;
+        }
+        this->DoOrderedWrite();
+        //copies behind a mapped write go to the writer
+        if (!this->writeable_ || this->writer_.Empty())
+        {
+            return;
+        }
+    }
+}
+
+void sharpen::PosixOutputPipeChannel::DoOrderedWrite()
+{
+    while (!this->orderedWrites_.empty())
+    {
+        OrderedWrite &write = this->orderedWrites_.front();
+        if (!write.map_)
+        {
+            this->writer_.AddPendingTask(write.buf_,write.size_,std::move(write.cb_));
+            this->orderedWrites_.pop_front();
+            continue;
+        }
+        if (!this->writer_.Empty())
+        {
+            return;
+        }
+#ifdef SHARPEN_HAS_PIPESPLICE
+        iovec io;
+        io.iov_base = write.buf_ + write.sent_;
+        io.iov_len = write.size_ - write.sent_;
+        ssize_t size = ::vmsplice(this->handle_,&io,1,SPLICE_F_NONBLOCK);
+#else
+        ssize_t size{-1};
+        errno = ENOTSUP;
+#endif
+        if (size == -1)
+        {
+            sharpen::ErrorCode err = sharpen::GetLastError();
+            if (sharpen::IPosixIoOperator::IsBlockingError(err))
+            {
+                this->writeable_ = false;
+                return;
+            }
+            Callback cb{std::move(write.cb_)};
+            this->orderedWrites_.pop_front();
+            errno = err;
+            cb(-1);
+            continue;
+        }
+        write.sent_ += static_cast<sharpen::Size>(size);
+        if (write.sent_ != write.size_)
+        {
+            continue;
+        }
+        Callback cb{std::move(write.cb_)};
+        sharpen::Size bufSize{write.size_};
+        this->orderedWrites_.pop_front();
+        cb(static_cast<ssize_t>(bufSize));
+    }
+}
+
+void sharpen::PosixOutputPipeChannel::DoPollWrite()
+{
+    if (this->pollWriteCbs_.empty())
+    {
+        return;
+    }
+    //the pipe may be filled by another channel
+    //so writeable_ is not enough
+    pollfd fd;
+    fd.fd = this->handle_;
+    fd.events = POLLOUT;
+    fd.revents = 0;
+    int r = ::poll(&fd,1,0);
+    if (r == 0)
+    {
+        this->writeable_ = false;
+        return;
+    }
+    std::vector<Callback> cbs;
+    std::swap(cbs,this->pollWriteCbs_);
+    for (auto begin = cbs.begin(),end = cbs.end(); begin != end; ++begin)
+    {
+        (*begin)(r == -1 ? -1 : 0);
+    }
 }
 
 void sharpen::PosixOutputPipeChannel::HandleWrite()
 {
     this->DoWrite();
+    this->DoPollWrite();
 }
 
 void sharpen::PosixOutputPipeChannel::TryWrite(const char *buf,sharpen::Size bufSize,Callback cb)
 {
-    this->writer_.AddPendingTask(const_cast<char*>(buf),bufSize,std::move(cb));
+    if (this->orderedWrites_.empty())
+    {
+        this->writer_.AddPendingTask(const_cast<char*>(buf),bufSize,std::move(cb));
+    }
+    else
+    {
+        //keep the order behind mapped writes
+        OrderedWrite write;
+        write.buf_ = const_cast<char*>(buf);
+        write.size_ = bufSize;
+        write.sent_ = 0;
+        write.cb_ = std::move(cb);
+        write.map_ = false;
+        this->orderedWrites_.push_back(std::move(write));
+    }
+    if (this->writeable_)
+    {
+        this->DoWrite();
+    }
+}
+
+void sharpen::PosixOutputPipeChannel::TryVmsplice(const char *buf,sharpen::Size bufSize,Callback cb)
+{
+    OrderedWrite write;
+    write.buf_ = const_cast<char*>(buf);
+    write.size_ = bufSize;
+    write.sent_ = 0;
+    write.cb_ = std::move(cb);
+    write.map_ = true;
+    this->orderedWrites_.push_back(std::move(write));
     if (this->writeable_)
     {
         this->DoWrite();
     }
 }
 
+void sharpen::PosixOutputPipeChannel::TryPollWrite(Callback cb)
+{
+    this->pollWriteCbs_.push_back(std::move(cb));
+    this->DoPollWrite();
+}
+
 void sharpen::PosixOutputPipeChannel::RequestWrite(const char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> *future)
 {
-    using FnPtr = void(*)(sharpen::EventLoop *,sharpen::Future<sharpen::Size>*,ssize_t);
-    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixOutputPipeChannel::CompleteWriteCallback),this->loop_,future,std::placeholders::_1);
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<sharpen::Size>*,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixOutputPipeChannel::CompleteWriteCallback),this,future,std::placeholders::_1);
     this->loop_->RunInLoop(std::bind(&sharpen::PosixOutputPipeChannel::TryWrite,this,buf,bufSize,std::move(cb)));
 }
 
@@ -65,6 +212,17 @@ void sharpen::PosixOutputPipeChannel::WriteAsync(const sharpen::ByteBuffer &buf,
     this->WriteAsync(buf.Data() + bufferOffset,buf.GetSize() - bufferOffset,future);
 }
 
+void sharpen::PosixOutputPipeChannel::PollWriteAsync(sharpen::Future<void> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<void>*,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixOutputPipeChannel::CompletePollCallback),this,&future,std::placeholders::_1);
+    this->loop_->RunInLoop(std::bind(&sharpen::PosixOutputPipeChannel::TryPollWrite,this,std::move(cb)));
+}
+
 void sharpen::PosixOutputPipeChannel::OnEvent(sharpen::IoEvent *event)
 {
     if (event->IsWriteEvent() || event->IsCloseEvent() || event->IsErrorEvent())
@@ -73,8 +231,9 @@ void sharpen::PosixOutputPipeChannel::OnEvent(sharpen::IoEvent *event)
     }
 }
 
-void sharpen::PosixOutputPipeChannel::CompleteWriteCallback(sharpen::EventLoop *loop,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept
+void sharpen::PosixOutputPipeChannel::CompleteWriteCallback(sharpen::IChannel *channel,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept
 {
+    sharpen::EventLoop *loop{channel->GetLoop()};
     if(size == -1)
     {
         loop->RunInLoopSoon(std::bind(&sharpen::Future<sharpen::Size>::Fail,future,sharpen::MakeLastErrorPtr()));
@@ -82,4 +241,56 @@ void sharpen::PosixOutputPipeChannel::CompleteWriteCallback(sharpen::EventLoop *
     }
     loop->RunInLoopSoon(std::bind(&sharpen::Future<sharpen::Size>::CompleteForBind,future,static_cast<sharpen::Size>(size)));
 }
+
+void sharpen::PosixOutputPipeChannel::CompletePollCallback(sharpen::IChannel *channel,sharpen::Future<void> *future,ssize_t size) noexcept
+{
+    sharpen::EventLoop *loop{channel->GetLoop()};
+    if(size == -1)
+    {
+        loop->RunInLoopSoon(std::bind(&sharpen::Future<void>::Fail,future,sharpen::MakeLastErrorPtr()));
+        return;
+    }
+    loop->RunInLoopSoon(std::bind(&sharpen::Future<void>::CompleteForBind,future));
+}
+
+#ifdef SHARPEN_HAS_PIPESPLICE
+sharpen::Size sharpen::PosixOutputPipeChannel::SetPipeSize(sharpen::Size size)
+{
+    if (size > INT_MAX)
+    {
+        throw std::invalid_argument("pipe size is too large");
+    }
+    int r = ::fcntl(this->handle_,F_SETPIPE_SZ,static_cast<int>(size));
+    if (r == -1)
+    {
+        sharpen::ThrowLastError();
+    }
+    return static_cast<sharpen::Size>(r);
+}
+
+sharpen::Size sharpen::PosixOutputPipeChannel::GetPipeSize() const noexcept
+{
+    int r = ::fcntl(this->handle_,F_GETPIPE_SZ);
+    if (r == -1)
+    {
+        return 0;
+    }
+    return static_cast<sharpen::Size>(r);
+}
+
+void sharpen::PosixOutputPipeChannel::VmspliceAsync(const sharpen::Char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    if (bufSize == 0)
+    {
+        throw std::invalid_argument("buffer size could not be 0");
+    }
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<sharpen::Size>*,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::PosixOutputPipeChannel::CompleteWriteCallback),this,&future,std::placeholders::_1);
+    this->loop_->RunInLoop(std::bind(&sharpen::PosixOutputPipeChannel::TryVmsplice,this,buf,bufSize,std::move(cb)));
+}
+#endif
 #endif
\ No newline at end of file
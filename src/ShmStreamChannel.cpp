@@ -0,0 +1,704 @@
+#include <sharpen/ShmStreamChannel.hpp>
+
+#ifdef SHARPEN_HAS_SHMSTREAMCHANNEL
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <sharpen/SystemError.hpp>
+#include <sharpen/EventLoop.hpp>
+#include <sharpen/ObjectPool.hpp>
+
+//the positions only grow
+//the producer owns head_ and the consumer owns tail_
+//a new memfd is zero filled which is the initial state
+struct sharpen::ShmStreamChannel::Ring
+{
+    alignas(64) std::atomic<sharpen::Uint64> head_;
+    std::atomic<sharpen::Uint32> readerWaiting_;
+    std::atomic<sharpen::Uint32> writerClosed_;
+    alignas(64) std::atomic<sharpen::Uint64> tail_;
+    std::atomic<sharpen::Uint32> writerWaiting_;
+    std::atomic<sharpen::Uint32> readerClosed_;
+};
+
+namespace
+{
+    //header | ring 0 | ring 1 | padding | data 0 | data 1
+    constexpr sharpen::Uint64 shmMagic{0x53484d52494e4731};
+
+    constexpr sharpen::Size shmRingOffset{128};
+
+    constexpr sharpen::Size shmRingSize{128};
+
+    constexpr sharpen::Size shmDataOffset{4096};
+
+    constexpr sharpen::Size shmMinCapacity{4096};
+
+    //the size of the memfd is fixed
+    constexpr int shmSeals{F_SEAL_SHRINK | F_SEAL_GROW};
+
+    struct ShmHeader
+    {
+        sharpen::Uint64 magic_;
+        sharpen::Uint64 capacity_;
+    };
+
+    //positions are masked so the capacity must be a power of two
+    bool CheckShmCapacity(sharpen::Uint64 capacity,sharpen::Size memSize) noexcept
+    {
+        if (capacity < shmMinCapacity || (capacity & (capacity - 1)) || memSize < shmDataOffset)
+        {
+            return false;
+        }
+        sharpen::Size dataSize{memSize - shmDataOffset};
+        return dataSize % 2 == 0 && dataSize/2 == capacity;
+    }
+
+    void CopyToRing(char *data,sharpen::Size capacity,sharpen::Uint64 pos,const char *src,sharpen::Size size) noexcept
+    {
+        sharpen::Size offset{static_cast<sharpen::Size>(pos & (capacity - 1))};
+        sharpen::Size first{capacity - offset};
+        if (first > size)
+        {
+            first = size;
+        }
+        std::memcpy(data + offset,src,first);
+        std::memcpy(data,src + first,size - first);
+    }
+
+    void CopyFromRing(const char *data,sharpen::Size capacity,sharpen::Uint64 pos,char *dst,sharpen::Size size) noexcept
+    {
+        sharpen::Size offset{static_cast<sharpen::Size>(pos & (capacity - 1))};
+        sharpen::Size first{capacity - offset};
+        if (first > size)
+        {
+            first = size;
+        }
+        std::memcpy(dst,data + offset,first);
+        std::memcpy(dst + first,data,size - first);
+    }
+
+    sharpen::NetStreamChannelPtr OpenShmStreamChannel(sharpen::FileHandle memfd,sharpen::FileHandle event,sharpen::FileHandle peerEvent,sharpen::Size side)
+    {
+        //the peer could not resize a sealed memfd under our mapping
+        int seals = ::fcntl(memfd,F_GET_SEALS);
+        if (seals == -1 || (seals & shmSeals) != shmSeals)
+        {
+            ::close(event);
+            ::close(peerEvent);
+            throw std::invalid_argument("shared memory ring is not sealed");
+        }
+        struct stat st;
+        if (::fstat(memfd,&st) == -1)
+        {
+            sharpen::ErrorCode err = sharpen::GetLastError();
+            ::close(event);
+            ::close(peerEvent);
+            sharpen::ThrowSystemError(err);
+        }
+        sharpen::Size memSize{static_cast<sharpen::Size>(st.st_size)};
+        void *mem{nullptr};
+        if (memSize >= shmDataOffset)
+        {
+            mem = ::mmap(nullptr,memSize,PROT_READ | PROT_WRITE,MAP_SHARED,memfd,0);
+            if (mem == MAP_FAILED)
+            {
+                sharpen::ErrorCode err = sharpen::GetLastError();
+                ::close(event);
+                ::close(peerEvent);
+                sharpen::ThrowSystemError(err);
+            }
+        }
+        const ShmHeader *header{reinterpret_cast<const ShmHeader*>(mem)};
+        if (!header || header->magic_ != shmMagic || !CheckShmCapacity(header->capacity_,memSize))
+        {
+            if (mem)
+            {
+                ::munmap(mem,memSize);
+            }
+            ::close(event);
+            ::close(peerEvent);
+            throw std::invalid_argument("not a shared memory ring");
+        }
+        return sharpen::ObjectPool<sharpen::ShmStreamChannel>::MakeShared(mem,memSize,event,peerEvent,side);
+    }
+
+    //memfd | event of side 0 | event of side 1
+    void CreateShmRings(sharpen::Size capacity,sharpen::FileHandle *handles)
+    {
+        if (!capacity)
+        {
+            throw std::invalid_argument("capacity could not be 0");
+        }
+        sharpen::Size cap{shmMinCapacity};
+        while (cap < capacity)
+        {
+            cap <<= 1;
+        }
+        handles[0] = ::memfd_create("sharpen-shm",MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (handles[0] == -1)
+        {
+            sharpen::ThrowLastError();
+        }
+        handles[1] = ::eventfd(0,EFD_NONBLOCK | EFD_CLOEXEC);
+        handles[2] = handles[1] != -1 ? ::eventfd(0,EFD_NONBLOCK | EFD_CLOEXEC):-1;
+        if (handles[2] == -1 || ::ftruncate(handles[0],static_cast<off_t>(shmDataOffset + 2*cap)) == -1 || ::fcntl(handles[0],F_ADD_SEALS,shmSeals | F_SEAL_SEAL) == -1)
+        {
+            sharpen::ErrorCode err = sharpen::GetLastError();
+            for (sharpen::Size i = 0; i != 3; ++i)
+            {
+                if (handles[i] != -1)
+                {
+                    ::close(handles[i]);
+                }
+            }
+            sharpen::ThrowSystemError(err);
+        }
+        ShmHeader header;
+        header.magic_ = shmMagic;
+        header.capacity_ = cap;
+        ssize_t size = ::pwrite(handles[0],&header,sizeof(header),0);
+        if (size != static_cast<ssize_t>(sizeof(header)))
+        {
+            sharpen::ErrorCode err = sharpen::GetLastError();
+            for (sharpen::Size i = 0; i != 3; ++i)
+            {
+                ::close(handles[i]);
+            }
+            sharpen::ThrowSystemError(err);
+        }
+    }
+}
+
+sharpen::ShmStreamChannel::ShmStreamChannel(void *mem,sharpen::Size memSize,sharpen::FileHandle event,sharpen::FileHandle peerEvent,sharpen::Size side) noexcept
+    :Mybase()
+    ,mem_(mem)
+    ,memSize_(memSize)
+    ,input_(nullptr)
+    ,output_(nullptr)
+    ,inputData_(nullptr)
+    ,outputData_(nullptr)
+    ,capacity_((memSize - shmDataOffset)/2)
+    ,peerEvent_(peerEvent)
+    ,reads_()
+    ,writes_()
+    ,pollReadCbs_()
+    ,pollWriteCbs_()
+{
+    static_assert(sizeof(Ring) <= shmRingSize,"ring header is too large");
+    assert(side < 2);
+    this->handle_ = event;
+    char *base{reinterpret_cast<char*>(mem)};
+    Ring *rings[2] = {reinterpret_cast<Ring*>(base + shmRingOffset),reinterpret_cast<Ring*>(base + shmRingOffset + shmRingSize)};
+    char *data[2] = {base + shmDataOffset,base + shmDataOffset + this->capacity_};
+    this->output_ = rings[side];
+    this->outputData_ = data[side];
+    this->input_ = rings[1 - side];
+    this->inputData_ = data[1 - side];
+    //tell the peer when the channel is closed
+    this->closer_ = std::bind(&sharpen::ShmStreamChannel::Shutdown,this,std::placeholders::_1);
+}
+
+sharpen::ShmStreamChannel::~ShmStreamChannel() noexcept
+{
+    this->DoCancel(ECONNABORTED);
+    this->Close();
+    ::close(this->peerEvent_);
+    ::munmap(this->mem_,this->memSize_);
+}
+
+void sharpen::ShmStreamChannel::Notify() noexcept
+{
+    sharpen::Uint64 one{1};
+    ssize_t size = ::write(this->peerEvent_,&one,sizeof(one));
+    (void)size;
+}
+
+void sharpen::ShmStreamChannel::Shutdown(sharpen::FileHandle handle) noexcept
+{
+    this->output_->writerClosed_.store(1);
+    this->input_->readerClosed_.store(1);
+    this->Notify();
+    ::close(handle);
+}
+
+sharpen::Size sharpen::ShmStreamChannel::WaitReadable() noexcept
+{
+    sharpen::Uint64 tail{this->input_->tail_.load(std::memory_order_relaxed)};
+    sharpen::Uint64 head{this->input_->head_.load(std::memory_order_acquire)};
+    if (head != tail)
+    {
+        return static_cast<sharpen::Size>(head - tail);
+    }
+    //the flag and the position are sequentially consistent on both sides
+    //so either the writer sees the flag or we see the new head
+    this->input_->readerWaiting_.store(1);
+    head = this->input_->head_.load();
+    if (head != tail)
+    {
+        this->input_->readerWaiting_.store(0,std::memory_order_relaxed);
+    }
+    return static_cast<sharpen::Size>(head - tail);
+}
+
+sharpen::Size sharpen::ShmStreamChannel::WaitWritable() noexcept
+{
+    sharpen::Uint64 head{this->output_->head_.load(std::memory_order_relaxed)};
+    sharpen::Uint64 tail{this->output_->tail_.load(std::memory_order_acquire)};
+    sharpen::Size space{this->capacity_ - static_cast<sharpen::Size>(head - tail)};
+    if (space)
+    {
+        return space;
+    }
+    this->output_->writerWaiting_.store(1);
+    tail = this->output_->tail_.load();
+    space = this->capacity_ - static_cast<sharpen::Size>(head - tail);
+    if (space)
+    {
+        this->output_->writerWaiting_.store(0,std::memory_order_relaxed);
+    }
+    return space;
+}
+
+void sharpen::ShmStreamChannel::DoRead()
+{
+    while (!this->reads_.empty())
+    {
+        ReadTask &task = this->reads_.front();
+        sharpen::Size size{this->WaitReadable()};
+        if (!size)
+        {
+            if (!this->input_->writerClosed_.load())
+            {
+                return;
+            }
+            //the peer publishes its last bytes before closing
+            size = static_cast<sharpen::Size>(this->input_->head_.load() - this->input_->tail_.load(std::memory_order_relaxed));
+            if (!size)
+            {
+                Callback cb{std::move(task.cb_)};
+                this->reads_.pop_front();
+                cb(0);
+                continue;
+            }
+        }
+        //the peer owns head_
+        if (size > this->capacity_)
+        {
+            Callback cb{std::move(task.cb_)};
+            this->reads_.pop_front();
+            errno = EPROTO;
+            cb(-1);
+            continue;
+        }
+        if (size > task.size_)
+        {
+            size = task.size_;
+        }
+        sharpen::Uint64 tail{this->input_->tail_.load(std::memory_order_relaxed)};
+        CopyFromRing(this->inputData_,this->capacity_,tail,task.buf_,size);
+        this->input_->tail_.store(tail + size);
+        if (this->input_->writerWaiting_.load() && this->input_->writerWaiting_.exchange(0))
+        {
+            this->Notify();
+        }
+        Callback cb{std::move(task.cb_)};
+        this->reads_.pop_front();
+        cb(static_cast<ssize_t>(size));
+    }
+}
+
+void sharpen::ShmStreamChannel::DoWrite()
+{
+    while (!this->writes_.empty())
+    {
+        WriteTask &task = this->writes_.front();
+        if (this->output_->readerClosed_.load())
+        {
+            Callback cb{std::move(task.cb_)};
+            this->writes_.pop_front();
+            errno = EPIPE;
+            cb(-1);
+            continue;
+        }
+        sharpen::Size size{this->WaitWritable()};
+        if (!size)
+        {
+            //the peer may close while we are waiting
+            if (this->output_->readerClosed_.load())
+            {
+                continue;
+            }
+            return;
+        }
+        //the peer owns tail_
+        if (size > this->capacity_)
+        {
+            Callback cb{std::move(task.cb_)};
+            this->writes_.pop_front();
+            errno = EPROTO;
+            cb(-1);
+            continue;
+        }
+        if (size > task.size_ - task.written_)
+        {
+            size = task.size_ - task.written_;
+        }
+        sharpen::Uint64 head{this->output_->head_.load(std::memory_order_relaxed)};
+        CopyToRing(this->outputData_,this->capacity_,head,task.buf_ + task.written_,size);
+        this->output_->head_.store(head + size);
+        if (this->output_->readerWaiting_.load() && this->output_->readerWaiting_.exchange(0))
+        {
+            this->Notify();
+        }
+        task.written_ += size;
+        if (task.written_ == task.size_)
+        {
+            Callback cb{std::move(task.cb_)};
+            sharpen::Size bufSize{task.size_};
+            this->writes_.pop_front();
+            cb(static_cast<ssize_t>(bufSize));
+        }
+    }
+}
+
+void sharpen::ShmStreamChannel::DoPoll()
+{
+    if (!this->pollReadCbs_.empty() && (this->WaitReadable() || this->input_->writerClosed_.load()))
+    {
+        std::deque<Callback> cbs;
+        std::swap(cbs,this->pollReadCbs_);
+        for (auto begin = cbs.begin(),end = cbs.end(); begin != end; ++begin)
+        {
+            (*begin)(0);
+        }
+    }
+    if (!this->pollWriteCbs_.empty() && (this->WaitWritable() || this->output_->readerClosed_.load()))
+    {
+        std::deque<Callback> cbs;
+        std::swap(cbs,this->pollWriteCbs_);
+        for (auto begin = cbs.begin(),end = cbs.end(); begin != end; ++begin)
+        {
+            (*begin)(0);
+        }
+    }
+}
+
+void sharpen::ShmStreamChannel::DoCancel(sharpen::ErrorCode err) noexcept
+{
+    std::deque<ReadTask> reads;
+    std::deque<WriteTask> writes;
+    std::deque<Callback> pollReads;
+    std::deque<Callback> pollWrites;
+    std::swap(reads,this->reads_);
+    std::swap(writes,this->writes_);
+    std::swap(pollReads,this->pollReadCbs_);
+    std::swap(pollWrites,this->pollWriteCbs_);
+    for (auto begin = reads.begin(),end = reads.end(); begin != end; ++begin)
+    {
+        errno = err;
+        begin->cb_(-1);
+    }
+    for (auto begin = writes.begin(),end = writes.end(); begin != end; ++begin)
+    {
+        errno = err;
+        begin->cb_(-1);
+    }
+    for (auto begin = pollReads.begin(),end = pollReads.end(); begin != end; ++begin)
+    {
+        errno = err;
+        (*begin)(-1);
+    }
+    for (auto begin = pollWrites.begin(),end = pollWrites.end(); begin != end; ++begin)
+    {
+        errno = err;
+        (*begin)(-1);
+    }
+}
+
+void sharpen::ShmStreamChannel::TryRead(char *buf,sharpen::Size bufSize,Callback cb)
+{
+    ReadTask task;
+    task.buf_ = buf;
+    task.size_ = bufSize;
+    task.cb_ = std::move(cb);
+    this->reads_.push_back(std::move(task));
+    this->DoRead();
+}
+
+void sharpen::ShmStreamChannel::TryWrite(const char *buf,sharpen::Size bufSize,Callback cb)
+{
+    WriteTask task;
+    task.buf_ = buf;
+    task.size_ = bufSize;
+    task.written_ = 0;
+    task.cb_ = std::move(cb);
+    this->writes_.push_back(std::move(task));
+    this->DoWrite();
+}
+
+void sharpen::ShmStreamChannel::TryPollRead(Callback cb)
+{
+    this->pollReadCbs_.push_back(std::move(cb));
+    this->DoPoll();
+}
+
+void sharpen::ShmStreamChannel::TryPollWrite(Callback cb)
+{
+    this->pollWriteCbs_.push_back(std::move(cb));
+    this->DoPoll();
+}
+
+void sharpen::ShmStreamChannel::CompleteIoCallback(sharpen::IChannel *channel,sharpen::Future<sharpen::Size> *future,ssize_t size) noexcept
+{
+    sharpen::EventLoop *loop{channel->GetLoop()};
+    if (size == -1)
+    {
+        loop->RunInLoopSoon(std::bind(&sharpen::Future<sharpen::Size>::Fail,future,sharpen::MakeLastErrorPtr()));
+        return;
+    }
+    loop->RunInLoopSoon(std::bind(&sharpen::Future<sharpen::Size>::CompleteForBind,future,static_cast<sharpen::Size>(size)));
+}
+
+void sharpen::ShmStreamChannel::CompletePollCallback(sharpen::IChannel *channel,sharpen::Future<void> *future,ssize_t size) noexcept
+{
+    sharpen::EventLoop *loop{channel->GetLoop()};
+    if (size == -1)
+    {
+        loop->RunInLoopSoon(std::bind(&sharpen::Future<void>::Fail,future,sharpen::MakeLastErrorPtr()));
+        return;
+    }
+    loop->RunInLoopSoon(std::bind(&sharpen::Future<void>::CompleteForBind,future));
+}
+
+void sharpen::ShmStreamChannel::WriteAsync(const sharpen::Char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<sharpen::Size> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::ShmStreamChannel::CompleteIoCallback),this,&future,std::placeholders::_1);
+    this->loop_->RunInLoop(std::bind(&sharpen::ShmStreamChannel::TryWrite,this,buf,bufSize,std::move(cb)));
+}
+
+void sharpen::ShmStreamChannel::WriteAsync(const sharpen::ByteBuffer &buf,sharpen::Size bufferOffset,sharpen::Future<sharpen::Size> &future)
+{
+    if (bufferOffset > buf.GetSize())
+    {
+        throw std::length_error("buffer size is wrong");
+    }
+    this->WriteAsync(buf.Data() + bufferOffset,buf.GetSize() - bufferOffset,future);
+}
+
+void sharpen::ShmStreamChannel::ReadAsync(sharpen::Char *buf,sharpen::Size bufSize,sharpen::Future<sharpen::Size> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<sharpen::Size> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::ShmStreamChannel::CompleteIoCallback),this,&future,std::placeholders::_1);
+    this->loop_->RunInLoop(std::bind(&sharpen::ShmStreamChannel::TryRead,this,buf,bufSize,std::move(cb)));
+}
+
+void sharpen::ShmStreamChannel::ReadAsync(sharpen::ByteBuffer &buf,sharpen::Size bufferOffset,sharpen::Future<sharpen::Size> &future)
+{
+    if (bufferOffset > buf.GetSize())
+    {
+        throw std::length_error("buffer size is wrong");
+    }
+    this->ReadAsync(buf.Data() + bufferOffset,buf.GetSize() - bufferOffset,future);
+}
+
+void sharpen::ShmStreamChannel::SendFileAsync(sharpen::FileChannelPtr file,sharpen::Uint64 size,sharpen::Uint64 offset,sharpen::Future<void> &future)
+{
+    (void)file;
+    (void)size;
+    (void)offset;
+    (void)future;
+    throw std::logic_error("shared memory channel could not send files");
+}
+
+void sharpen::ShmStreamChannel::SendFileAsync(sharpen::FileChannelPtr file,sharpen::Future<void> &future)
+{
+    this->SendFileAsync(file,0,0,future);
+}
+
+void sharpen::ShmStreamChannel::AcceptAsync(sharpen::Future<sharpen::NetStreamChannelPtr> &future)
+{
+    (void)future;
+    throw std::logic_error("shared memory channel could not accept");
+}
+
+void sharpen::ShmStreamChannel::ConnectAsync(const sharpen::IEndPoint &endpoint,sharpen::Future<void> &future)
+{
+    (void)endpoint;
+    (void)future;
+    throw std::logic_error("shared memory channel is connected when created");
+}
+
+void sharpen::ShmStreamChannel::Listen(sharpen::Uint16 queueLength)
+{
+    (void)queueLength;
+    throw std::logic_error("shared memory channel could not listen");
+}
+
+void sharpen::ShmStreamChannel::PollReadAsync(sharpen::Future<void> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<void> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::ShmStreamChannel::CompletePollCallback),this,&future,std::placeholders::_1);
+    this->loop_->RunInLoop(std::bind(&sharpen::ShmStreamChannel::TryPollRead,this,std::move(cb)));
+}
+
+void sharpen::ShmStreamChannel::PollWriteAsync(sharpen::Future<void> &future)
+{
+    if (!this->IsRegistered())
+    {
+        throw std::logic_error("should register to a loop first");
+    }
+    using FnPtr = void(*)(sharpen::IChannel *,sharpen::Future<void> *,ssize_t);
+    Callback cb = std::bind(static_cast<FnPtr>(&sharpen::ShmStreamChannel::CompletePollCallback),this,&future,std::placeholders::_1);
+    this->loop_->RunInLoop(std::bind(&sharpen::ShmStreamChannel::TryPollWrite,this,std::move(cb)));
+}
+
+void sharpen::ShmStreamChannel::OnEvent(sharpen::IoEvent *event)
+{
+    if (!event->IsReadEvent() && !event->IsErrorEvent())
+    {
+        return;
+    }
+    //reset the counter
+    sharpen::Uint64 count;
+    ssize_t size = ::read(this->handle_,&count,sizeof(count));
+    (void)size;
+    this->DoRead();
+    this->DoWrite();
+    this->DoPoll();
+}
+
+void sharpen::ShmStreamChannel::Cancel() noexcept
+{
+    this->loop_->RunInLoopSoon(std::bind(&sharpen::ShmStreamChannel::DoCancel,this,ECANCELED));
+}
+
+void sharpen::MakeShmStreamChannelPair(sharpen::Size capacity,sharpen::NetStreamChannelPtr &first,sharpen::NetStreamChannelPtr &second)
+{
+    sharpen::FileHandle handles[3];
+    CreateShmRings(capacity,handles);
+    //each side owns its eventfds
+    sharpen::FileHandle secondEvent{::dup(handles[2])};
+    sharpen::FileHandle secondPeerEvent{secondEvent != -1 ? ::dup(handles[1]):-1};
+    if (secondPeerEvent == -1)
+    {
+        sharpen::ErrorCode err = sharpen::GetLastError();
+        if (secondEvent != -1)
+        {
+            ::close(secondEvent);
+        }
+        for (sharpen::Size i = 0; i != 3; ++i)
+        {
+            ::close(handles[i]);
+        }
+        sharpen::ThrowSystemError(err);
+    }
+    sharpen::NetStreamChannelPtr firstChannel;
+    try
+    {
+        firstChannel = OpenShmStreamChannel(handles[0],handles[1],handles[2],0);
+    }
+    catch(const std::exception&)
+    {
+        ::close(handles[0]);
+        ::close(secondEvent);
+        ::close(secondPeerEvent);
+        throw;
+    }
+    sharpen::NetStreamChannelPtr secondChannel;
+    try
+    {
+        secondChannel = OpenShmStreamChannel(handles[0],secondEvent,secondPeerEvent,1);
+    }
+    catch(const std::exception&)
+    {
+        ::close(handles[0]);
+        throw;
+    }
+    ::close(handles[0]);
+    first = std::move(firstChannel);
+    second = std::move(secondChannel);
+}
+
+sharpen::NetStreamChannelPtr sharpen::ConnectShmStreamChannel(sharpen::INetStreamChannel &unixChannel,sharpen::Size capacity)
+{
+    sharpen::FileHandle handles[3];
+    CreateShmRings(capacity,handles);
+    //the peer gets the memfd, its own eventfd and ours
+    sharpen::FileHandle peerHandles[3] = {handles[0],handles[2],handles[1]};
+    try
+    {
+        unixChannel.SendHandlesAsync(peerHandles,3);
+    }
+    catch(const std::exception&)
+    {
+        for (sharpen::Size i = 0; i != 3; ++i)
+        {
+            ::close(handles[i]);
+        }
+        throw;
+    }
+    //the kernel holds its own references after sending
+    sharpen::NetStreamChannelPtr channel;
+    try
+    {
+        channel = OpenShmStreamChannel(handles[0],handles[1],handles[2],0);
+    }
+    catch(const std::exception&)
+    {
+        ::close(handles[0]);
+        throw;
+    }
+    ::close(handles[0]);
+    return channel;
+}
+
+sharpen::NetStreamChannelPtr sharpen::AcceptShmStreamChannel(sharpen::INetStreamChannel &unixChannel)
+{
+    sharpen::FileHandle handles[3];
+    sharpen::Size count{unixChannel.ReceiveHandlesAsync(handles,3)};
+    if (count != 3)
+    {
+        for (sharpen::Size i = 0; i != count; ++i)
+        {
+            ::close(handles[i]);
+        }
+        throw std::invalid_argument("not a shared memory ring");
+    }
+    sharpen::NetStreamChannelPtr channel;
+    try
+    {
+        channel = OpenShmStreamChannel(handles[0],handles[1],handles[2],1);
+    }
+    catch(const std::exception&)
+    {
+        ::close(handles[0]);
+        throw;
+    }
+    ::close(handles[0]);
+    return channel;
+}
+
+#endif
@@ -0,0 +1,358 @@
+#include <sharpen/SizeClassAllocator.hpp>
+
+#include <cassert>
+#include <mutex>
+
+#include <sharpen/SpinLock.hpp>
+
+//full batches kept by the central cache per size class
+#ifndef SHARPEN_TRANSFER_CACHE_SIZE
+#define SHARPEN_TRANSFER_CACHE_SIZE 64
+#endif
+
+//bytes carved from operator new at once
+#ifndef SHARPEN_SIZE_CLASS_SPAN
+#define SHARPEN_SIZE_CLASS_SPAN 65536
+#endif
+
+constexpr sharpen::Size sharpen::SizeClassAllocator::classCount_;
+
+namespace
+{
+    struct FreeObject
+    {
+        FreeObject *next_;
+    };
+
+    struct FreeList
+    {
+        FreeObject *head_;
+        sharpen::Size count_;
+    };
+
+    struct CentralCache
+    {
+        sharpen::SpinLock lock_;
+        //transfer cache
+        //every slot is a chain of exactly one batch
+        FreeObject *batches_[SHARPEN_TRANSFER_CACHE_SIZE];
+        sharpen::Size batchCount_;
+        //objects which do not make a batch
+        FreeObject *overflow_;
+        sharpen::Size overflowCount_;
+    };
+
+    //never destroyed
+    //threads may free objects during exit
+    CentralCache *GetCentralCaches()
+    {
+        static CentralCache *caches = new CentralCache[sharpen::SizeClassAllocator::classCount_]();
+        return caches;
+    }
+
+    //must hold lock
+    void PushOverflow(CentralCache &central,FreeObject *chain,sharpen::Size count) noexcept
+    {
+        FreeObject *tail = chain;
+        while (tail->next_)
+        {
+            tail = tail->next_;
+        }
+        tail->next_ = central.overflow_;
+        central.overflow_ = chain;
+        central.overflowCount_ += count;
+    }
+
+    //give a chain back to the central cache
+    void ReleaseToCentral(sharpen::Size index,FreeObject *chain,sharpen::Size count) noexcept
+    {
+        assert(chain && count);
+        CentralCache &central = GetCentralCaches()[index];
+        std::unique_lock<sharpen::SpinLock> lock(central.lock_);
+        if (count == sharpen::SizeClassAllocator::GetBatchSize(index) && central.batchCount_ != SHARPEN_TRANSFER_CACHE_SIZE)
+        {
+            central.batches_[central.batchCount_++] = chain;
+            return;
+        }
+        PushOverflow(central,chain,count);
+    }
+
+    //cut a null-terminated chain of at most count objects from the front of list
+    FreeObject *CutChain(FreeObject *&list,sharpen::Size &count) noexcept
+    {
+        FreeObject *chain = list;
+        FreeObject *tail = chain;
+        sharpen::Size size{1};
+        while (size != count && tail->next_)
+        {
+            tail = tail->next_;
+            ++size;
+        }
+        list = tail->next_;
+        tail->next_ = nullptr;
+        count = size;
+        return chain;
+    }
+
+    //get a chain of objects from the central cache
+    //carve a new span if it is empty
+    FreeObject *FetchFromCentral(sharpen::Size index,sharpen::Size &count)
+    {
+        sharpen::Size batchSize{sharpen::SizeClassAllocator::GetBatchSize(index)};
+        CentralCache &central = GetCentralCaches()[index];
+        {
+            std::unique_lock<sharpen::SpinLock> lock(central.lock_);
+            if (central.batchCount_ != 0)
+            {
+                count = batchSize;
+                return central.batches_[--central.batchCount_];
+            }
+            if (central.overflow_)
+            {
+                count = batchSize;
+                FreeObject *chain = CutChain(central.overflow_,count);
+                central.overflowCount_ -= count;
+                return chain;
+            }
+        }
+        sharpen::Size classSize{sharpen::SizeClassAllocator::GetClassSize(index)};
+        sharpen::Size objects{SHARPEN_SIZE_CLASS_SPAN/classSize};
+        if (objects < batchSize)
+        {
+            objects = batchSize;
+        }
+        char *span = reinterpret_cast<char*>(::operator new(objects*classSize));
+        //link the span
+        for (sharpen::Size i = 0; i != objects; ++i)
+        {
+            FreeObject *obj = reinterpret_cast<FreeObject*>(span + i*classSize);
+            obj->next_ = (i + 1 != objects) ? reinterpret_cast<FreeObject*>(span + (i + 1)*classSize):nullptr;
+        }
+        FreeObject *list = reinterpret_cast<FreeObject*>(span);
+        count = batchSize;
+        FreeObject *chain = CutChain(list,count);
+        //keep the rest in central cache
+        while (list)
+        {
+            sharpen::Size size{batchSize};
+            FreeObject *batch = CutChain(list,size);
+            ReleaseToCentral(index,batch,size);
+        }
+        return chain;
+    }
+
+    class ThreadCache
+    {
+    private:
+        FreeList lists_[sharpen::SizeClassAllocator::classCount_];
+
+        void Release(sharpen::Size index,sharpen::Size count) noexcept
+        {
+            FreeList &list = this->lists_[index];
+            FreeObject *chain = CutChain(list.head_,count);
+            list.count_ -= count;
+            ReleaseToCentral(index,chain,count);
+        }
+    public:
+        ThreadCache() noexcept
+            :lists_()
+        {}
+
+        ~ThreadCache() noexcept
+        {
+            this->Flush();
+        }
+
+        void *Allocate(sharpen::Size index)
+        {
+            FreeList &list = this->lists_[index];
+            if (!list.head_)
+            {
+                list.head_ = FetchFromCentral(index,list.count_);
+            }
+            FreeObject *obj = list.head_;
+            list.head_ = obj->next_;
+            list.count_ -= 1;
+            return obj;
+        }
+
+        void Deallocate(void *p,sharpen::Size index) noexcept
+        {
+            FreeList &list = this->lists_[index];
+            FreeObject *obj = reinterpret_cast<FreeObject*>(p);
+            obj->next_ = list.head_;
+            list.head_ = obj;
+            list.count_ += 1;
+            sharpen::Size batchSize{sharpen::SizeClassAllocator::GetBatchSize(index)};
+            if (list.count_ >= batchSize*2 && list.count_*sharpen::SizeClassAllocator::GetClassSize(index) > SHARPEN_THREAD_CACHE_LIMIT)
+            {
+                this->Release(index,batchSize);
+            }
+        }
+
+        void Flush() noexcept
+        {
+            for (sharpen::Size i = 0; i != sharpen::SizeClassAllocator::classCount_; ++i)
+            {
+                sharpen::Size batchSize{sharpen::SizeClassAllocator::GetBatchSize(i)};
+                while (this->lists_[i].head_)
+                {
+                    this->Release(i,batchSize);
+                }
+            }
+        }
+    };
+
+    thread_local ThreadCache *localCache{nullptr};
+
+    //set after the cache of this thread was destroyed
+    thread_local bool localCacheDestroyed{false};
+
+    struct LocalThreadCache
+    {
+        ThreadCache cache_;
+
+        ~LocalThreadCache() noexcept
+        {
+            localCache = nullptr;
+            localCacheDestroyed = true;
+        }
+    };
+
+    ThreadCache *GetThreadCache()
+    {
+        if (!localCache && !localCacheDestroyed)
+        {
+            thread_local LocalThreadCache holder;
+            localCache = &holder.cache_;
+        }
+        return localCache;
+    }
+}
+
+sharpen::Size sharpen::SizeClassAllocator::GetClassIndex(sharpen::Size size) noexcept
+{
+    assert(size <= SHARPEN_SIZE_CLASS_MAX);
+    if (size <= 256)
+    {
+        return size ? (size + 15)/16 - 1:0;
+    }
+    sharpen::Size s{size - 1};
+    sharpen::Size lg{8};
+    while ((s >> (lg + 1)) != 0)
+    {
+        ++lg;
+    }
+    return 16 + (lg - 8)*4 + (s >> (lg - 2)) - 4;
+}
+
+sharpen::Size sharpen::SizeClassAllocator::GetClassSize(sharpen::Size index) noexcept
+{
+    assert(index < classCount_);
+    if (index < 16)
+    {
+        return (index + 1)*16;
+    }
+    index -= 16;
+    sharpen::Size lg{8 + index/4};
+    return (static_cast<sharpen::Size>(1) << lg) + (index % 4 + 1)*(static_cast<sharpen::Size>(1) << (lg - 2));
+}
+
+sharpen::Size sharpen::SizeClassAllocator::GetBatchSize(sharpen::Size index) noexcept
+{
+    sharpen::Size size{SHARPEN_THREAD_CACHE_LIMIT/4/GetClassSize(index)};
+    if (size < 2)
+    {
+        return 2;
+    }
+    if (size > 32)
+    {
+        return 32;
+    }
+    return size;
+}
+
+void *sharpen::SizeClassAllocator::Allocate(sharpen::Size size)
+{
+    if (size > SHARPEN_SIZE_CLASS_MAX)
+    {
+        return ::operator new(size);
+    }
+    sharpen::Size index{GetClassIndex(size)};
+    ThreadCache *cache = GetThreadCache();
+    if (cache)
+    {
+        return cache->Allocate(index);
+    }
+    //the thread is exiting
+    sharpen::Size count;
+    FreeObject *chain = FetchFromCentral(index,count);
+    if (chain->next_)
+    {
+        ReleaseToCentral(index,chain->next_,count - 1);
+    }
+    return chain;
+}
+
+void sharpen::SizeClassAllocator::Deallocate(void *p,sharpen::Size size) noexcept
+{
+    if (!p)
+    {
+        return;
+    }
+    if (size > SHARPEN_SIZE_CLASS_MAX)
+    {
+        ::operator delete(p);
+        return;
+    }
+    sharpen::Size index{GetClassIndex(size)};
+    ThreadCache *cache = localCache;
+    if (!cache && !localCacheDestroyed)
+    {
+        cache = GetThreadCache();
+    }
+    if (cache)
+    {
+        cache->Deallocate(p,index);
+        return;
+    }
+    FreeObject *obj = reinterpret_cast<FreeObject*>(p);
+    obj->next_ = nullptr;
+    ReleaseToCentral(index,obj,1);
+}
+
+void *sharpen::SizeClassAllocator::Allocate(sharpen::Size size,sharpen::Size alignment)
+{
+    assert((alignment & (alignment - 1)) == 0);
+    if (alignment <= alignment_)
+    {
+        return Allocate(size);
+    }
+    //no aligned operator new before c++17
+    //keep the raw pointer in front of the aligned block
+    char *raw = reinterpret_cast<char*>(::operator new(size + alignment));
+    sharpen::Uintptr p{(reinterpret_cast<sharpen::Uintptr>(raw) + alignment) & ~static_cast<sharpen::Uintptr>(alignment - 1)};
+    reinterpret_cast<char**>(p)[-1] = raw;
+    return reinterpret_cast<void*>(p);
+}
+
+void sharpen::SizeClassAllocator::Deallocate(void *p,sharpen::Size size,sharpen::Size alignment) noexcept
+{
+    if (alignment <= alignment_)
+    {
+        Deallocate(p,size);
+        return;
+    }
+    if (p)
+    {
+        ::operator delete(reinterpret_cast<char**>(p)[-1]);
+    }
+}
+
+void sharpen::SizeClassAllocator::FlushThreadCache() noexcept
+{
+    if (localCache)
+    {
+        localCache->Flush();
+    }
+}
@@ -1,18 +1,82 @@
 #include <sharpen/SpinLock.hpp>
 
+#include <sharpen/SystemMacro.hpp>
+#include <sharpen/CpuRelax.hpp>
+
+#ifdef SHARPEN_IS_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
 #include <thread>
+#endif
 
 sharpen::SpinLock::SpinLock()
-    :flag_()
+    :state_(0)
+#ifdef SHARPEN_SPINLOCK_STATISTICS
+    ,acquisitions_(0)
+    ,contentions_(0)
+    ,sleeps_(0)
+#endif
 {}
 
-void sharpen::SpinLock::lock()
+void sharpen::SpinLock::LockSlow()
 {
-    while (this->flag_.test_and_set(std::memory_order::memory_order_acquire))
-    {}
+#ifdef SHARPEN_SPINLOCK_STATISTICS
+    this->contentions_.fetch_add(1,std::memory_order_relaxed);
+#endif
+    //spin on a plain load and back off exponentially
+    sharpen::Size backoff{1};
+    for (sharpen::Size spin = 0; spin < SHARPEN_SPINLOCK_SPIN_LIMIT; spin += backoff)
+    {
+        for (sharpen::Size i = 0; i != backoff; ++i)
+        {
+            sharpen::CpuRelax();
+        }
+        if (backoff < SHARPEN_SPINLOCK_MAX_BACKOFF)
+        {
+            backoff <<= 1;
+        }
+        sharpen::Uint32 expected{0};
+        if (this->state_.load(std::memory_order_relaxed) == 0 && this->state_.compare_exchange_weak(expected,1,std::memory_order_acquire,std::memory_order_relaxed))
+        {
+            return;
+        }
+    }
+    //the holder may have been preempted
+    //mark the lock as contended and sleep
+    while (this->state_.exchange(2,std::memory_order_acquire) != 0)
+    {
+#ifdef SHARPEN_SPINLOCK_STATISTICS
+        this->sleeps_.fetch_add(1,std::memory_order_relaxed);
+#endif
+#ifdef SHARPEN_IS_LINUX
+        //return at once if the state is not 2 anymore
+        ::syscall(SYS_futex,reinterpret_cast<sharpen::Uint32*>(&this->state_),FUTEX_WAIT_PRIVATE,2,nullptr,nullptr,0);
+#else
+        std::this_thread::yield();
+#endif
+    }
 }
 
-void sharpen::SpinLock::unlock() noexcept
+void sharpen::SpinLock::Wake() noexcept
 {
-    this->flag_.clear(std::memory_order::memory_order_release);
-}
\ No newline at end of file
+#ifdef SHARPEN_IS_LINUX
+    ::syscall(SYS_futex,reinterpret_cast<sharpen::Uint32*>(&this->state_),FUTEX_WAKE_PRIVATE,1,nullptr,nullptr,0);
+#endif
+}
+
+sharpen::SpinLockStatistics sharpen::SpinLock::GetStatistics() const noexcept
+{
+    sharpen::SpinLockStatistics statistics;
+#ifdef SHARPEN_SPINLOCK_STATISTICS
+    statistics.acquisitions_ = this->acquisitions_.load(std::memory_order_relaxed);
+    statistics.contentions_ = this->contentions_.load(std::memory_order_relaxed);
+    statistics.sleeps_ = this->sleeps_.load(std::memory_order_relaxed);
+#else
+    statistics.acquisitions_ = 0;
+    statistics.contentions_ = 0;
+    statistics.sleeps_ = 0;
+#endif
+    return statistics;
+}
@@ -0,0 +1,117 @@
+#include <sharpen/SpliceOps.hpp>
+
+#include <algorithm>
+#include <exception>
+
+#include <sharpen/SystemMacro.hpp>
+#include <sharpen/PipeChannel.hpp>
+#include <sharpen/AsyncOps.hpp>
+
+#ifdef SHARPEN_IS_NIX
+#include <sys/socket.h>
+#endif
+
+namespace
+{
+    //the pipe is drained after every chunk
+    //so a chunk never waits for the pipe
+    struct SplicePipe
+    {
+        sharpen::InputPipeChannelPtr in_;
+        sharpen::OutputPipeChannelPtr out_;
+        sharpen::Size capacity_;
+    };
+
+    SplicePipe MakeSplicePipe()
+    {
+        SplicePipe pipe;
+        sharpen::MakePipeChannel(pipe.in_,pipe.out_);
+        pipe.capacity_ = pipe.out_->GetPipeSize();
+        if (!pipe.capacity_)
+        {
+            pipe.capacity_ = 64*1024;
+        }
+        return pipe;
+    }
+
+    sharpen::Size SpliceThrough(sharpen::INetStreamChannel &from,sharpen::INetStreamChannel &to,sharpen::Size size,SplicePipe &pipe)
+    {
+        sharpen::Size moved{0};
+        while (moved != size)
+        {
+            sharpen::Size chunk{(std::min)(size - moved,pipe.capacity_)};
+            sharpen::Size sz{from.SpliceToPipeAsync(pipe.out_->GetHandle(),chunk)};
+            if (!sz)
+            {
+                break;
+            }
+            to.SpliceFromPipeAsync(pipe.in_->GetHandle(),sz);
+            moved += sz;
+        }
+        return moved;
+    }
+
+    void Forward(sharpen::INetStreamChannel &from,sharpen::INetStreamChannel &to)
+    {
+        SplicePipe pipe{MakeSplicePipe()};
+        SpliceThrough(from,to,static_cast<sharpen::Size>(-1),pipe);
+#ifdef SHARPEN_IS_NIX
+        ::shutdown(to.GetHandle(),SHUT_WR);
+#endif
+    }
+}
+
+sharpen::Size sharpen::SpliceAsync(sharpen::INetStreamChannel &from,sharpen::INetStreamChannel &to,sharpen::Size size)
+{
+    if (!size)
+    {
+        return 0;
+    }
+    SplicePipe pipe{MakeSplicePipe()};
+    return SpliceThrough(from,to,size,pipe);
+}
+
+void sharpen::ProxyAsync(sharpen::INetStreamChannel &a,sharpen::INetStreamChannel &b)
+{
+    sharpen::AwaitableFuture<void> reverse;
+    sharpen::Launch([&a,&b,&reverse]()
+    {
+        try
+        {
+            Forward(b,a);
+            reverse.Complete();
+        }
+        catch(const std::exception&)
+        {
+            a.Cancel();
+            b.Cancel();
+            reverse.Fail(std::current_exception());
+        }
+    });
+    std::exception_ptr err;
+    try
+    {
+        Forward(a,b);
+    }
+    catch(const std::exception&)
+    {
+        err = std::current_exception();
+        a.Cancel();
+        b.Cancel();
+    }
+    try
+    {
+        reverse.Await();
+    }
+    catch(const std::exception&)
+    {
+        if (!err)
+        {
+            err = std::current_exception();
+        }
+    }
+    if (err)
+    {
+        std::rethrow_exception(err);
+    }
+}
@@ -28,4 +28,9 @@ void sharpen::TcpServer::Stop() noexcept
 {
     this->running_ = false;
     this->acceptor_.Close();
+}
+
+void sharpen::TcpServer::ServeAsync(sharpen::NetStreamChannelPtr channel)
+{
+    this->engine_->Launch(&sharpen::TcpServer::OnNewChannel,this,std::move(channel));
 }
\ No newline at end of file
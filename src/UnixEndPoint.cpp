@@ -0,0 +1,95 @@
+#include <sharpen/UnixEndPoint.hpp>
+
+#ifdef SHARPEN_IS_NIX
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    constexpr sharpen::Uint32 pathOffset{offsetof(sockaddr_un,sun_path)};
+}
+
+sharpen::UnixEndPoint::UnixEndPoint() noexcept
+    :addr_()
+    ,len_(sizeof(addr_))
+{
+    this->addr_.sun_family = AF_UNIX;
+}
+
+sharpen::UnixEndPoint::UnixEndPoint(const char *path)
+    :UnixEndPoint()
+{
+    this->SetPath(path);
+}
+
+bool sharpen::UnixEndPoint::operator==(const Self &other) const noexcept
+{
+    return this->len_ == other.len_ && std::memcmp(&this->addr_,&other.addr_,this->len_) == 0;
+}
+
+sharpen::UnixEndPoint::NativeAddr *sharpen::UnixEndPoint::GetAddrPtr() noexcept
+{
+    return reinterpret_cast<NativeAddr*>(&this->addr_);
+}
+
+const sharpen::UnixEndPoint::NativeAddr *sharpen::UnixEndPoint::GetAddrPtr() const noexcept
+{
+    return reinterpret_cast<const NativeAddr*>(&this->addr_);
+}
+
+void sharpen::UnixEndPoint::SetAddrLen(sharpen::Uint32 len) noexcept
+{
+    if (len > sizeof(this->addr_))
+    {
+        len = sizeof(this->addr_);
+    }
+    this->len_ = len;
+}
+
+void sharpen::UnixEndPoint::SetPath(const char *path)
+{
+    sharpen::Size size{std::strlen(path)};
+    //keep the terminating '\0'
+    if (size >= sizeof(this->addr_.sun_path))
+    {
+        throw std::length_error("path is too long");
+    }
+    std::memset(this->addr_.sun_path,0,sizeof(this->addr_.sun_path));
+    std::memcpy(this->addr_.sun_path,path,size);
+    this->len_ = static_cast<sharpen::Uint32>(pathOffset + size + 1);
+}
+
+void sharpen::UnixEndPoint::SetAbstractName(const char *name,sharpen::Size size)
+{
+    //the leading '\0' marks the abstract namespace
+    if (size >= sizeof(this->addr_.sun_path))
+    {
+        throw std::length_error("name is too long");
+    }
+    std::memset(this->addr_.sun_path,0,sizeof(this->addr_.sun_path));
+    std::memcpy(this->addr_.sun_path + 1,name,size);
+    this->len_ = static_cast<sharpen::Uint32>(pathOffset + size + 1);
+}
+
+bool sharpen::UnixEndPoint::IsAbstract() const noexcept
+{
+    return this->len_ > pathOffset && this->addr_.sun_path[0] == '\0';
+}
+
+std::string sharpen::UnixEndPoint::GetPath() const
+{
+    if (this->len_ <= pathOffset)
+    {
+        return std::string{};
+    }
+    sharpen::Size size{this->len_ - pathOffset};
+    if (this->IsAbstract())
+    {
+        return std::string{this->addr_.sun_path + 1,size - 1};
+    }
+    return std::string{this->addr_.sun_path,::strnlen(this->addr_.sun_path,size)};
+}
+
+#endif
@@ -0,0 +1,122 @@
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <sharpen/ObjectPool.hpp>
+
+void SizeClassTest()
+{
+    std::printf("size class test begin\n");
+    sharpen::Size last{0};
+    for (sharpen::Size i = 0; i != sharpen::SizeClassAllocator::classCount_; ++i)
+    {
+        sharpen::Size size = sharpen::SizeClassAllocator::GetClassSize(i);
+        assert(size > last);
+        assert(size % 16 == 0);
+        assert(sharpen::SizeClassAllocator::GetClassIndex(size) == i);
+        assert(sharpen::SizeClassAllocator::GetClassIndex(last + 1) == i);
+        last = size;
+    }
+    assert(last == SHARPEN_SIZE_CLASS_MAX);
+    (void)last;
+    std::printf("size class test pass\n");
+}
+
+struct Object
+{
+    sharpen::Size value_;
+    char data_[100];
+
+    explicit Object(sharpen::Size value)
+        :value_(value)
+        ,data_()
+    {
+        std::memset(this->data_,static_cast<int>(value & 0xff),sizeof(this->data_));
+    }
+};
+
+void ObjectPoolTest(sharpen::Size threads,sharpen::Size count)
+{
+    std::printf("object pool test begin\n");
+    //objects are allocated by one thread and freed by another
+    std::vector<std::vector<Object*>> objects(threads);
+    std::vector<std::thread> workers;
+    for (sharpen::Size i = 0; i < threads; i++)
+    {
+        workers.emplace_back([&objects,i,count]()
+        {
+            for (sharpen::Size j = 0; j < count; j++)
+            {
+                objects[i].push_back(sharpen::ObjectPool<Object>::New(j));
+            }
+        });
+    }
+    for (auto ite = workers.begin(); ite != workers.end(); ++ite)
+    {
+        ite->join();
+    }
+    workers.clear();
+    for (sharpen::Size i = 0; i < threads; i++)
+    {
+        workers.emplace_back([&objects,i,threads]()
+        {
+            std::vector<Object*> &list = objects[(i + 1) % threads];
+            for (sharpen::Size j = 0; j < list.size(); j++)
+            {
+                Object *obj = list[j];
+                assert(obj->value_ == j);
+                assert(obj->data_[99] == static_cast<char>(j & 0xff));
+                sharpen::ObjectPool<Object>::Delete(obj);
+            }
+            //large blocks bypass the size classes
+            void *p = sharpen::SizeClassAllocator::Allocate(SHARPEN_SIZE_CLASS_MAX + 1);
+            sharpen::SizeClassAllocator::Deallocate(p,SHARPEN_SIZE_CLASS_MAX + 1);
+        });
+    }
+    for (auto ite = workers.begin(); ite != workers.end(); ++ite)
+    {
+        ite->join();
+    }
+    std::shared_ptr<Object> shared = sharpen::ObjectPool<Object>::MakeShared(static_cast<sharpen::Size>(1));
+    assert(shared->value_ == 1);
+    sharpen::PoolPtr<Object> unique = sharpen::MakePoolPtr<Object>(static_cast<sharpen::Size>(2));
+    assert(unique->value_ == 2);
+    std::vector<int,sharpen::PoolAllocator<int>> vec;
+    for (int i = 0; i < 1000; i++)
+    {
+        vec.push_back(i);
+    }
+    assert(vec[999] == 999);
+    sharpen::SizeClassAllocator::FlushThreadCache();
+    std::printf("object pool test pass\n");
+}
+
+struct alignas(64) OverAligned
+{
+    char data_[8];
+};
+
+void OverAlignedTest()
+{
+    std::printf("over-aligned test begin\n");
+    for (sharpen::Size i = 0; i != 16; ++i)
+    {
+        OverAligned *obj = sharpen::ObjectPool<OverAligned>::New();
+        assert(reinterpret_cast<sharpen::Uintptr>(obj) % alignof(OverAligned) == 0);
+        sharpen::ObjectPool<OverAligned>::Delete(obj);
+        std::shared_ptr<OverAligned> shared = sharpen::ObjectPool<OverAligned>::MakeShared();
+        assert(reinterpret_cast<sharpen::Uintptr>(shared.get()) % alignof(OverAligned) == 0);
+    }
+    std::printf("over-aligned test pass\n");
+}
+
+int main()
+{
+    SizeClassTest();
+    ObjectPoolTest(4,10000);
+    OverAlignedTest();
+    return 0;
+}
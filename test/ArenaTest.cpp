@@ -51,6 +51,94 @@ int main(int argc, char const *argv[])
         auto obj = arena.MakeSharedArray<MyTestClass>(10, &p);
         auto copy = obj;
     }
+    assert(p == 0);
+    std::puts("testing alignment");
+    {
+        sharpen::Arena arena{1024};
+        for (sharpen::Size i = 1; i != 200; ++i)
+        {
+            sharpen::Size alignment{static_cast<sharpen::Size>(1) << (i % 8)};
+            void *mem = arena.Alloc(i,alignment);
+            assert(mem);
+            assert(reinterpret_cast<sharpen::Uintptr>(mem) % alignment == 0);
+        }
+        void *large = arena.Alloc(4096,64);
+        assert(large);
+        assert(reinterpret_cast<sharpen::Uintptr>(large) % 64 == 0);
+        void *def = arena.Alloc(3);
+        assert(reinterpret_cast<sharpen::Uintptr>(def) % alignof(std::max_align_t) == 0);
+        (void)def;
+    }
+    std::puts("testing large threshold");
+    {
+        //every allocation up to the block size stays in the block
+        sharpen::Arena arena;
+        char *first = reinterpret_cast<char*>(arena.Alloc(5000));
+        char *second = reinterpret_cast<char*>(arena.Alloc(5000));
+        assert(second == first + 5008);
+        (void)first;
+        (void)second;
+        sharpen::Arena small{1024,sharpen::ArenaMode::Shared,256};
+        assert(small.GetMaxSmallSize() == 256);
+        void *large = small.Alloc(512);
+        assert(large);
+        (void)large;
+    }
+    std::puts("testing reset");
+    {
+        sharpen::Arena arena{1024};
+        void *first = arena.Alloc(16);
+        for (sharpen::Size i = 0; i != 100; ++i)
+        {
+            arena.Alloc(64);
+        }
+        arena.Alloc(8192);
+        arena.Reset();
+        void *again = arena.Alloc(16);
+        assert(first == again);
+        (void)first;
+        (void)again;
+    }
+    std::puts("testing scope");
+    {
+        sharpen::Arena arena{1024};
+        arena.Alloc(32);
+        sharpen::ArenaSavepoint point{arena.Save()};
+        void *mark{nullptr};
+        {
+            sharpen::ArenaScope scope{arena};
+            mark = arena.Alloc(32);
+            for (sharpen::Size i = 0; i != 100; ++i)
+            {
+                arena.Alloc(64);
+            }
+            arena.Alloc(8192);
+        }
+        void *again = arena.Alloc(32);
+        assert(mark == again);
+        arena.Rewind(point);
+        again = arena.Alloc(32);
+        assert(mark == again);
+        (void)mark;
+        (void)again;
+    }
+    std::puts("testing exclusive mode");
+    {
+        sharpen::Arena arena{1024,sharpen::ArenaMode::Exclusive};
+        assert(arena.GetMode() == sharpen::ArenaMode::Exclusive);
+        int *prev{nullptr};
+        for (int i = 0; i != 1000; ++i)
+        {
+            int *obj = arena.Construct<int>(i);
+            assert(obj && *obj == i);
+            assert(obj != prev);
+            prev = obj;
+        }
+        arena.Reset();
+        auto array = arena.MakeUniqueArray<MyTestClass>(10, &p);
+        assert(p == 10);
+    }
+    assert(p == 0);
     std::puts("pass");
     std::puts("benchmark begin");
     constexpr size_t count = static_cast<size_t>(1e8);
@@ -0,0 +1,126 @@
+#include <cstdio>
+#include <cassert>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sharpen/AsyncOps.hpp>
+#include <sharpen/AsyncMutex.hpp>
+#include <sharpen/AsyncSemaphore.hpp>
+#include <sharpen/AsyncBarrier.hpp>
+#include <sharpen/AsyncReadWriteLock.hpp>
+#include <sharpen/SpinLock.hpp>
+
+void AsyncLockTest(sharpen::Size count)
+{
+    sharpen::EventEngine &engine = sharpen::EventEngine::SetupEngine();
+    engine.Startup([count]()
+    {
+        std::printf("mutex test begin\n");
+        sharpen::AsyncMutex mutex;
+        sharpen::AsyncBarrier barrier(count);
+        sharpen::Size counter{0};
+        for (sharpen::Size i = 0; i < count; i++)
+        {
+            sharpen::Launch([&mutex,&barrier,&counter]()
+            {
+                for (sharpen::Size j = 0; j < 100; j++)
+                {
+                    std::unique_lock<sharpen::AsyncMutex> lock(mutex);
+                    counter += 1;
+                }
+                barrier.Notice();
+            });
+        }
+        barrier.WaitAsync();
+        std::printf("counter is %zu\n",counter);
+        assert(counter == count*100);
+        std::printf("mutex test pass\n");
+        std::printf("semaphore test begin\n");
+        sharpen::AsyncSemaphore sem(0);
+        sharpen::AsyncBarrier semBarrier(count);
+        for (sharpen::Size i = 0; i < count; i++)
+        {
+            sharpen::Launch([&sem,&semBarrier]()
+            {
+                sem.LockAsync();
+                semBarrier.Notice();
+            });
+        }
+        sem.Unlock(static_cast<sharpen::Uint32>(count + 1));
+        semBarrier.WaitAsync();
+        bool r = sem.TryLock();
+        assert(r);
+        r = sem.TryLock();
+        assert(!r);
+        (void)r;
+        std::printf("semaphore test pass\n");
+        std::printf("read write lock test begin\n");
+        sharpen::AsyncReadWriteLock rwLock;
+        sharpen::AsyncBarrier rwBarrier(count);
+        sharpen::Size value{0};
+        for (sharpen::Size i = 0; i < count; i++)
+        {
+            sharpen::Launch([&rwLock,&rwBarrier,&value,i]()
+            {
+                if (i % 2)
+                {
+                    rwLock.LockWriteAsync();
+                    value += 1;
+                }
+                else
+                {
+                    rwLock.LockReadAsync();
+                }
+                rwLock.Unlock();
+                rwBarrier.Notice();
+            });
+        }
+        rwBarrier.WaitAsync();
+        assert(value == count/2);
+        std::printf("read write lock test pass\n");
+    });
+}
+
+void SpinLockTest(sharpen::Size threads,sharpen::Size count)
+{
+    std::printf("spin lock test begin\n");
+    sharpen::SpinLock lock;
+    sharpen::Size counter{0};
+    std::vector<std::thread> workers;
+    for (sharpen::Size i = 0; i < threads; i++)
+    {
+        workers.emplace_back([&lock,&counter,count]()
+        {
+            for (sharpen::Size j = 0; j < count; j++)
+            {
+                std::unique_lock<sharpen::SpinLock> guard(lock);
+                counter += 1;
+            }
+        });
+    }
+    for (auto ite = workers.begin(); ite != workers.end(); ++ite)
+    {
+        ite->join();
+    }
+    assert(counter == threads*count);
+    bool r = lock.TryLock();
+    assert(r);
+    r = lock.TryLock();
+    assert(!r);
+    (void)r;
+    lock.Unlock();
+#ifdef SHARPEN_SPINLOCK_STATISTICS
+    sharpen::SpinLockStatistics statistics = lock.GetStatistics();
+    std::printf("acquisitions %llu contentions %llu sleeps %llu\n",static_cast<unsigned long long>(statistics.acquisitions_),static_cast<unsigned long long>(statistics.contentions_),static_cast<unsigned long long>(statistics.sleeps_));
+    assert(statistics.acquisitions_ == threads*count + 1);
+#endif
+    std::printf("spin lock test pass\n");
+}
+
+int main()
+{
+    SpinLockTest(8,100000);
+    AsyncLockTest(64);
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <cstdio>
+#include <cassert>
+#include <vector>
+
+#include <sharpen/AsyncOps.hpp>
+#include <sharpen/AsyncBarrier.hpp>
+#include <sharpen/AsyncBoundedQueue.hpp>
+
+void AsyncQueueTest(sharpen::Size producers,sharpen::Size count)
+{
+    sharpen::EventEngine &engine = sharpen::EventEngine::SetupEngine();
+    engine.Startup([producers,count]()
+    {
+        std::printf("bounded queue test begin\n");
+        sharpen::AsyncBoundedQueue<sharpen::Size> queue(16);
+        sharpen::AsyncBarrier barrier(producers);
+        for (sharpen::Size i = 0; i < producers; i++)
+        {
+            sharpen::Launch([&queue,&barrier,count,i]()
+            {
+                if (i % 2)
+                {
+                    for (sharpen::Size j = 0; j < count; j++)
+                    {
+                        queue.PushAsync(j);
+                    }
+                }
+                else
+                {
+                    std::vector<sharpen::Size> batch;
+                    for (sharpen::Size j = 0; j < count; j++)
+                    {
+                        batch.push_back(j);
+                    }
+                    queue.PushManyAsync(batch.begin(),batch.end());
+                }
+                barrier.Notice();
+            });
+        }
+        sharpen::Size sum{0};
+        sharpen::Size popped{0};
+        sharpen::Size buf[8];
+        while (popped != producers*count)
+        {
+            if (popped % 3)
+            {
+                sum += queue.PopAsync();
+                popped += 1;
+                continue;
+            }
+            sharpen::Size size = queue.PopManyAsync(buf,8);
+            assert(size != 0 && size <= 8);
+            for (sharpen::Size i = 0; i < size; i++)
+            {
+                sum += buf[i];
+            }
+            popped += size;
+        }
+        barrier.WaitAsync();
+        std::printf("sum is %zu\n",sum);
+        assert(sum == producers*count*(count - 1)/2);
+        assert(queue.GetSize() == 0);
+        sharpen::Size val{1};
+        bool r = queue.TryPop(val);
+        assert(!r);
+        for (sharpen::Size i = 0; i < queue.GetCapacity(); i++)
+        {
+            r = queue.TryPush(std::move(i));
+            assert(r);
+        }
+        r = queue.TryPush(std::move(val));
+        assert(!r);
+        (void)r;
+        std::printf("bounded queue test pass\n");
+    });
+}
+
+int main()
+{
+    AsyncQueueTest(8,1000);
+    return 0;
+}
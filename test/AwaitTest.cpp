@@ -1,5 +1,7 @@
 #include <cstdio>
 #include <cassert>
+#include <vector>
+#include <stdexcept>
 
 #include <sharpen/AsyncOps.hpp>
 #include <sharpen/AwaitOps.hpp>
@@ -50,6 +52,41 @@ void AwaitTest()
         r = future.Await();
         assert(r == 3);
         std::printf("reset test pass\n");
+        std::printf("when test begin\n");
+        std::vector<sharpen::AwaitableFuturePtr<int>> futures;
+        for (int i = 0; i < 5; i++)
+        {
+            futures.push_back(sharpen::Async([i]()
+            {
+                sharpen::Delay(std::chrono::milliseconds(100*(5 - i)));
+                return i;
+            }));
+        }
+        sharpen::Size index = sharpen::WhenAny(futures);
+        assert(index == 4);
+        bool quorum = sharpen::WhenN(futures,3);
+        assert(quorum);
+        sharpen::WhenAll(futures);
+        for (int i = 0; i < 5; i++)
+        {
+            assert(futures[i]->Get() == i);
+        }
+        std::vector<sharpen::AwaitableFuture<void>> failures(3);
+        failures[0].Complete();
+        failures[1].Fail(std::make_exception_ptr(std::runtime_error("fail")));
+        failures[2].Fail(std::make_exception_ptr(std::runtime_error("fail")));
+        quorum = sharpen::WhenN(failures,2);
+        assert(!quorum);
+        {
+            //the callbacks left on pending futures are dropped with them
+            std::vector<sharpen::AwaitableFuture<int>> pending(3);
+            pending[1].Complete(1);
+            index = sharpen::WhenAny(pending);
+            assert(index == 1);
+        }
+        (void)quorum;
+        (void)index;
+        std::printf("when test pass\n");
     });
 }
 
@@ -0,0 +1,133 @@
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <sharpen/BufferSlice.hpp>
+#include <sharpen/BufferChain.hpp>
+#include <sharpen/ByteBuffer.hpp>
+
+void SliceTest()
+{
+    std::printf("slice test begin\n");
+    const char str[] = "hello world";
+    sharpen::BufferSlice buf{str,sizeof(str) - 1};
+    assert(buf.GetSize() == 11);
+    assert(buf.IsUnique());
+    sharpen::BufferSlice world{buf.Slice(6)};
+    assert(world.GetSize() == 5);
+    assert(std::memcmp(world.Data(),"world",5) == 0);
+    assert(world.Data() == buf.Data() + 6);
+    assert(buf.GetRefCount() == 2);
+    sharpen::BufferSlice wo{world.Slice(0,2)};
+    assert(wo.GetSize() == 2 && wo[1] == 'o');
+    assert(buf.GetRefCount() == 3);
+    //writes are shared
+    buf[6] = 'W';
+    assert(wo[0] == 'W');
+    bool thrown{false};
+    try
+    {
+        world.Slice(3,3);
+    }
+    catch(const std::out_of_range &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    (void)thrown;
+    sharpen::BufferSlice empty{buf.Slice(11)};
+    assert(empty.Empty());
+    assert(empty.GetRefCount() == 0);
+    buf.Clear();
+    world = sharpen::BufferSlice{};
+    assert(wo.IsUnique());
+    sharpen::ByteBuffer copy{wo.ToByteBuffer()};
+    assert(copy.GetSize() == 2 && copy[0] == 'W');
+    sharpen::BufferSlice fromBuf{copy};
+    assert(fromBuf.GetSize() == 2 && fromBuf[1] == 'o');
+    std::printf("slice test pass\n");
+}
+
+void CrossThreadTest()
+{
+    std::printf("cross thread test begin\n");
+    constexpr sharpen::Size count{1000};
+    std::vector<sharpen::BufferSlice> slices;
+    for (sharpen::Size i = 0; i != count; ++i)
+    {
+        sharpen::BufferSlice slice{4096};
+        std::memset(slice.Data(),static_cast<int>(i & 0xff),slice.GetSize());
+        slices.emplace_back(slice.Slice(i % 4096,1));
+    }
+    //the blocks are released by another thread
+    std::thread worker([&slices]()
+    {
+        for (sharpen::Size i = 0; i != slices.size(); ++i)
+        {
+            assert(slices[i][0] == static_cast<char>(i & 0xff));
+            assert(slices[i].IsUnique());
+        }
+        slices.clear();
+    });
+    worker.join();
+    assert(slices.empty());
+    std::printf("cross thread test pass\n");
+}
+
+void ChainTest()
+{
+    std::printf("chain test begin\n");
+    sharpen::BufferSlice body{"body",4};
+    sharpen::BufferChain chain;
+    chain.Append(body);
+    chain.Prepend("head:",5);
+    chain.Append(":tail",5);
+    chain.Append(sharpen::BufferSlice{});
+    assert(chain.GetSize() == 14);
+    assert(chain.GetSegmentCount() == 3);
+    //segments are shared
+    assert(chain.GetSegment(1).Data() == body.Data());
+    assert(chain.Get(5) == 'b' && chain.Get(13) == 'l');
+    sharpen::ByteBuffer flat{chain.Flatten()};
+    assert(flat.GetSize() == 14 && std::memcmp(flat.Data(),"head:body:tail",14) == 0);
+    sharpen::BufferChain head{chain.Split(7)};
+    assert(head.GetSize() == 7 && head.GetSegmentCount() == 2);
+    assert(chain.GetSize() == 7 && chain.Get(0) == 'd');
+    assert(body.GetRefCount() == 3);
+    char buf[16];
+    sharpen::Size size{head.CopyTo(buf,sizeof(buf))};
+    assert(size == 7 && std::memcmp(buf,"head:bo",7) == 0);
+    chain.Consume(2);
+    assert(chain.GetSize() == 5 && chain.GetSegmentCount() == 1);
+    head.Append(std::move(chain));
+    assert(head.GetSize() == 12);
+    size = head.CopyTo(buf,sizeof(buf));
+    assert(size == 12 && std::memcmp(buf,"head:botail",11) != 0);
+    assert(std::memcmp(buf,"head:bo:tail",12) == 0);
+    (void)size;
+    bool thrown{false};
+    try
+    {
+        head.Consume(13);
+    }
+    catch(const std::out_of_range &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    (void)thrown;
+    head.Clear();
+    assert(head.Empty() && body.IsUnique());
+    std::printf("chain test pass\n");
+}
+
+int main()
+{
+    SliceTest();
+    CrossThreadTest();
+    ChainTest();
+    return 0;
+}
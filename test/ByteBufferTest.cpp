@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+#include <sharpen/ByteBuffer.hpp>
+
+void InlineTest()
+{
+    std::printf("inline test begin\n");
+    sharpen::ByteBuffer buf;
+    assert(buf.GetCapacity() == SHARPEN_BYTEBUFFER_INLINE_SIZE);
+    buf.Append("hello",5);
+    sharpen::ByteBuffer copy{buf};
+    assert(copy.GetSize() == 5 && std::memcmp(copy.Data(),"hello",5) == 0);
+    sharpen::ByteBuffer moved{std::move(copy)};
+    assert(moved.GetSize() == 5 && moved[4] == 'o');
+    assert(copy.GetSize() == 0);
+    //grow to the heap
+    for (sharpen::Size i = 0; i != 1000; ++i)
+    {
+        buf.PushBack(static_cast<char>(i & 0x7f));
+    }
+    assert(buf.GetSize() == 1005);
+    assert(buf.GetCapacity() >= 1005);
+    const char *data = buf.Data();
+    sharpen::ByteBuffer heap{std::move(buf)};
+    //the heap block is stolen
+    assert(heap.Data() == data);
+    (void)data;
+    heap.Swap(moved);
+    assert(heap.GetSize() == 5 && moved.GetSize() == 1005);
+    assert(moved[5] == 0 && moved[1004] == static_cast<char>(999 & 0x7f));
+    moved.ExtendTo(10);
+    moved.Shrink();
+    assert(moved.GetCapacity() == SHARPEN_BYTEBUFFER_INLINE_SIZE);
+    assert(std::memcmp(moved.Data(),"hello",5) == 0);
+    std::printf("inline test pass\n");
+}
+
+void ExtendTest()
+{
+    std::printf("extend test begin\n");
+    sharpen::ByteBuffer buf{4};
+    assert(buf.GetSize() == 4 && buf[3] == 0);
+    buf.Extend(4,'a');
+    assert(buf.GetSize() == 8 && buf[7] == 'a');
+    buf.ExtendUninitialized(100);
+    assert(buf.GetSize() == 108);
+    std::memset(buf.Data() + 8,'b',100);
+    buf.ExtendToUninitialized(50);
+    assert(buf.GetSize() == 50 && buf.Back() == 'b');
+    sharpen::Size capacity{buf.GetCapacity()};
+    buf.Reserve(capacity + 1);
+    assert(buf.GetCapacity() >= capacity*2);
+    (void)capacity;
+    buf.Erase(0,8);
+    assert(buf.GetSize() == 42 && buf.Front() == 'b');
+    buf.Mark(40);
+    buf.Erase(buf.Begin(),buf.Begin() + 10);
+    assert(buf.GetMark() == 32);
+    assert(buf.Find('a') == buf.End());
+    buf[0] = 'a';
+    assert(buf.Find('a') == buf.Begin());
+    assert(buf.ReverseFind('a') != buf.ReverseEnd());
+    std::printf("extend test pass\n");
+}
+
+int main()
+{
+    InlineTest();
+    ExtendTest();
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sharpen/ByteScan.hpp>
+#include <sharpen/ByteBuffer.hpp>
+
+void ScanTest()
+{
+    std::printf("scan test begin with %s\n",sharpen::GetByteScanImplementation());
+    std::mt19937 random{42};
+    //a small alphabet makes partial matches common
+    std::uniform_int_distribution<int> dist{'a','e'};
+    for (sharpen::Size size = 0; size != 300; ++size)
+    {
+        std::vector<char> data(size);
+        for (char &c : data)
+        {
+            c = static_cast<char>(dist(random));
+        }
+        const char *begin = data.data();
+        const char *end = begin + size;
+        for (char c = 'a'; c != 'g'; ++c)
+        {
+            assert(sharpen::ScanByte(begin,end,c) == std::find(begin,end,c));
+            const char *last = end;
+            for (const char *ite = begin; ite != end; ++ite)
+            {
+                if (*ite == c)
+                {
+                    last = ite;
+                }
+            }
+            assert(sharpen::ReverseScanByte(begin,end,c) == last);
+            (void)last;
+        }
+        const char set[] = "fed";
+        assert(sharpen::ScanAnyOf(begin,end,set,3) == std::find_first_of(begin,end,set,set + 3));
+        const char large[] = "ABCDEFGHIJKLMNOPQRSTe";
+        assert(sharpen::ScanAnyOf(begin,end,large,sizeof(large) - 1) == std::find_first_of(begin,end,large,large + sizeof(large) - 1));
+        const char *patterns[] = {"ab","abc","eeee","abcdeabcdeabcdeabcdeabcdeabcdeabcdeabcde","dcbad"};
+        for (const char *pattern : patterns)
+        {
+            sharpen::Size len{std::strlen(pattern)};
+            assert(sharpen::ScanPattern(begin,end,pattern,len) == std::search(begin,end,pattern,pattern + len));
+            (void)len;
+        }
+    }
+    std::printf("scan test pass\n");
+}
+
+void SplitTest()
+{
+    std::printf("split test begin\n");
+    const char line[] = "GET,/index.html,,HTTP/1.1,";
+    std::vector<std::string> pieces;
+    for (sharpen::ByteSpan span : sharpen::SplitBytes(line,line + sizeof(line) - 1,','))
+    {
+        pieces.emplace_back(span.Data(),span.GetSize());
+    }
+    assert(pieces.size() == 5);
+    assert(pieces[0] == "GET" && pieces[1] == "/index.html");
+    assert(pieces[2].empty() && pieces[3] == "HTTP/1.1" && pieces[4].empty());
+    sharpen::Size count{0};
+    for (sharpen::ByteSpan span : sharpen::SplitBytes(line,line,','))
+    {
+        assert(span.Empty());
+        (void)span;
+        ++count;
+    }
+    assert(count == 1);
+    (void)count;
+    std::printf("split test pass\n");
+}
+
+void BufferTest()
+{
+    std::printf("buffer test begin\n");
+    const char text[] = "Host: example.com\r\nAccept: */*\r\n\r\nbody";
+    sharpen::ByteBuffer buf{text,sizeof(text) - 1};
+    auto ite = buf.Search("\r\n\r\n",4);
+    assert(ite - buf.Begin() == 30);
+    ite = buf.FindAnyOf("\r:",2);
+    assert(*ite == ':' && ite - buf.Begin() == 4);
+    assert(*buf.ReverseFind('\n') == '\n');
+    assert(buf.ReverseFind('\n').base() - buf.Begin() == 34);
+    assert(buf.Search("none",4) == buf.End());
+    (void)ite;
+    std::printf("buffer test pass\n");
+}
+
+int main()
+{
+    ScanTest();
+    SplitTest();
+    BufferTest();
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include <cstdio>
+#include <cassert>
+
+#include <sharpen/AsyncOps.hpp>
+#include <sharpen/AsyncBarrier.hpp>
+#include <sharpen/Channel.hpp>
+
+void ChannelTest(sharpen::Size capacity,sharpen::Size producers,sharpen::Size count)
+{
+    std::printf("channel test begin capacity %zu\n",capacity);
+    sharpen::Channel<sharpen::Size> channel(capacity);
+    sharpen::AsyncBarrier barrier(producers);
+    for (sharpen::Size i = 0; i < producers; i++)
+    {
+        sharpen::Launch([&channel,&barrier,count]()
+        {
+            for (sharpen::Size j = 0; j < count; j++)
+            {
+                bool r = channel.SendAsync(j);
+                assert(r);
+                (void)r;
+            }
+            barrier.Notice();
+        });
+    }
+    sharpen::Launch([&channel,&barrier]()
+    {
+        barrier.WaitAsync();
+        channel.Close();
+    });
+    sharpen::Size sum{0};
+    sharpen::Size received{0};
+    sharpen::Size val;
+    while (channel.ReceiveAsync(val))
+    {
+        sum += val;
+        received += 1;
+    }
+    std::printf("sum is %zu\n",sum);
+    assert(received == producers*count);
+    assert(sum == producers*count*(count - 1)/2);
+    assert(channel.IsClosed());
+    bool r = channel.SendAsync(0);
+    assert(!r);
+    r = channel.TrySend(0);
+    assert(!r);
+    (void)r;
+    std::printf("channel test pass\n");
+}
+
+void SelectTest(sharpen::Size count)
+{
+    std::printf("select test begin\n");
+    sharpen::Channel<sharpen::Size> first;
+    sharpen::Channel<sharpen::Size> second(4);
+    sharpen::Channel<sharpen::Size> result;
+    sharpen::Launch([&first,count]()
+    {
+        for (sharpen::Size i = 0; i < count; i++)
+        {
+            first.SendAsync(i);
+        }
+        first.Close();
+    });
+    sharpen::Launch([&second,count]()
+    {
+        for (sharpen::Size i = 0; i < count; i++)
+        {
+            second.SendAsync(i);
+        }
+        second.Close();
+    });
+    sharpen::Launch([&first,&second,&result]()
+    {
+        sharpen::Size sum{0};
+        bool firstOpen{true};
+        bool secondOpen{true};
+        while (firstOpen || secondOpen)
+        {
+            sharpen::Size val{0};
+            if (!firstOpen)
+            {
+                secondOpen = second.ReceiveAsync(val);
+            }
+            else if (!secondOpen)
+            {
+                firstOpen = first.ReceiveAsync(val);
+            }
+            else
+            {
+                auto firstCase = sharpen::MakeReceiveCase(first,val);
+                auto secondCase = sharpen::MakeReceiveCase(second,val);
+                sharpen::Size index = sharpen::SelectAsync(firstCase,secondCase);
+                if (index == 0)
+                {
+                    firstOpen = firstCase.Ok();
+                }
+                else
+                {
+                    secondOpen = secondCase.Ok();
+                }
+            }
+            sum += val;
+        }
+        result.SendAsync(sum);
+    });
+    sharpen::Size sum{0};
+    bool r = result.ReceiveAsync(sum);
+    assert(r);
+    (void)r;
+    std::printf("sum is %zu\n",sum);
+    assert(sum == count*(count - 1));
+    //no case is ready
+    sharpen::Size val{0};
+    sharpen::Size index = sharpen::TrySelect(sharpen::MakeReceiveCase(result,val),sharpen::MakeSendCase(result,val));
+    assert(index == 2);
+    (void)index;
+    std::printf("select test pass\n");
+}
+
+int main()
+{
+    sharpen::EventEngine &engine = sharpen::EventEngine::SetupEngine();
+    engine.Startup([]()
+    {
+        ChannelTest(0,8,1000);
+        ChannelTest(16,8,1000);
+        SelectTest(1000);
+    });
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <cstdio>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <sharpen/CopyOnWriteObject.hpp>
+
+static std::atomic<sharpen::Size> liveCount(0);
+
+struct Config
+{
+    sharpen::Size first_;
+    sharpen::Size second_;
+
+    Config(sharpen::Size first,sharpen::Size second)
+        :first_(first)
+        ,second_(second)
+    {
+        liveCount += 1;
+    }
+
+    Config(const Config &other)
+        :first_(other.first_)
+        ,second_(other.second_)
+    {
+        liveCount += 1;
+    }
+
+    ~Config() noexcept
+    {
+        liveCount -= 1;
+    }
+};
+
+void CopyOnWriteTest(sharpen::Size readers,sharpen::Size writes)
+{
+    std::printf("copy on write test begin\n");
+    {
+        sharpen::CopyOnWriteObject<Config> config(0,0);
+        std::atomic_bool stop(false);
+        std::vector<std::thread> threads;
+        for (sharpen::Size i = 0; i < readers; i++)
+        {
+            threads.emplace_back([&config,&stop]()
+            {
+                sharpen::Size last{0};
+                while (!stop.load())
+                {
+                    auto guard = config.Read();
+                    //writers always keep both fields equal
+                    assert(guard->first_ == guard->second_);
+                    assert(guard->first_ >= last);
+                    last = guard->first_;
+                }
+            });
+        }
+        for (sharpen::Size i = 1; i <= writes; i++)
+        {
+            config.Write([i](Config &obj)
+            {
+                obj.first_ = i;
+                obj.second_ = i;
+            });
+        }
+        stop = true;
+        for (auto ite = threads.begin(); ite != threads.end(); ++ite)
+        {
+            ite->join();
+        }
+        sharpen::Size val = config.Read([](const Config &obj)
+        {
+            return obj.first_;
+        });
+        assert(val == writes);
+        config.Store(Config(1,1));
+        assert(config.Read()->first_ == 1);
+        (void)val;
+        sharpen::EpochReclaimer::Synchronize();
+        assert(liveCount == 1);
+    }
+    assert(liveCount == 0);
+    std::printf("copy on write test pass\n");
+}
+
+int main()
+{
+    CopyOnWriteTest(4,10000);
+    return 0;
+}
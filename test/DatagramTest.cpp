@@ -0,0 +1,148 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+#include <sharpen/IDatagramChannel.hpp>
+#include <sharpen/IpEndPoint.hpp>
+#include <sharpen/EventEngine.hpp>
+#include <sharpen/AsyncOps.hpp>
+
+sharpen::DatagramChannelPtr MakeChannel(sharpen::UintPort port)
+{
+    sharpen::DatagramChannelPtr channel = sharpen::MakeUdpChannel(sharpen::AddressFamily::Ip);
+    sharpen::IpEndPoint addr;
+    addr.SetAddrByString("127.0.0.1");
+    addr.SetPort(port);
+    channel->SetReuseAddress(true);
+    channel->Bind(addr);
+    channel->Register(sharpen::EventEngine::GetEngine());
+    return channel;
+}
+
+void BatchTest()
+{
+    std::printf("batch test begin\n");
+    sharpen::DatagramChannelPtr receiver = MakeChannel(8090);
+    sharpen::DatagramChannelPtr sender = MakeChannel(0);
+    sharpen::IpEndPoint senderAddr;
+    sender->GetLocalEndPoint(senderAddr);
+    sharpen::IpEndPoint receiverAddr;
+    receiver->GetLocalEndPoint(receiverAddr);
+    const sharpen::Size count{100};
+    std::vector<std::vector<char>> payloads(count);
+    std::vector<sharpen::Datagram> outs(count);
+    for (sharpen::Size i = 0; i != count; ++i)
+    {
+        payloads[i].assign(i + 1,static_cast<char>(i));
+        outs[i].SetBuffer(payloads[i].data(),payloads[i].size());
+        outs[i].SetRemoteEndPoint(receiverAddr);
+    }
+    sharpen::Size sent{sender->SendManyAsync(outs.data(),outs.size())};
+    assert(sent == count);
+    (void)sent;
+    std::vector<std::vector<char>> bufs(32,std::vector<char>(256));
+    std::vector<sharpen::Datagram> ins(bufs.size());
+    sharpen::Size received{0};
+    while (received != count)
+    {
+        for (sharpen::Size i = 0; i != ins.size(); ++i)
+        {
+            ins[i].SetBuffer(bufs[i].data(),bufs[i].size());
+        }
+        sharpen::Size size{receiver->ReceiveManyAsync(ins.data(),ins.size())};
+        assert(size != 0 && size <= ins.size());
+        for (sharpen::Size i = 0; i != size; ++i)
+        {
+            //loopback keeps the order
+            assert(ins[i].GetSize() == received + 1);
+            assert(!ins[i].IsTruncated());
+            assert(ins[i].Data()[received] == static_cast<char>(received));
+            sharpen::IpEndPoint remote;
+            ins[i].GetRemoteEndPoint(remote);
+            assert(remote == senderAddr);
+            sharpen::IpEndPoint local;
+            assert(ins[i].HasLocalEndPoint());
+            ins[i].GetLocalEndPoint(local);
+            assert(local == receiverAddr);
+            received += 1;
+        }
+    }
+    std::printf("batch test pass\n");
+}
+
+void TruncateTest()
+{
+    std::printf("truncate test begin\n");
+    sharpen::DatagramChannelPtr receiver = MakeChannel(8091);
+    sharpen::DatagramChannelPtr sender = MakeChannel(0);
+    sharpen::IpEndPoint receiverAddr;
+    receiver->GetLocalEndPoint(receiverAddr);
+    char big[64];
+    std::memset(big,'a',sizeof(big));
+    sharpen::Datagram out{big,sizeof(big)};
+    out.SetRemoteEndPoint(receiverAddr);
+    sender->SendManyAsync(&out,1);
+    char small[16];
+    sharpen::Datagram in{small,sizeof(small)};
+    sharpen::Size size{receiver->ReceiveManyAsync(&in,1)};
+    assert(size == 1 && in.IsTruncated() && in.GetSize() == sizeof(small));
+    (void)size;
+    std::printf("truncate test pass\n");
+}
+
+void OffloadTest()
+{
+    std::printf("offload test begin\n");
+    sharpen::DatagramChannelPtr receiver = MakeChannel(8092);
+    sharpen::DatagramChannelPtr sender = MakeChannel(0);
+    sharpen::IpEndPoint receiverAddr;
+    receiver->GetLocalEndPoint(receiverAddr);
+    bool gro{receiver->SetReceiveOffload(true)};
+    std::vector<char> payload(4000);
+    for (sharpen::Size i = 0; i != payload.size(); ++i)
+    {
+        payload[i] = static_cast<char>(i/1000);
+    }
+    sharpen::Datagram out{payload.data(),payload.size()};
+    out.SetRemoteEndPoint(receiverAddr);
+    out.SetSegmentSize(1000);
+    try
+    {
+        sender->SendManyAsync(&out,1);
+    }
+    catch(const std::system_error &e)
+    {
+        std::printf("segmentation offload is not supported: %s\n",e.what());
+        return;
+    }
+    std::vector<char> buf(8192);
+    sharpen::Size total{0};
+    while (total != payload.size())
+    {
+        sharpen::Datagram in{buf.data(),buf.size()};
+        receiver->ReceiveManyAsync(&in,1);
+        //one coalesced datagram with gro or one datagram per segment
+        assert(in.GetSize() == 1000 || (gro && in.GetSegmentSize() == 1000));
+        assert(std::memcmp(in.Data(),payload.data() + total,in.GetSize()) == 0);
+        total += in.GetSize();
+    }
+    std::printf("offload test pass\n");
+}
+
+int main()
+{
+    sharpen::StartupNetSupport();
+    sharpen::EventEngine &engine = sharpen::EventEngine::SetupEngine();
+    engine.Startup([]()
+    {
+        std::printf("datagram test begin\n");
+        BatchTest();
+        TruncateTest();
+        OffloadTest();
+        std::printf("datagram test pass\n");
+        sharpen::CleanupNetSupport();
+    });
+    return 0;
+}
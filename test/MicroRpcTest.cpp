@@ -1,6 +1,7 @@
 #include <sharpen/MicroRpcField.hpp>
 #include <sharpen/MicroRpcStack.hpp>
 #include <sharpen/MicroRpcDecoder.hpp>
+#include <sharpen/BufferSlice.hpp>
 
 void VariableEncodeTest()
 {
@@ -216,6 +217,73 @@ void MulitiStackTest()
     std::printf("pass\n");
 }
 
+void SliceDecodeTest()
+{
+    sharpen::ByteBuffer raw;
+    {
+        sharpen::MicroRpcStack stack;
+        const char str[] = "Hello";
+        const sharpen::Int32 arr[] = {1,2,3};
+        stack.Push(1);
+        stack.Push(arr,arr + 3);
+        stack.Push(str,str + sizeof(str));
+        stack.CopyTo(raw);
+    }
+    sharpen::BufferSlice buf{raw};
+    sharpen::MicroRpcStack stack;
+    sharpen::MicroRpcDecoder decoder;
+    decoder.Bind(stack);
+    sharpen::Size size = decoder.Decode(buf);
+    assert(size == buf.GetSize());
+    assert(decoder.IsCompleted());
+    assert(buf.GetRefCount() == 4);
+    const char *data = buf.Data();
+    for (auto begin = stack.Begin(),end = stack.End();begin != end;++begin)
+    {
+        assert(begin->IsSliced());
+        assert(begin->GetRawBytes() == data);
+        data += begin->GetRawSize();
+    }
+    assert(stack.Begin()->GetSize() == 6);
+    assert(std::strcmp(stack.Begin()->Data<char>(),"Hello") == 0);
+    //mutable access does not copy
+    assert(stack.Begin()->Data<char>() == buf.Data() + 2);
+    assert(stack.Begin()->IsSliced());
+    //writes after unsharing never reach the shared block
+    stack.Begin()->Unshare();
+    assert(!stack.Begin()->IsSliced());
+    assert(buf.GetRefCount() == 3);
+    stack.Begin()->Data<char>()[0] = 'h';
+    assert(buf[2] == 'H');
+    assert(std::strcmp(stack.Begin()->Data<char>(),"hello") == 0);
+    //split in the middle of the second field
+    decoder.SetCompleted(false);
+    stack.Clear();
+    sharpen::Size split = 10;
+    size = decoder.Decode(buf.Slice(0,split));
+    assert(size == split);
+    assert(!decoder.IsCompleted());
+    size = decoder.Decode(buf.Slice(split));
+    assert(size == buf.GetSize() - split);
+    assert(decoder.IsCompleted());
+    data = buf.Data();
+    sharpen::Size sliced{0};
+    for (auto begin = stack.Begin(),end = stack.End();begin != end;++begin)
+    {
+        assert(std::memcmp(begin->GetRawBytes(),data,begin->GetRawSize()) == 0);
+        data += begin->GetRawSize();
+        if (begin->IsSliced())
+        {
+            ++sliced;
+        }
+    }
+    assert(data == buf.Data() + buf.GetSize());
+    assert(sliced == 2);
+    (void)size;
+    (void)sliced;
+    std::printf("pass\n");
+}
+
 int main(int argc, char const *argv[])
 {
     std::printf("encode variable test\n");
@@ -232,5 +300,7 @@ int main(int argc, char const *argv[])
     MultiDecodeTest();
     std::printf("multi stack decode test\n");
     MulitiStackTest();
+    std::printf("slice decode test\n");
+    SliceDecodeTest();
     return 0;
 }
\ No newline at end of file
@@ -1,8 +1,19 @@
 #include <cassert>
 #include <cstdio>
+#include <cstring>
+#include <vector>
+#include <string>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <memory>
 
 #include <sharpen/INetStreamChannel.hpp>
+#include <sharpen/BufferedStreamReader.hpp>
 #include <sharpen/IpEndPoint.hpp>
+#include <sharpen/UnixEndPoint.hpp>
+#include <sharpen/TcpAcceptor.hpp>
+#include <sharpen/SpliceOps.hpp>
 #include <sharpen/EventEngine.hpp>
 #include <sharpen/AsyncOps.hpp>
 
@@ -103,6 +114,597 @@ void CancelTest()
     assert(flag == 10);
 }
 
+void GatherWriteClient(sharpen::Size expected)
+{
+    sharpen::NetStreamChannelPtr client = sharpen::MakeTcpStreamChannel(sharpen::AddressFamily::Ip);
+    sharpen::IpEndPoint addr;
+    addr.SetAddrByString("127.0.0.1");
+    addr.SetPort(0);
+    client->Bind(addr);
+    client->Register(sharpen::EventEngine::GetEngine());
+    addr.SetPort(8081);
+    client->ConnectAsync(addr);
+    sharpen::ByteBuffer buf{expected};
+    sharpen::Size size{0};
+    while (size != expected)
+    {
+        sharpen::Size sz{client->ReadAsync(buf.Data() + size,expected - size)};
+        assert(sz != 0);
+        size += sz;
+    }
+    //header + body + trailer
+    assert(buf[0] == 'h' && buf[5] == 'b' && buf[expected - 1] == 't');
+    for (sharpen::Size i = 5; i != expected - 2000; ++i)
+    {
+        assert(buf[i] == 'b');
+    }
+    for (sharpen::Size i = expected - 2000; i != expected; ++i)
+    {
+        assert(buf[i] == 't');
+    }
+    client->WriteAsync(data,1);
+}
+
+void GatherWriteTest()
+{
+    std::printf("gather write test begin\n");
+    sharpen::NetStreamChannelPtr server = sharpen::MakeTcpStreamChannel(sharpen::AddressFamily::Ip);
+    sharpen::IpEndPoint addr;
+    addr.SetAddrByString("127.0.0.1");
+    addr.SetPort(8081);
+    server->SetReuseAddress(true);
+    server->Bind(addr);
+    server->Register(sharpen::EventEngine::GetEngine());
+    server->Listen(65535);
+    //large enough to need several writev calls
+    sharpen::BufferSlice body{4*1024*1024};
+    std::memset(body.Data(),'b',body.GetSize());
+    sharpen::BufferChain chain;
+    chain.Append(body);
+    chain.Prepend("hhhhh",5);
+    //more segments than IOV_MAX
+    for (sharpen::Size i = 0; i != 2000; ++i)
+    {
+        chain.Append(sharpen::BufferSlice{"t",1});
+    }
+    assert(chain.GetSegmentCount() == 2002);
+    sharpen::Size expected{chain.GetSize()};
+    sharpen::AwaitableFuture<void> clientFuture;
+    sharpen::Launch([expected,&clientFuture]()
+    {
+        GatherWriteClient(expected);
+        clientFuture.Complete();
+    });
+    sharpen::NetStreamChannelPtr conn = server->AcceptAsync();
+    conn->Register(sharpen::EventEngine::GetEngine());
+    sharpen::Size size{conn->WriteAsync(chain)};
+    assert(size == expected);
+    (void)size;
+    char ack;
+    conn->ReadAsync(&ack,1);
+    clientFuture.Await();
+    std::printf("gather write test pass\n");
+}
+
+void StreamReaderClient()
+{
+    sharpen::NetStreamChannelPtr client = sharpen::MakeTcpStreamChannel(sharpen::AddressFamily::Ip);
+    sharpen::IpEndPoint addr;
+    addr.SetAddrByString("127.0.0.1");
+    addr.SetPort(0);
+    client->Bind(addr);
+    client->Register(sharpen::EventEngine::GetEngine());
+    addr.SetPort(8082);
+    client->ConnectAsync(addr);
+    const char head[] = "first line\r\nsecond\nkey=value||abcd";
+    //send byte by byte so the reader must wait for more data
+    for (sharpen::Size i = 0; i != sizeof(head) - 1; ++i)
+    {
+        client->WriteAsync(head + i,1);
+    }
+    std::vector<char> body(100000,'x');
+    client->WriteAsync(body.data(),body.size());
+    client->WriteAsync("tail",4);
+    client->Close();
+}
+
+void StreamReaderTest()
+{
+    std::printf("stream reader test begin\n");
+    sharpen::NetStreamChannelPtr server = sharpen::MakeTcpStreamChannel(sharpen::AddressFamily::Ip);
+    sharpen::IpEndPoint addr;
+    addr.SetAddrByString("127.0.0.1");
+    addr.SetPort(8082);
+    server->SetReuseAddress(true);
+    server->Bind(addr);
+    server->Register(sharpen::EventEngine::GetEngine());
+    server->Listen(65535);
+    sharpen::AwaitableFuture<void> clientFuture;
+    sharpen::Launch([&clientFuture]()
+    {
+        StreamReaderClient();
+        clientFuture.Complete();
+    });
+    sharpen::NetStreamChannelPtr conn = server->AcceptAsync();
+    conn->Register(sharpen::EventEngine::GetEngine());
+    //a tiny window forces growth and compaction
+    sharpen::BufferedStreamReader reader{conn,8,64};
+    sharpen::ByteBuffer line;
+    bool ok{reader.ReadLineAsync(line)};
+    assert(ok && line.GetSize() == 10 && std::memcmp(line.Data(),"first line",10) == 0);
+    line.Clear();
+    ok = reader.ReadLineAsync(line);
+    assert(ok && line.GetSize() == 6 && std::memcmp(line.Data(),"second",6) == 0);
+    (void)ok;
+    sharpen::ByteBuffer field;
+    sharpen::Size size{reader.ReadUntilAsync(field,"||",2)};
+    assert(size == 11 && std::memcmp(field.Data(),"key=value||",11) == 0);
+    sharpen::ByteSpan span{reader.PeekAsync(4)};
+    assert(span.GetSize() >= 4 && std::memcmp(span.Data(),"abcd",4) == 0);
+    (void)span;
+    reader.Consume(4);
+    sharpen::ByteBuffer body;
+    size = reader.ReadExactAsync(body,100000);
+    assert(size == 100000 && body[99999] == 'x');
+    //the stream ends before the delimiter
+    sharpen::ByteBuffer tail;
+    size = reader.ReadUntilAsync(tail,'\n');
+    assert(size == 4 && std::memcmp(tail.Data(),"tail",4) == 0);
+    size = reader.ReadUntilAsync(tail,'\n');
+    assert(size == 0 && reader.IsEof());
+    (void)size;
+    clientFuture.Await();
+    std::printf("stream reader test pass\n");
+}
+
+void CoalesceWriteClient(sharpen::Size expected)
+{
+    sharpen::NetStreamChannelPtr client = sharpen::MakeTcpStreamChannel(sharpen::AddressFamily::Ip);
+    sharpen::IpEndPoint addr;
+    addr.SetAddrByString("127.0.0.1");
+    addr.SetPort(0);
+    client->Bind(addr);
+    client->Register(sharpen::EventEngine::GetEngine());
+    addr.SetPort(8083);
+    client->ConnectAsync(addr);
+    sharpen::ByteBuffer buf{expected};
+    sharpen::Size size{0};
+    while (size != expected)
+    {
+        sharpen::Size sz{client->ReadAsync(buf.Data() + size,expected - size)};
+        assert(sz != 0);
+        size += sz;
+    }
+    //every write keeps its place in the stream
+    for (sharpen::Size i = 0; i != expected; ++i)
+    {
+        assert(buf[i] == static_cast<char>('a' + (i/16)%26));
+    }
+    client->WriteAsync(data,1);
+}
+
+void CoalesceWriteTest()
+{
+    std::printf("coalesce write test begin\n");
+    sharpen::NetStreamChannelPtr server = sharpen::MakeTcpStreamChannel(sharpen::AddressFamily::Ip);
+    sharpen::IpEndPoint addr;
+    addr.SetAddrByString("127.0.0.1");
+    addr.SetPort(8083);
+    server->SetReuseAddress(true);
+    server->Bind(addr);
+    server->Register(sharpen::EventEngine::GetEngine());
+    server->Listen(65535);
+    //the parked half is flushed as more than IOV_MAX buffers
+    const sharpen::Size count{3000};
+    const sharpen::Size chunk{16};
+    const sharpen::Size mark{64};
+    std::vector<char> payload(count*chunk);
+    for (sharpen::Size i = 0; i != payload.size(); ++i)
+    {
+        payload[i] = static_cast<char>('a' + (i/chunk)%26);
+    }
+    sharpen::AwaitableFuture<void> clientFuture;
+    sharpen::Launch([&payload,&clientFuture]()
+    {
+        CoalesceWriteClient(payload.size());
+        clientFuture.Complete();
+    });
+    sharpen::NetStreamChannelPtr conn = server->AcceptAsync();
+    //writes issued on the channel's loop share one iteration
+    conn->Register(sharpen::EventLoop::GetLocalLoop());
+    conn->SetWriteCoalescing(true);
+    conn->SetWriteHighWaterMark(mark);
+    std::unique_ptr<sharpen::AwaitableFuture<sharpen::Size>[]> futures{new sharpen::AwaitableFuture<sharpen::Size>[count]};
+    sharpen::Size half{count/2};
+    //wait until the socket is writable
+    conn->WriteAsync(payload.data(),chunk,futures[0]);
+    futures[0].Await();
+    sharpen::Size calls{conn->GetWriteCallCount()};
+    for (sharpen::Size i = 1; i != half; ++i)
+    {
+        conn->WriteAsync(payload.data() + i*chunk,chunk,futures[i]);
+        //writes beyond the mark are parked
+        assert(conn->GetPendingWriteSize() <= mark);
+    }
+    for (sharpen::Size i = 0; i != half; ++i)
+    {
+        sharpen::Size size{futures[i].Await()};
+        assert(size == chunk);
+        (void)size;
+    }
+    assert(conn->GetPendingWriteSize() == 0);
+    //each writev carries every write admitted under the mark
+    calls = conn->GetWriteCallCount() - calls;
+    assert(calls <= half/2);
+    (void)calls;
+    for (sharpen::Size i = half; i != count; ++i)
+    {
+        conn->WriteAsync(payload.data() + i*chunk,chunk,futures[i]);
+    }
+    assert(conn->GetPendingWriteSize() == mark);
+    //lowering the mark admits the parked writes in order
+    conn->SetWriteHighWaterMark(0);
+    assert(conn->GetPendingWriteSize() == (count - half)*chunk);
+    for (sharpen::Size i = half; i != count; ++i)
+    {
+        sharpen::Size size{futures[i].Await()};
+        assert(size == chunk);
+        (void)size;
+    }
+    assert(conn->GetPendingWriteSize() == 0);
+    char ack;
+    conn->ReadAsync(&ack,1);
+    clientFuture.Await();
+    std::printf("coalesce write test pass\n");
+}
+
+void ZeroCopyClient(sharpen::Size expected)
+{
+    sharpen::NetStreamChannelPtr client = sharpen::MakeTcpStreamChannel(sharpen::AddressFamily::Ip);
+    sharpen::IpEndPoint addr;
+    addr.SetAddrByString("127.0.0.1");
+    addr.SetPort(0);
+    client->Bind(addr);
+    client->Register(sharpen::EventEngine::GetEngine());
+    addr.SetPort(8084);
+    client->ConnectAsync(addr);
+    sharpen::ByteBuffer buf{expected};
+    sharpen::Size size{0};
+    while (size != expected)
+    {
+        sharpen::Size sz{client->ReadAsync(buf.Data() + size,expected - size)};
+        assert(sz != 0);
+        size += sz;
+    }
+    //small writes keep their place around zero copy writes
+    const sharpen::Size large{1024*1024};
+    assert(std::memcmp(buf.Data(),"head",4) == 0);
+    assert(buf[4] == 'x' && buf[4 + large - 1] == 'x');
+    assert(std::memcmp(buf.Data() + 4 + large,"middle",6) == 0);
+    assert(buf[10 + large] == 'y' && buf[10 + 2*large - 1] == 'y');
+    assert(std::memcmp(buf.Data() + 10 + 2*large,"tail",4) == 0);
+    (void)large;
+    client->WriteAsync(data,1);
+}
+
+void ZeroCopyTest()
+{
+    std::printf("zero copy test begin\n");
+    sharpen::NetStreamChannelPtr server = sharpen::MakeTcpStreamChannel(sharpen::AddressFamily::Ip);
+    sharpen::IpEndPoint addr;
+    addr.SetAddrByString("127.0.0.1");
+    addr.SetPort(8084);
+    server->SetReuseAddress(true);
+    server->Bind(addr);
+    server->Register(sharpen::EventEngine::GetEngine());
+    server->Listen(65535);
+    const sharpen::Size large{1024*1024};
+    std::vector<char> first(large,'x');
+    std::vector<char> second(large,'y');
+    sharpen::Size expected{4 + large + 6 + large + 4};
+    sharpen::AwaitableFuture<void> clientFuture;
+    sharpen::Launch([expected,&clientFuture]()
+    {
+        ZeroCopyClient(expected);
+        clientFuture.Complete();
+    });
+    sharpen::NetStreamChannelPtr conn = server->AcceptAsync();
+    conn->Register(sharpen::EventEngine::GetEngine());
+    conn->SetZeroCopyThreshold(64*1024);
+    if (!conn->GetZeroCopyThreshold())
+    {
+        std::printf("zero copy is not supported, writes are copied\n");
+    }
+    sharpen::AwaitableFuture<sharpen::Size> futures[5];
+    conn->WriteAsync("head",4,futures[0]);
+    conn->WriteAsync(first.data(),first.size(),futures[1]);
+    conn->WriteAsync("middle",6,futures[2]);
+    conn->WriteAsync(second.data(),second.size(),futures[3]);
+    conn->WriteAsync("tail",4,futures[4]);
+    //the large futures are completed after the kernel releases the buffers
+    sharpen::Size sizes[5];
+    for (sharpen::Size i = 0; i != 5; ++i)
+    {
+        sizes[i] = futures[i].Await();
+    }
+    assert(sizes[0] == 4 && sizes[1] == large && sizes[2] == 6 && sizes[3] == large && sizes[4] == 4);
+    (void)sizes;
+    char ack;
+    conn->ReadAsync(&ack,1);
+    clientFuture.Await();
+    std::printf("zero copy test pass\n");
+}
+
+void ZeroCopyCancelClient(sharpen::AwaitableFuture<void> &readFuture)
+{
+    sharpen::NetStreamChannelPtr client = sharpen::MakeTcpStreamChannel(sharpen::AddressFamily::Ip);
+    sharpen::IpEndPoint addr;
+    addr.SetAddrByString("127.0.0.1");
+    addr.SetPort(0);
+    client->Bind(addr);
+    client->Register(sharpen::EventEngine::GetEngine());
+    addr.SetPort(8085);
+    client->ConnectAsync(addr);
+    //leave the bytes in the send queue
+    readFuture.Await();
+    std::vector<char> buf(64*1024);
+    //the server writes one marker byte after the cancelled write
+    sharpen::Size sz{0};
+    do
+    {
+        sz = client->ReadAsync(buf.data(),buf.size());
+        assert(sz != 0);
+    } while (buf[sz - 1] == 'z');
+    assert(buf[sz - 1] == 'e');
+}
+
+void ZeroCopyCancelTest()
+{
+    std::printf("zero copy cancel test begin\n");
+    sharpen::NetStreamChannelPtr server = sharpen::MakeTcpStreamChannel(sharpen::AddressFamily::Ip);
+    sharpen::IpEndPoint addr;
+    addr.SetAddrByString("127.0.0.1");
+    addr.SetPort(8085);
+    server->SetReuseAddress(true);
+    server->Bind(addr);
+    server->Register(sharpen::EventEngine::GetEngine());
+    server->Listen(65535);
+    sharpen::AwaitableFuture<void> readFuture;
+    sharpen::AwaitableFuture<void> clientFuture;
+    sharpen::Launch([&readFuture,&clientFuture]()
+    {
+        ZeroCopyCancelClient(readFuture);
+        clientFuture.Complete();
+    });
+    sharpen::NetStreamChannelPtr conn = server->AcceptAsync();
+    conn->Register(sharpen::EventEngine::GetEngine());
+    conn->SetZeroCopyThreshold(64*1024);
+    //larger than the socket buffers
+    std::vector<char> data(16*1024*1024,'z');
+    sharpen::AwaitableFuture<sharpen::Size> future;
+    conn->WriteAsync(data.data(),data.size(),future);
+    sharpen::Delay(std::chrono::milliseconds(50));
+    conn->Cancel();
+    sharpen::Delay(std::chrono::milliseconds(50));
+    //the kernel still holds the pages in the send queue
+    assert(!conn->GetZeroCopyThreshold() || future.IsPending());
+    readFuture.Complete();
+    try
+    {
+        future.Await();
+    }
+    catch(const std::system_error &e)
+    {
+        //the rest of the write is cancelled
+        assert(e.code().value() == ECANCELED);
+        (void)e;
+    }
+    conn->WriteAsync("e",1);
+    clientFuture.Await();
+    std::printf("zero copy cancel test pass\n");
+}
+
+void ReadFull(sharpen::NetStreamChannelPtr channel,char *buf,sharpen::Size size)
+{
+    sharpen::Size offset{0};
+    while (offset != size)
+    {
+        sharpen::Size sz{channel->ReadAsync(buf + offset,size - offset)};
+        assert(sz != 0);
+        offset += sz;
+    }
+}
+
+void UnixSocketClient(const sharpen::UnixEndPoint &endpoint)
+{
+    sharpen::NetStreamChannelPtr client = sharpen::MakeUnixStreamChannel();
+    client->Register(sharpen::EventEngine::GetEngine());
+    client->ConnectAsync(endpoint);
+    sharpen::UnixEndPoint remote;
+    client->GetRemoteEndPoint(remote);
+    assert(remote == endpoint && remote.IsAbstract());
+    char buf[5];
+    ReadFull(client,buf,sizeof(buf));
+    assert(std::memcmp(buf,"hello",5) == 0);
+    sharpen::FileHandle handles[2];
+    sharpen::Size count{client->ReceiveHandlesAsync(handles,2)};
+    assert(count == 1);
+    (void)count;
+    ReadFull(client,buf,sizeof(buf));
+    assert(std::memcmp(buf,"after",5) == 0);
+    //the received handle is the read end of the pipe
+    char pipeBuf[4];
+    ssize_t sz = ::read(handles[0],pipeBuf,sizeof(pipeBuf));
+    assert(sz == 4 && std::memcmp(pipeBuf,"pipe",4) == 0);
+    (void)sz;
+    ::close(handles[0]);
+    client->WriteAsync(data,1);
+}
+
+void UnixSocketTest()
+{
+    std::printf("unix socket test begin\n");
+    sharpen::UnixEndPoint endpoint;
+    std::string name{"sharpen-network-test-"};
+    name += std::to_string(::getpid());
+    endpoint.SetAbstractName(name.data(),name.size());
+    sharpen::TcpAcceptor acceptor{sharpen::AddressFamily::Unix,endpoint,sharpen::EventEngine::GetEngine()};
+    sharpen::UnixEndPoint local;
+    acceptor.GetLocalEndPoint(local);
+    assert(local == endpoint && local.GetPath() == name);
+    int fds[2];
+    int r = ::pipe(fds);
+    assert(r == 0);
+    (void)r;
+    sharpen::AwaitableFuture<void> clientFuture;
+    sharpen::Launch([&endpoint,&clientFuture]()
+    {
+        UnixSocketClient(endpoint);
+        clientFuture.Complete();
+    });
+    sharpen::NetStreamChannelPtr conn = acceptor.AcceptAsync();
+    conn->Register(sharpen::EventEngine::GetEngine());
+    sharpen::AwaitableFuture<sharpen::Size> first;
+    sharpen::AwaitableFuture<void> handleFuture;
+    sharpen::AwaitableFuture<sharpen::Size> second;
+    //the handles keep their place between the writes
+    conn->WriteAsync("hello",5,first);
+    conn->SendHandlesAsync(fds,1,handleFuture);
+    conn->WriteAsync("after",5,second);
+    first.Await();
+    handleFuture.Await();
+    second.Await();
+    ::close(fds[0]);
+    ssize_t sz = ::write(fds[1],"pipe",4);
+    assert(sz == 4);
+    (void)sz;
+    char ack;
+    conn->ReadAsync(&ack,1);
+    clientFuture.Await();
+    ::close(fds[1]);
+    std::printf("unix socket test pass\n");
+}
+
+void UnixPathTest()
+{
+    std::printf("unix path test begin\n");
+    std::string path{"/tmp/sharpen-network-test-"};
+    path += std::to_string(::getpid());
+    ::unlink(path.c_str());
+    sharpen::UnixEndPoint endpoint{path.c_str()};
+    assert(!endpoint.IsAbstract() && endpoint.GetPath() == path);
+    sharpen::NetStreamChannelPtr server = sharpen::MakeTcpStreamChannel(sharpen::AddressFamily::Unix);
+    server->Bind(endpoint);
+    server->Register(sharpen::EventEngine::GetEngine());
+    server->Listen(16);
+    sharpen::UnixEndPoint local;
+    server->GetLocalEndPoint(local);
+    assert(local == endpoint);
+    sharpen::NetStreamChannelPtr client = sharpen::MakeUnixStreamChannel();
+    client->Register(sharpen::EventEngine::GetEngine());
+    client->ConnectAsync(endpoint);
+    sharpen::NetStreamChannelPtr conn = server->AcceptAsync();
+    conn->Register(sharpen::EventEngine::GetEngine());
+    client->WriteAsync(data,sizeof(data) - 1);
+    char buf[sizeof(data) - 1];
+    ReadFull(conn,buf,sizeof(buf));
+    assert(std::memcmp(buf,data,sizeof(buf)) == 0);
+    ::unlink(path.c_str());
+    std::printf("unix path test pass\n");
+}
+
+void MakeTcpPair(sharpen::UintPort port,sharpen::NetStreamChannelPtr &client,sharpen::NetStreamChannelPtr &server)
+{
+    sharpen::NetStreamChannelPtr listener = sharpen::MakeTcpStreamChannel(sharpen::AddressFamily::Ip);
+    sharpen::IpEndPoint addr;
+    addr.SetAddrByString("127.0.0.1");
+    addr.SetPort(port);
+    listener->SetReuseAddress(true);
+    listener->Bind(addr);
+    listener->Register(sharpen::EventEngine::GetEngine());
+    listener->Listen(16);
+    client = sharpen::MakeTcpStreamChannel(sharpen::AddressFamily::Ip);
+    client->Register(sharpen::EventEngine::GetEngine());
+    //loopback connections complete in the backlog
+    client->ConnectAsync(addr);
+    server = listener->AcceptAsync();
+    server->Register(sharpen::EventEngine::GetEngine());
+}
+
+void SpliceTest()
+{
+    std::printf("splice test begin\n");
+    sharpen::NetStreamChannelPtr firstClient;
+    sharpen::NetStreamChannelPtr firstServer;
+    MakeTcpPair(8085,firstClient,firstServer);
+    sharpen::NetStreamChannelPtr secondClient;
+    sharpen::NetStreamChannelPtr secondServer;
+    MakeTcpPair(8086,secondClient,secondServer);
+    const sharpen::Size large{1024*1024};
+    std::vector<char> payload(large);
+    for (sharpen::Size i = 0; i != large; ++i)
+    {
+        payload[i] = static_cast<char>(i*13);
+    }
+    sharpen::AwaitableFuture<sharpen::Size> first;
+    sharpen::AwaitableFuture<sharpen::Size> second;
+    firstClient->WriteAsync(payload.data(),payload.size(),first);
+    firstClient->WriteAsync("tail",4,second);
+    sharpen::AwaitableFuture<void> readerFuture;
+    std::vector<char> buf(large);
+    sharpen::Launch([&secondServer,&buf,&readerFuture]()
+    {
+        ReadFull(secondServer,buf.data(),buf.size());
+        readerFuture.Complete();
+    });
+    sharpen::Size size{sharpen::SpliceAsync(*firstServer,*secondClient,large)};
+    assert(size == large);
+    (void)size;
+    readerFuture.Await();
+    assert(buf == payload);
+    //the bytes after the splice are left for normal reads
+    char tail[4];
+    ReadFull(firstServer,tail,sizeof(tail));
+    assert(std::memcmp(tail,"tail",4) == 0);
+    first.Await();
+    second.Await();
+    std::printf("splice test pass\n");
+}
+
+void ProxyTest()
+{
+    std::printf("proxy test begin\n");
+    sharpen::NetStreamChannelPtr downstream;
+    sharpen::NetStreamChannelPtr proxyDown;
+    MakeTcpPair(8087,downstream,proxyDown);
+    sharpen::NetStreamChannelPtr proxyUp;
+    sharpen::NetStreamChannelPtr upstream;
+    MakeTcpPair(8088,proxyUp,upstream);
+    sharpen::AwaitableFuture<void> proxyFuture;
+    sharpen::Launch([&proxyDown,&proxyUp,&proxyFuture]()
+    {
+        sharpen::ProxyAsync(*proxyDown,*proxyUp);
+        proxyFuture.Complete();
+    });
+    char buf[4];
+    downstream->WriteAsync("ping",4);
+    ReadFull(upstream,buf,sizeof(buf));
+    assert(std::memcmp(buf,"ping",4) == 0);
+    upstream->WriteAsync("pong",4);
+    ReadFull(downstream,buf,sizeof(buf));
+    assert(std::memcmp(buf,"pong",4) == 0);
+    //the end of stream is forwarded
+    ::shutdown(downstream->GetHandle(),SHUT_WR);
+    sharpen::Size size{upstream->ReadAsync(buf,sizeof(buf))};
+    assert(size == 0);
+    ::shutdown(upstream->GetHandle(),SHUT_WR);
+    size = downstream->ReadAsync(buf,sizeof(buf));
+    assert(size == 0);
+    (void)size;
+    proxyFuture.Await();
+    std::printf("proxy test pass\n");
+}
+
 void NetworkTest()
 {
     sharpen::StartupNetSupport();
@@ -112,6 +714,15 @@ void NetworkTest()
         std::printf("network test begin\n");
         ServerTest();
         CancelTest();
+        GatherWriteTest();
+        StreamReaderTest();
+        CoalesceWriteTest();
+        ZeroCopyTest();
+        ZeroCopyCancelTest();
+        UnixSocketTest();
+        UnixPathTest();
+        SpliceTest();
+        ProxyTest();
         std::printf("network test pass\n");
         sharpen::CleanupNetSupport();
     });
@@ -0,0 +1,71 @@
+#include <cstdio>
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <sharpen/ParallelSort.hpp>
+
+void ParallelSortTest(sharpen::Size size)
+{
+    sharpen::EventEngine &engine = sharpen::EventEngine::SetupEngine();
+    engine.Startup([size]()
+    {
+        std::printf("parallel sort test begin\n");
+        std::srand(1);
+        std::vector<int> vec(size);
+        for (sharpen::Size i = 0; i < size; i++)
+        {
+            vec[i] = std::rand();
+        }
+        std::vector<int> expected(vec);
+        std::sort(expected.begin(),expected.end());
+        sharpen::ParallelSort(vec.begin(),vec.end());
+        assert(vec == expected);
+        std::printf("parallel sort test pass\n");
+        std::printf("parallel stable sort test begin\n");
+        sharpen::ComputePool pool(4);
+        std::vector<std::pair<int,sharpen::Size>> pairs(size);
+        for (sharpen::Size i = 0; i < size; i++)
+        {
+            pairs[i].first = std::rand() % 100;
+            pairs[i].second = i;
+        }
+        auto comp = [](const std::pair<int,sharpen::Size> &a,const std::pair<int,sharpen::Size> &b)
+        {
+            return a.first < b.first;
+        };
+        sharpen::ParallelStableSort(pool,pairs.begin(),pairs.end(),comp);
+        for (sharpen::Size i = 1; i < size; i++)
+        {
+            assert(pairs[i - 1].first < pairs[i].first || (pairs[i - 1].first == pairs[i].first && pairs[i - 1].second < pairs[i].second));
+        }
+        std::printf("parallel stable sort test pass\n");
+        std::printf("parallel merge test begin\n");
+        std::vector<int> first(size/2);
+        std::vector<int> second(size - size/2);
+        for (sharpen::Size i = 0; i < first.size(); i++)
+        {
+            first[i] = static_cast<int>(i*2);
+        }
+        for (sharpen::Size i = 0; i < second.size(); i++)
+        {
+            second[i] = static_cast<int>(i*3);
+        }
+        std::vector<int> merged(size);
+        std::vector<int> merged2(size);
+        auto end = sharpen::ParallelMerge(pool,first.begin(),first.end(),second.begin(),second.end(),merged.begin());
+        assert(end == merged.end());
+        (void)end;
+        std::merge(first.begin(),first.end(),second.begin(),second.end(),merged2.begin());
+        assert(merged == merged2);
+        std::printf("parallel merge test pass\n");
+    });
+}
+
+int main()
+{
+    ParallelSortTest(1000*1000 + 7);
+    return 0;
+}
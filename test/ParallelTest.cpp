@@ -1,5 +1,9 @@
 #include <cstdio>
+#include <string>
+#include <vector>
+#include <stdexcept>
 #include <sharpen/AsyncOps.hpp>
+#include <sharpen/ComputePool.hpp>
 
 void ParallelTest(size_t n)
 {
@@ -20,6 +24,88 @@ void ParallelTest(size_t n)
         std::printf("r is %zu ar is %zu\n",r,ar.load());
         assert(r == ar);
         std::printf("parallel test pass\n");
+        std::printf("parallel reduce test begin\n");
+        size_t sum = sharpen::ParallelReduce(0,n,100,static_cast<size_t>(0),[](size_t i)
+        {
+            return i;
+        },[](size_t a,size_t b)
+        {
+            return a + b;
+        });
+        std::printf("sum is %zu\n",sum);
+        assert(sum == r);
+        std::printf("parallel reduce test pass\n");
+        std::printf("parallel scan test begin\n");
+        std::vector<size_t> vec(n,1);
+        sharpen::ParallelScan(vec.begin(),vec.end(),vec.begin(),100,static_cast<size_t>(0),[](size_t a,size_t b)
+        {
+            return a + b;
+        });
+        for (size_t i = 0; i < n; i++)
+        {
+            assert(vec[i] == i + 1);
+        }
+        std::printf("parallel scan test pass\n");
+        std::printf("compute pool test begin\n");
+        sharpen::ComputePool pool(4);
+        //uneven cost
+        std::vector<size_t> out(n,0);
+        sharpen::ParallelFor(pool,0,n,16,[&out](size_t i)
+        {
+            size_t val{0};
+            size_t round{i < 64 ? i*100:1};
+            for (size_t j = 0; j < round; j++)
+            {
+                val += j;
+            }
+            out[i] = val + 1;
+        });
+        for (size_t i = 0; i < n; i++)
+        {
+            assert(out[i] != 0);
+        }
+        //reduce keeps the order
+        std::string digits("0123456789");
+        std::string str = sharpen::ParallelReduce(pool,0,1000,10,std::string(),[&digits](size_t i)
+        {
+            return std::string(1,digits[i % 10]);
+        },[](std::string a,const std::string &b)
+        {
+            return a + b;
+        });
+        assert(str.size() == 1000);
+        for (size_t i = 0; i < str.size(); i++)
+        {
+            assert(str[i] == digits[i % 10]);
+        }
+        bool thrown{false};
+        try
+        {
+            sharpen::ParallelFor(pool,0,n,1,[](size_t i)
+            {
+                if (i == 7)
+                {
+                    throw std::runtime_error("error");
+                }
+            });
+        }
+        catch(const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+        (void)thrown;
+        //every worker waits in a nested call
+        std::atomic_size_t nested{0};
+        sharpen::ParallelFor(pool,0,pool.GetWorkerNumber(),1,[&pool,&nested](size_t)
+        {
+            sharpen::ParallelFor(pool,0,pool.GetWorkerNumber() + 1,1,[&nested](size_t)
+            {
+                nested.fetch_add(1);
+            });
+        });
+        assert(nested == pool.GetWorkerNumber()*(pool.GetWorkerNumber() + 1));
+        std::printf("compute pool test pass\n");
     });
 }
 
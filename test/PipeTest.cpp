@@ -0,0 +1,161 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <vector>
+
+#include <sharpen/PipeChannel.hpp>
+#include <sharpen/PosixInputPipeChannel.hpp>
+#include <sharpen/PosixOutputPipeChannel.hpp>
+#include <sharpen/EventEngine.hpp>
+#include <sharpen/AsyncOps.hpp>
+
+void ReadFull(sharpen::InputPipeChannelPtr channel,char *buf,sharpen::Size size)
+{
+    sharpen::Size offset{0};
+    while (offset != size)
+    {
+        sharpen::Size sz{channel->ReadAsync(buf + offset,size - offset)};
+        assert(sz != 0);
+        offset += sz;
+    }
+}
+
+void MakeRegisteredPipe(sharpen::InputPipeChannelPtr &in,sharpen::OutputPipeChannelPtr &out)
+{
+    sharpen::MakePipeChannel(in,out);
+    in->Register(sharpen::EventEngine::GetEngine());
+    out->Register(sharpen::EventEngine::GetEngine());
+}
+
+void PipeSizeTest()
+{
+    std::printf("pipe size test begin\n");
+    sharpen::InputPipeChannelPtr in;
+    sharpen::OutputPipeChannelPtr out;
+    MakeRegisteredPipe(in,out);
+    sharpen::Size size{out->SetPipeSize(1024*1024)};
+    assert(size >= 1024*1024);
+    assert(out->GetPipeSize() == size);
+    assert(in->GetPipeSize() == size);
+    //fits in the pipe without a reader
+    std::vector<char> data(512*1024);
+    for (sharpen::Size i = 0; i != data.size(); ++i)
+    {
+        data[i] = static_cast<char>(i*13);
+    }
+    sharpen::Size sz{out->WriteAsync(data.data(),data.size())};
+    assert(sz == data.size());
+    std::vector<char> buf(data.size());
+    ReadFull(in,buf.data(),buf.size());
+    assert(buf == data);
+    (void)size;
+    (void)sz;
+    std::printf("pipe size test pass\n");
+}
+
+void VmspliceTest()
+{
+    std::printf("vmsplice test begin\n");
+    sharpen::InputPipeChannelPtr in;
+    sharpen::OutputPipeChannelPtr out;
+    MakeRegisteredPipe(in,out);
+    std::vector<char> data(4096*4);
+    for (sharpen::Size i = 0; i != data.size(); ++i)
+    {
+        data[i] = static_cast<char>(i*7);
+    }
+    sharpen::AwaitableFuture<sharpen::Size> future;
+    out->VmspliceAsync(data.data(),data.size(),future);
+    //ordered behind the vmsplice
+    sharpen::AwaitableFuture<sharpen::Size> tailFuture;
+    out->WriteAsync("tail",4,tailFuture);
+    std::vector<char> buf(data.size() + 4);
+    ReadFull(in,buf.data(),buf.size());
+    assert(future.Await() == data.size());
+    assert(tailFuture.Await() == 4);
+    assert(std::memcmp(buf.data(),data.data(),data.size()) == 0);
+    assert(std::memcmp(buf.data() + data.size(),"tail",4) == 0);
+    std::printf("vmsplice test pass\n");
+}
+
+void TeeTest()
+{
+    std::printf("tee test begin\n");
+    sharpen::InputPipeChannelPtr in;
+    sharpen::OutputPipeChannelPtr out;
+    MakeRegisteredPipe(in,out);
+    sharpen::InputPipeChannelPtr copyIn;
+    sharpen::OutputPipeChannelPtr copyOut;
+    MakeRegisteredPipe(copyIn,copyOut);
+    sharpen::AwaitableFuture<sharpen::Size> future;
+    //wait for the writer
+    in->TeeAsync(*copyOut,5,future);
+    out->WriteAsync("hello",5);
+    assert(future.Await() == 5);
+    char buf[5];
+    ReadFull(in,buf,sizeof(buf));
+    assert(std::memcmp(buf,"hello",5) == 0);
+    ReadFull(copyIn,buf,sizeof(buf));
+    assert(std::memcmp(buf,"hello",5) == 0);
+    //the writer is closed
+    out.reset();
+    sharpen::Size sz{in->TeeAsync(*copyOut,5)};
+    assert(sz == 0);
+    (void)sz;
+    std::printf("tee test pass\n");
+}
+
+void TeeFullPipeTest()
+{
+    std::printf("tee full pipe test begin\n");
+    sharpen::InputPipeChannelPtr in;
+    sharpen::OutputPipeChannelPtr out;
+    MakeRegisteredPipe(in,out);
+    sharpen::InputPipeChannelPtr copyIn;
+    sharpen::OutputPipeChannelPtr copyOut;
+    MakeRegisteredPipe(copyIn,copyOut);
+    //fill the destination
+    sharpen::Size size{copyOut->SetPipeSize(4096)};
+    std::vector<char> data(size,'f');
+    sharpen::Size sz{copyOut->WriteAsync(data.data(),data.size())};
+    assert(sz == data.size());
+    out->WriteAsync("hello",5);
+    sharpen::AwaitableFuture<sharpen::Size> future;
+    in->TeeAsync(*copyOut,5,future);
+    //ordered behind the tee
+    char buf[5];
+    sharpen::AwaitableFuture<sharpen::Size> readFuture;
+    in->ReadAsync(buf,sizeof(buf),readFuture);
+    sharpen::Delay(std::chrono::milliseconds(100));
+    assert(future.IsPending());
+    assert(readFuture.IsPending());
+    //drain the destination
+    std::vector<char> drain(data.size());
+    ReadFull(copyIn,drain.data(),drain.size());
+    assert(drain == data);
+    assert(future.Await() == 5);
+    assert(readFuture.Await() == 5);
+    assert(std::memcmp(buf,"hello",5) == 0);
+    ReadFull(copyIn,buf,sizeof(buf));
+    assert(std::memcmp(buf,"hello",5) == 0);
+    (void)sz;
+    std::printf("tee full pipe test pass\n");
+}
+
+int main()
+{
+    sharpen::EventEngine &engine = sharpen::EventEngine::SetupEngine();
+    engine.Startup([]()
+    {
+        std::printf("pipe test begin\n");
+#ifdef SHARPEN_HAS_PIPESPLICE
+        PipeSizeTest();
+        VmspliceTest();
+        TeeTest();
+        TeeFullPipeTest();
+#endif
+        std::printf("pipe test pass\n");
+    });
+    return 0;
+}
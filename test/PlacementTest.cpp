@@ -0,0 +1,208 @@
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <sharpen/PipeChannel.hpp>
+#include <sharpen/EventEngine.hpp>
+#include <sharpen/LoopPlacementPolicy.hpp>
+#include <sharpen/AsyncOps.hpp>
+
+sharpen::Size ChannelCount(sharpen::EventLoop *loop)
+{
+    return loop->GetLoad().channels_;
+}
+
+void LeastLoadedTest()
+{
+    std::printf("least loaded test begin\n");
+    sharpen::EventEngine &engine = sharpen::EventEngine::GetEngine();
+    //only count channels
+    engine.SetPlacementPolicy(sharpen::LoopPlacementPolicyPtr{new sharpen::LeastLoadedPlacementPolicy(1,0,0)});
+    const std::vector<sharpen::EventLoop*> &loops = engine.GetLoops();
+    std::vector<sharpen::InputPipeChannelPtr> ins;
+    std::vector<sharpen::OutputPipeChannelPtr> outs;
+    for (sharpen::Size i = 0; i != loops.size(); ++i)
+    {
+        sharpen::InputPipeChannelPtr in;
+        sharpen::OutputPipeChannelPtr out;
+        sharpen::MakePipeChannel(in,out);
+        in->Register(engine);
+        out->Register(engine);
+        ins.push_back(in);
+        outs.push_back(out);
+    }
+    for (auto begin = loops.begin(),end = loops.end(); begin != end; ++begin)
+    {
+        assert(ChannelCount(*begin) == 2);
+    }
+    //empty a loop
+    sharpen::EventLoop *loop = ins.front()->GetLoop();
+    for (sharpen::Size i = 0; i != ins.size(); ++i)
+    {
+        if (ins[i]->GetLoop() == loop)
+        {
+            ins[i].reset();
+        }
+        if (outs[i]->GetLoop() == loop)
+        {
+            outs[i].reset();
+        }
+    }
+    assert(ChannelCount(loop) == 0);
+    sharpen::InputPipeChannelPtr in;
+    sharpen::OutputPipeChannelPtr out;
+    sharpen::MakePipeChannel(in,out);
+    in->Register(engine);
+    out->Register(engine);
+    assert(in->GetLoop() == loop);
+    assert(out->GetLoop() == loop);
+    assert(ChannelCount(loop) == 2);
+    engine.SetPlacementPolicy(sharpen::LoopPlacementPolicyPtr{new sharpen::LeastLoadedPlacementPolicy()});
+    std::printf("least loaded test pass\n");
+}
+
+void RoundRobinTest()
+{
+    std::printf("round robin test begin\n");
+    sharpen::EventEngine &engine = sharpen::EventEngine::GetEngine();
+    engine.SetPlacementPolicy(sharpen::LoopPlacementPolicyPtr{new sharpen::RoundRobinPlacementPolicy()});
+    const std::vector<sharpen::EventLoop*> &loops = engine.GetLoops();
+    sharpen::EventLoop *first = engine.SelectLoop();
+    sharpen::EventLoop *second = engine.SelectLoop();
+    assert(loops.size() == 1 || first != second);
+    (void)loops;
+    (void)first;
+    (void)second;
+    engine.SetPlacementPolicy(sharpen::LoopPlacementPolicyPtr{new sharpen::LeastLoadedPlacementPolicy()});
+    std::printf("round robin test pass\n");
+}
+
+void BusyRatioTest()
+{
+    std::printf("busy ratio test begin\n");
+    sharpen::EventEngine &engine = sharpen::EventEngine::GetEngine();
+    sharpen::EventLoop *loop = engine.GetLoops().back();
+    for (sharpen::Size i = 0; i != 8; ++i)
+    {
+        loop->RunInLoopSoon([]()
+        {
+            auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+            while (std::chrono::steady_clock::now() < end)
+            {}
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    sharpen::Uint32 ratio{0};
+    for (sharpen::Size i = 0; i != 100 && !ratio; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        ratio = loop->GetLoad().busyRatio_;
+    }
+    assert(ratio != 0);
+    assert(ratio <= 1000);
+    (void)ratio;
+    std::printf("busy ratio test pass\n");
+}
+
+void MigrateTest()
+{
+    std::printf("migrate test begin\n");
+    sharpen::EventEngine &engine = sharpen::EventEngine::GetEngine();
+    const std::vector<sharpen::EventLoop*> &loops = engine.GetLoops();
+    sharpen::EventLoop *source = loops[1];
+    sharpen::EventLoop *target = loops[2];
+    sharpen::InputPipeChannelPtr in;
+    sharpen::OutputPipeChannelPtr out;
+    sharpen::MakePipeChannel(in,out);
+    in->Register(source);
+    out->Register(source);
+    sharpen::Size sourceCount{ChannelCount(source)};
+    sharpen::Size targetCount{ChannelCount(target)};
+    //the pending read moves with the channel
+    char buf[5];
+    sharpen::Future<sharpen::Size> future;
+    sharpen::AwaitableFuture<void> completed;
+    sharpen::EventLoop *completedLoop{nullptr};
+    future.SetCallback([&completed,&completedLoop](sharpen::Future<sharpen::Size> &)
+    {
+        completedLoop = sharpen::EventLoop::GetLocalLoop();
+        completed.Complete();
+    });
+    in->ReadAsync(buf,sizeof(buf),future);
+    in->MigrateAsync(target);
+    assert(in->GetLoop() == target);
+    assert(ChannelCount(source) == sourceCount - 1);
+    assert(ChannelCount(target) == targetCount + 1);
+    out->WriteAsync("hello",5);
+    completed.Await();
+    //completed in the loop owning the channel now
+    assert(completedLoop == target);
+    assert(future.Get() == 5);
+    assert(std::memcmp(buf,"hello",5) == 0);
+    //data written before the migration is not lost
+    out->WriteAsync("world",5);
+    in->MigrateAsync(source);
+    assert(in->GetLoop() == source);
+    sharpen::Size sz{in->ReadAsync(buf,sizeof(buf))};
+    assert(sz == 5);
+    assert(std::memcmp(buf,"world",5) == 0);
+    (void)sourceCount;
+    (void)targetCount;
+    (void)sz;
+    (void)completedLoop;
+    std::printf("migrate test pass\n");
+}
+
+void MigrateClosedTest()
+{
+    std::printf("migrate closed test begin\n");
+    sharpen::EventEngine &engine = sharpen::EventEngine::GetEngine();
+    sharpen::EventLoop *source = engine.GetLoops()[1];
+    sharpen::EventLoop *target = engine.GetLoops()[2];
+    sharpen::InputPipeChannelPtr in;
+    sharpen::OutputPipeChannelPtr out;
+    sharpen::MakePipeChannel(in,out);
+    in->Register(source);
+    sharpen::Size sourceCount{ChannelCount(source)};
+    sharpen::Size targetCount{ChannelCount(target)};
+    in->Close();
+    assert(ChannelCount(source) == sourceCount - 1);
+    //a closed channel is not counted
+    out->Close();
+    out->Register(source);
+    assert(ChannelCount(source) == sourceCount - 1);
+    bool failed{false};
+    try
+    {
+        in->MigrateAsync(target);
+    }
+    catch(const std::logic_error&)
+    {
+        failed = true;
+    }
+    assert(failed);
+    assert(ChannelCount(target) == targetCount);
+    (void)sourceCount;
+    (void)targetCount;
+    (void)failed;
+    std::printf("migrate closed test pass\n");
+}
+
+int main()
+{
+    sharpen::EventEngine &engine = sharpen::EventEngine::SetupEngine(4);
+    engine.Startup([]()
+    {
+        std::printf("placement test begin\n");
+        LeastLoadedTest();
+        RoundRobinTest();
+        BusyRatioTest();
+        MigrateTest();
+        MigrateClosedTest();
+        std::printf("placement test pass\n");
+    });
+    return 0;
+}
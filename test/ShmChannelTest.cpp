@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+
+#include <sharpen/ShmStreamChannel.hpp>
+#include <sharpen/UnixEndPoint.hpp>
+#include <sharpen/TcpAcceptor.hpp>
+#include <sharpen/EventEngine.hpp>
+#include <sharpen/AsyncOps.hpp>
+#include <sharpen/MicroRpcServer.hpp>
+#include <sharpen/MicroRpcClient.hpp>
+
+void ReadFull(sharpen::NetStreamChannelPtr channel,char *buf,sharpen::Size size)
+{
+    sharpen::Size offset{0};
+    while (offset != size)
+    {
+        sharpen::Size sz{channel->ReadAsync(buf + offset,size - offset)};
+        assert(sz != 0);
+        offset += sz;
+    }
+}
+
+void StreamTest()
+{
+    std::printf("stream test begin\n");
+    sharpen::NetStreamChannelPtr first;
+    sharpen::NetStreamChannelPtr second;
+    sharpen::MakeShmStreamChannelPair(1,first,second);
+    first->Register(sharpen::EventEngine::GetEngine());
+    second->Register(sharpen::EventEngine::GetEngine());
+    //much larger than the ring
+    std::vector<char> data(1024*1024);
+    for (sharpen::Size i = 0; i != data.size(); ++i)
+    {
+        data[i] = static_cast<char>(i*7);
+    }
+    sharpen::AwaitableFuture<void> writerFuture;
+    sharpen::Launch([&first,&data,&writerFuture]()
+    {
+        sharpen::Size offset{0};
+        while (offset != data.size())
+        {
+            //odd sizes wrap around the ring
+            sharpen::Size size{std::min<sharpen::Size>(3001,data.size() - offset)};
+            sharpen::Size sz{first->WriteAsync(data.data() + offset,size)};
+            assert(sz == size);
+            offset += sz;
+        }
+        first.reset();
+        writerFuture.Complete();
+    });
+    std::vector<char> buf(data.size());
+    ReadFull(second,buf.data(),buf.size());
+    assert(buf == data);
+    writerFuture.Await();
+    //the writer is closed
+    char c;
+    sharpen::Size sz{second->ReadAsync(&c,1)};
+    assert(sz == 0);
+    (void)sz;
+    std::printf("stream test pass\n");
+}
+
+void ClosedPeerTest()
+{
+    std::printf("closed peer test begin\n");
+    sharpen::NetStreamChannelPtr first;
+    sharpen::NetStreamChannelPtr second;
+    sharpen::MakeShmStreamChannelPair(4096,first,second);
+    first->Register(sharpen::EventEngine::GetEngine());
+    second->Register(sharpen::EventEngine::GetEngine());
+    second.reset();
+    bool failed{false};
+    try
+    {
+        first->WriteAsync("hello",5);
+    }
+    catch(const std::system_error &e)
+    {
+        failed = e.code().value() == EPIPE;
+    }
+    assert(failed);
+    (void)failed;
+    std::printf("closed peer test pass\n");
+}
+
+void HandshakeTest()
+{
+    std::printf("handshake test begin\n");
+    sharpen::UnixEndPoint endpoint;
+    std::string name{"sharpen-shm-test-"};
+    name += std::to_string(::getpid());
+    endpoint.SetAbstractName(name.data(),name.size());
+    sharpen::TcpAcceptor acceptor{sharpen::AddressFamily::Unix,endpoint,sharpen::EventEngine::GetEngine()};
+    sharpen::AwaitableFuture<void> clientFuture;
+    sharpen::Launch([&endpoint,&clientFuture]()
+    {
+        sharpen::NetStreamChannelPtr client = sharpen::MakeUnixStreamChannel();
+        client->Register(sharpen::EventEngine::GetEngine());
+        client->ConnectAsync(endpoint);
+        sharpen::NetStreamChannelPtr channel = sharpen::ConnectShmStreamChannel(*client,64*1024);
+        channel->Register(sharpen::EventEngine::GetEngine());
+        assert(channel->GetHandle() != client->GetHandle());
+        channel->WriteAsync("ping",4);
+        char buf[4];
+        ReadFull(channel,buf,sizeof(buf));
+        assert(std::memcmp(buf,"pong",4) == 0);
+        clientFuture.Complete();
+    });
+    sharpen::NetStreamChannelPtr conn = acceptor.AcceptAsync();
+    conn->Register(sharpen::EventEngine::GetEngine());
+    sharpen::NetStreamChannelPtr channel = sharpen::AcceptShmStreamChannel(*conn);
+    channel->Register(sharpen::EventEngine::GetEngine());
+    char buf[4];
+    ReadFull(channel,buf,sizeof(buf));
+    assert(std::memcmp(buf,"ping",4) == 0);
+    channel->WriteAsync("pong",4);
+    clientFuture.Await();
+    std::printf("handshake test pass\n");
+}
+
+//memfd | event of side 1 | event of side 0
+void SendFakeRing(sharpen::INetStreamChannel &unixChannel,sharpen::Uint64 capacity,sharpen::Size dataSize,sharpen::Uint64 head,bool seal)
+{
+    sharpen::FileHandle handles[3];
+    handles[0] = ::memfd_create("sharpen-shm-test",MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    handles[1] = ::eventfd(0,EFD_NONBLOCK | EFD_CLOEXEC);
+    handles[2] = ::eventfd(0,EFD_NONBLOCK | EFD_CLOEXEC);
+    int r = ::ftruncate(handles[0],static_cast<off_t>(4096 + dataSize));
+    assert(r == 0);
+    sharpen::Uint64 header[2] = {0x53484d52494e4731,capacity};
+    ssize_t sz = ::pwrite(handles[0],header,sizeof(header),0);
+    assert(sz == sizeof(header));
+    //head of the ring written by side 0
+    sz = ::pwrite(handles[0],&head,sizeof(head),128);
+    assert(sz == sizeof(head));
+    if (seal)
+    {
+        r = ::fcntl(handles[0],F_ADD_SEALS,F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+        assert(r == 0);
+    }
+    unixChannel.SendHandlesAsync(handles,3);
+    for (sharpen::Size i = 0; i != 3; ++i)
+    {
+        ::close(handles[i]);
+    }
+    (void)r;
+    (void)sz;
+}
+
+void BrokenRingTest()
+{
+    std::printf("broken ring test begin\n");
+    sharpen::UnixEndPoint endpoint;
+    std::string name{"sharpen-shm-broken-test-"};
+    name += std::to_string(::getpid());
+    endpoint.SetAbstractName(name.data(),name.size());
+    sharpen::TcpAcceptor acceptor{sharpen::AddressFamily::Unix,endpoint,sharpen::EventEngine::GetEngine()};
+    sharpen::AwaitableFuture<void> clientFuture;
+    sharpen::Launch([&endpoint,&clientFuture]()
+    {
+        sharpen::NetStreamChannelPtr client = sharpen::MakeUnixStreamChannel();
+        client->Register(sharpen::EventEngine::GetEngine());
+        client->ConnectAsync(endpoint);
+        //could be resized by the peer
+        SendFakeRing(*client,4096,8192,0,false);
+        //not a power of two
+        SendFakeRing(*client,6000,12000,0,true);
+        //smaller than the minimum
+        SendFakeRing(*client,1024,2048,0,true);
+        //head is ahead of tail by more than the capacity
+        SendFakeRing(*client,4096,8192,1024*1024,true);
+        char ack;
+        client->ReadAsync(&ack,1);
+        clientFuture.Complete();
+    });
+    sharpen::NetStreamChannelPtr conn = acceptor.AcceptAsync();
+    conn->Register(sharpen::EventEngine::GetEngine());
+    for (sharpen::Size i = 0; i != 3; ++i)
+    {
+        bool failed{false};
+        try
+        {
+            sharpen::AcceptShmStreamChannel(*conn);
+        }
+        catch(const std::invalid_argument&)
+        {
+            failed = true;
+        }
+        assert(failed);
+        (void)failed;
+    }
+    sharpen::NetStreamChannelPtr channel = sharpen::AcceptShmStreamChannel(*conn);
+    channel->Register(sharpen::EventEngine::GetEngine());
+    char buf[16];
+    sharpen::ErrorCode err{0};
+    try
+    {
+        channel->ReadAsync(buf,sizeof(buf));
+    }
+    catch(const std::system_error &e)
+    {
+        err = e.code().value();
+    }
+    assert(err == EPROTO);
+    (void)err;
+    conn->WriteAsync("a",1);
+    clientFuture.Await();
+    std::printf("broken ring test pass\n");
+}
+
+void RpcTest()
+{
+    std::printf("rpc test begin\n");
+    sharpen::UnixEndPoint endpoint;
+    std::string name{"sharpen-shm-rpc-test-"};
+    name += std::to_string(::getpid());
+    endpoint.SetAbstractName(name.data(),name.size());
+    sharpen::MicroRpcServer server{sharpen::AddressFamily::Unix,endpoint,sharpen::EventEngine::GetEngine(),sharpen::MicroRpcServerOption{sharpen::MicroRpcDispatcher{}}};
+    sharpen::Size serverSliced{0};
+    sharpen::Int32 *scratch{nullptr};
+    server.Register("Inc",[&serverSliced,&scratch](sharpen::MicroRpcContext &ctx)
+    {
+        const sharpen::MicroRpcStack &req = ctx.Request();
+        auto ite = req.Begin();
+        ++ite;
+        //shares the receive buffer
+        if (ite->IsSliced())
+        {
+            ++serverSliced;
+        }
+        //the arena is reset before each request
+        sharpen::Int32 *value = ctx.RequestArena().Construct<sharpen::Int32>(*ite->Data<sharpen::Int32>() + 1);
+        assert(value);
+        assert(!scratch || scratch == value);
+        scratch = value;
+        sharpen::MicroRpcStack res;
+        res.Push(*value);
+        ctx.Connection()->WriteAsync(ctx.Encoder().Encode(res));
+    });
+    sharpen::NetStreamChannelPtr first;
+    sharpen::NetStreamChannelPtr second;
+    sharpen::MakeShmStreamChannelPair(4096,first,second);
+    first->Register(sharpen::EventEngine::GetEngine());
+    second->Register(sharpen::EventEngine::GetEngine());
+    server.ServeAsync(second);
+    std::weak_ptr<sharpen::INetStreamChannel> served{second};
+    second.reset();
+    sharpen::Size clientSliced{0};
+    {
+        sharpen::MicroRpcClient client{first};
+        char proc[] = "Inc";
+        //wraps around the ring
+        for (sharpen::Int32 i = 0; i != 1000; ++i)
+        {
+            sharpen::MicroRpcStack req;
+            req.Push(i);
+            req.Push(proc,proc + sizeof(proc) - 1);
+            sharpen::MicroRpcStack res = client.InvokeAsync(req);
+            assert(*res.Top().Data<sharpen::Int32>() == i + 1);
+            if (res.Top().IsSliced())
+            {
+                ++clientSliced;
+            }
+        }
+    }
+    //the server returns at the end of stream
+    first.reset();
+    while (!served.expired())
+    {
+        sharpen::Delay(std::chrono::milliseconds(1));
+    }
+    assert(serverSliced != 0);
+    assert(clientSliced != 0);
+    std::printf("rpc test pass\n");
+}
+
+int main()
+{
+    sharpen::StartupNetSupport();
+    sharpen::EventEngine &engine = sharpen::EventEngine::SetupEngine();
+    engine.Startup([]()
+    {
+        std::printf("shm channel test begin\n");
+        StreamTest();
+        ClosedPeerTest();
+        HandshakeTest();
+        BrokenRingTest();
+        RpcTest();
+        std::printf("shm channel test pass\n");
+        sharpen::CleanupNetSupport();
+    });
+    return 0;
+}